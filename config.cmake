@@ -21,11 +21,15 @@ set(lib_sources
     Particles/ParticleBCList.cmpl.C
     Partition/UniformMapper.cmpl.C
     Pooma/Pooma.cmpl.C
+    Threads/IterateSchedulers/DataflowTrace.cmpl.C
     Threads/IterateSchedulers/SerialAsync.cmpl.C
+    Threads/IterateSchedulers/WorkStealing.cmpl.C
     Tulip/Messaging.cmpl.C
     Tulip/PatchSizeSyncer.cmpl.C
     Utilities/Benchmark.cmpl.C
+    Utilities/BlockAllocator.cmpl.C
     Utilities/Inform.cmpl.C
+    Utilities/MappedFile.cmpl.C
     Utilities/Options.cmpl.C
     Utilities/PAssert.cmpl.C
     Utilities/Pool.cmpl.C
@@ -42,3 +46,18 @@ endforeach()
 
 qa_make_library(${qa_work_path}/libpooma-gcc.a ${real_lib_sources})
 
+# workstealing_test1 runs on a library built with the work-stealing
+# scheduler, which is chosen when POOMA is compiled.  Each source is
+# compiled through a wrapper that selects the scheduler.
+
+set(ws_lib_sources )
+foreach(src ${lib_sources})
+    string(REPLACE "/" "_" ws_src ${src})
+    set(ws_src ${qa_work_path}/workstealing/${ws_src})
+    file(WRITE ${ws_src}
+         "#define POOMA_SMARTS_SCHEDULER_WORKSTEALING 1\n"
+         "#include \"${test_suite_path}/lib/${src}\"\n")
+    set(ws_lib_sources ${ws_lib_sources} ${ws_src})
+endforeach()
+
+qa_make_library(${qa_work_path}/libpooma-gcc-workstealing.a ${ws_lib_sources})
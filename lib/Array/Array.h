@@ -88,6 +88,8 @@ struct View1Implementation;
 #include "Functions/Reductions.h"
 
 #include <iosfwd>
+#include <type_traits>
+#include <utility>
 
 //-----------------------------------------------------------------------------
 // Prototypes for the assign function used to assign an expression to an Array.
@@ -1401,6 +1403,14 @@ public:
   inline Array(const This_t &model)
   : engine_m(model.engine())
     { }
+
+  /// The move constructor takes the engine over from the model.  There
+  /// is no move assignment, as assignment copies the elements.
+
+  inline Array(This_t &&model)
+    noexcept(std::is_nothrow_move_constructible<Engine_t>::value)
+  : engine_m(std::move(model.engine_m))
+    { }
   
   /// This ctor is called, for example, to initialize a brick-view with a
   /// compressible brick.
@@ -2521,6 +2531,17 @@ uncompress(Array<Dim, T, EngineTag> &a)
   uncompress(a.engine());
 }
 
+/// Write an array with memory-mapped storage back to its files, once the
+/// pending expressions writing to it are done.
+
+template<int Dim, class T, class EngineTag>
+inline void
+flush(const Array<Dim, T, EngineTag> &a)
+{
+  Pooma::blockAndEvaluate();
+  flush(a.engine());
+}
+
 /**
  * Traits class telling RefCountedBlockPointer that this class has
  * shallow semantics and a makeOwnCopy method.
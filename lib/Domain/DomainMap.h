@@ -46,8 +46,10 @@
 #include "Domain/Touches.h"
 #include "Utilities/Pooled.h"
 #include "Utilities/PAssert.h"
+#include <algorithm>
 #include <utility>
 #include <list>
+#include <vector>
 #include <iosfwd>
 
 
@@ -195,6 +197,90 @@ public:
     return p;
   }
 
+  // Build the tree below this node for the values in [begin,end), all
+  // of which must be contained in this node's domain.  Rather than
+  // splitting the domain in half, the values are sorted by the center of
+  // their domains along the direction in which the centers are most
+  // spread out, and cut into two halves of equal size; each half goes to
+  // a new leaf whose domain is the bounding box of the half.  This is
+  // repeated until a node has at most leafSize values, so the tree has
+  // log(N) levels however the domains are distributed.  Later insert()
+  // calls still work, since each leaf can be split as before.
+
+  enum { leafSize = 4 };
+
+  typedef typename std::vector<Value_t>::iterator BulkIter_t;
+
+  void insert(BulkIter_t begin, BulkIter_t end) {
+    int n = end - begin;
+    PAssert(left_m == 0);
+
+    if (n <= leafSize)
+      {
+	list_m.insert(list_m.end(), begin, end);
+	return;
+      }
+
+    // Find the direction in which the centers are the most spread out.
+    // Twice the center is used to stay with integers.
+
+    int axis = 0, spread = 0;
+    for (int d = 0; d < DomainTraits<Dom>::dimensions; ++d)
+      {
+	int lo = center(begin->first, d), hi = lo;
+	for (BulkIter_t v = begin + 1; v != end; ++v)
+	  {
+	    int c = center(v->first, d);
+	    lo = std::min(lo, c);
+	    hi = std::max(hi, c);
+	  }
+	if (hi - lo > spread)
+	  {
+	    axis = d;
+	    spread = hi - lo;
+	  }
+      }
+
+    // If all the domains have the same center, they stay in this node.
+
+    if (spread == 0)
+      {
+	list_m.insert(list_m.end(), begin, end);
+	return;
+      }
+
+    BulkIter_t mid = begin + n / 2;
+    std::nth_element(begin, mid, end, CenterLess(axis));
+
+    left_m  = new Node_t(boundingBox(begin, mid), this);
+    right_m = new Node_t(boundingBox(mid, end), this);
+    left_m->insert(begin, mid);
+    right_m->insert(mid, end);
+  }
+
+  // Return the bounding box of the domains of the values in [begin,end).
+
+  static Domain_t boundingBox(BulkIter_t begin, BulkIter_t end) {
+    PAssert(begin != end);
+    Domain_t box(begin->first);
+    for (BulkIter_t v = begin + 1; v != end; ++v)
+      for (int d = 0; d < DomainTraits<Dom>::dimensions; ++d)
+	{
+	  typename DomainTraits<Dom>::OneDomain_t &b =
+	    DomainTraits<Dom>::getDomain(box, d);
+	  const typename DomainTraits<Dom>::OneDomain_t &a =
+	    DomainTraits<Dom>::getDomain(v->first, d);
+	  b = typename DomainTraits<Dom>::OneDomain_t(
+	        std::min(a.first(), b.first()), std::max(a.last(), b.last()));
+	}
+    return box;
+  }
+
+  // Return the left and right leaves, or 0 if there are none.
+
+  Node_t *left() const { return left_m; }
+  Node_t *right() const { return right_m; }
+
   // Get the leftmost non-empty node which touches the given domain
 
   Node_t *findLeftTouchNode(const Domain_t &d) {
@@ -205,6 +291,21 @@ public:
   }
 
 private:
+  // Twice the center of a domain in the given direction.
+  static int center(const Domain_t &d, int axis) {
+    const typename DomainTraits<Dom>::OneDomain_t &a =
+      DomainTraits<Dom>::getDomain(d, axis);
+    return a.first() + a.last();
+  }
+
+  struct CenterLess {
+    CenterLess(int axis) : axis_m(axis) { }
+    bool operator()(const Value_t &a, const Value_t &b) const {
+      return center(a.first, axis_m) < center(b.first, axis_m);
+    }
+    int axis_m;
+  };
+
   // This node's domain
   Domain_t domain_m;
 
@@ -527,6 +628,18 @@ private:
  * a begin/end pair which can be used to iterate through all subdomains which
  * touch the domain given to the 'touch' method.  touch_iterator has
  * forward-iterator semantics, and dereferencing returns a Value_t pair.
+ *
+ * When all the subdomains are known at once, as for the patches of a
+ * layout, they should be given to insert(begin, end) instead.  This
+ * bulk-loads the tree, splitting the set of subdomains in half at each
+ * level instead of the bounding box, which builds a balanced tree in
+ * O(N log(N)) time however sparse the subdomains are, and calls update().
+ * Many touch operations can likewise be done in one pass over the tree
+ * with touch(domains, out), which writes a pair (index of the domain,
+ * Value_t) for each subdomain touching each of the given domains:
+ *   std::vector<Interval<2> > queries;
+ *   std::vector<DMap_t::BatchValue_t> found;
+ *   dmap.touch(queries, std::back_inserter(found));
  */
 
 template<class Dom, class T>
@@ -548,6 +661,7 @@ public:
   typedef DomainMapTouchIterator<Domain_t,Data_t>  touch_iterator;
   typedef std::pair<touch_iterator,touch_iterator> Touch_t;
   typedef std::pair<touch_iterator,touch_iterator> touch_type;
+  typedef std::pair<int,Value_t>                   BatchValue_t;
   typedef long                                     Size_t;
   typedef long                                     size_type;
 
@@ -623,6 +737,26 @@ public:
     return Touch_t(touch_iterator(), touch_iterator());
   }
 
+  // Do the touch operation for each of the given domains in one pass
+  // over the tree, writing a BatchValue_t pair (index of the domain,
+  // touching element) to the output iterator for every touching element.
+  // The elements touching each domain come in the order touch() gives
+  // them in.  Returns the number of pairs written.
+
+  template<class OutIter>
+  int touch(const std::vector<Domain_t> &domains, OutIter o) const {
+    int count = 0;
+    if (root_m != 0 && domains.size() > 0)
+      {
+	int size = domains.size();
+	std::vector<int> all(size);
+	for (int i = 0; i < size; ++i)
+	  all[i] = i;
+	touch(root_m, domains, all, o, count);
+      }
+    return count;
+  }
+
   //============================================================
   // Modifiers
   //============================================================
@@ -636,6 +770,31 @@ public:
     size_m++;
   }
 
+  // insert the elements in [begin,end).  If the DomainMap is empty, the
+  // tree is bulk-loaded, which gives a balanced tree; otherwise the
+  // elements are inserted one at a time.  Either way this calls update().
+
+  template<class Iter>
+  void insert(Iter begin, Iter end) {
+    PAssert(root_m != 0);
+    if (size_m > 0 || root_m->left() != 0)
+      {
+	for ( ; begin != end; ++begin)
+	  insert(*begin);
+	update();
+	return;
+      }
+
+    std::vector<Value_t> values;
+    for ( ; begin != end; ++begin, ++size_m)
+      {
+	PAssert(contains(root_m->domain(), (*begin).first));
+	values.push_back(*begin);
+      }
+    root_m->insert(values.begin(), values.end());
+    update();
+  }
+
   // update this DomainMap's leftmost-element pointer.  If this is not
   // done between when a domain is inserted and when a touch() operation
   // is performed, the results can be inaccurate.  This could be done
@@ -724,6 +883,36 @@ private:
   typedef DomainMapNode<Domain_t,Data_t> Node_t;
   typedef typename Node_t::iterator      NodeIter_t;
 
+  // The batched touch operation for the subtree below p.  which holds
+  // the indices of the domains that touch p's parent.
+
+  template<class OutIter>
+  void touch(Node_t *p, const std::vector<Domain_t> &domains,
+	     const std::vector<int> &which, OutIter &o, int &count) const {
+    std::vector<int> here;
+    int size = which.size();
+    for (int i = 0; i < size; ++i)
+      if (touches(domains[which[i]], p->domain()))
+	here.push_back(which[i]);
+    if (here.size() == 0)
+      return;
+
+    size = here.size();
+
+    if (p->left() != 0)
+      touch(p->left(), domains, here, o, count);
+    for (NodeIter_t a = p->begin(); a != p->end(); ++a)
+      for (int i = 0; i < size; ++i)
+	if (touches(domains[here[i]], (*a).first))
+	  {
+	    *o = BatchValue_t(here[i], *a);
+	    ++o;
+	    ++count;
+	  }
+    if (p->right() != 0)
+      touch(p->right(), domains, here, o, count);
+  }
+
   // The number of elements in our list
   Size_t size_m;
 
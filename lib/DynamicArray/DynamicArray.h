@@ -333,6 +333,15 @@ public:
     CTAssert(dynamic == true);
   }
 
+  /// The move constructor takes the engine over from the model.
+
+  DynamicArray(This_t &&model)
+    noexcept(std::is_nothrow_move_constructible<Base_t>::value)
+    : Array<1, T, EngineTag>(static_cast<Base_t &&>(model))
+  {
+    CTAssert(dynamic == true);
+  }
+
   template<class OtherT, class OtherEngineTag, class OtherDomain>
   DynamicArray(const DynamicArray<OtherT, OtherEngineTag> &model, 
 	       const OtherDomain &domain)
@@ -42,32 +42,36 @@
 // multidimensional domain given by either a Domain_t object, a
 // Node object, or a Layout_t object. These constructors allocate
 // memory for the elements, and initialize the memory with
-// ElementProperties::construct. 
+// ElementProperties::construct, in parallel if Pooma::firstTouch()
+// is on.
 //
 //-----------------------------------------------------------------------------
 
 template <int Dim, class T>
 Engine<Dim,T,Brick>::Engine(const Domain_t &dom)
-  : Base_t(dom), dataBlock_m(dom.size()), data_m(dataBlock_m.currentPointer())
+  : Base_t(dom), dataBlock_m(dom.size(), firstTouchTag(dom)),
+    data_m(dataBlock_m.currentPointer())
 { }
 
 template <int Dim, class T>
 Engine<Dim,T,Brick>::Engine(const Node<Domain_t> &node)
   : Base_t(node),
     dataBlock_m(node.allocated().size(), node.affinity(), 
-           typename DataBlockPtr<T>::WithAffinity_t()),
+           typename DataBlockPtr<T>::WithAffinity_t(),
+           firstTouchTag(node.allocated())),
     data_m(dataBlock_m.currentPointer())
 { }
 
 template <int Dim, class T>
 Engine<Dim,T,Brick>::Engine(const Layout_t &layout)
-  : Base_t(layout), dataBlock_m(layout.domain().size()),
+  : Base_t(layout),
+    dataBlock_m(layout.domain().size(), firstTouchTag(layout.domain())),
     data_m(dataBlock_m.currentPointer())
 { }
 
 template <int Dim, class T>
 Engine<Dim,T,Brick>::Engine(const Domain_t &dom, const T& model)
-  : Base_t(dom), dataBlock_m(dom.size(), model),
+  : Base_t(dom), dataBlock_m(dom.size(), model, firstTouchTag(dom)),
     data_m(dataBlock_m.currentPointer())
 { }
 
@@ -87,6 +91,25 @@ Engine<Dim,T,Brick>::Engine(T * foreignData, const Domain_t &dom)
     data_m(dataBlock_m.currentPointer())
 { }
 
+//-----------------------------------------------------------------------------
+//
+// Engine<Dim,T,Brick>(const DataBlockPtr<T> &, const Interval<Dim> &domain)
+//
+// Constructs a Brick-Engine holding type T elements with the
+// multidimensional domain given by Interval<Dim>, sharing the data
+// block from its current position.
+//
+//-----------------------------------------------------------------------------
+
+template <int Dim, class T>
+Engine<Dim,T,Brick>::Engine(const DataBlockPtr<T> &dataBlock,
+			    const Domain_t &dom)
+  : Base_t(dom), dataBlock_m(dataBlock),
+    data_m(dataBlock_m.currentPointer())
+{
+  PAssert(dataBlock_m.offset() + dom.size() <= long(dataBlock_m.size()));
+}
+
 //-----------------------------------------------------------------------------
 //
 // Engine<Dim,T,Brick>(const Engine<Dim,T,Brick> &)
@@ -101,6 +124,14 @@ Engine<Dim,T,Brick>::Engine(const This_t &modelEngine)
     data_m(modelEngine.data_m)
 { }
 
+template <int Dim, class T>
+Engine<Dim,T,Brick>::Engine(This_t &&modelEngine) noexcept
+  : Base_t(modelEngine), dataBlock_m(std::move(modelEngine.dataBlock_m)),
+    data_m(modelEngine.data_m)
+{
+  modelEngine.data_m = 0;
+}
+
 //-----------------------------------------------------------------------------
 //
 // Engine<Dim,T,Brick> & operator=(const Engine<Dim,T,Brick> &)
@@ -121,7 +152,18 @@ Engine<Dim,T,Brick> & Engine<Dim,T,Brick>::operator=(const This_t &modelEngine)
   Base_t::operator=(modelEngine);
   dataBlock_m = modelEngine.dataBlock_m;
   data_m = modelEngine.data_m;
-  PAssert(dataBlock_m.isAtBeginning());
+  return *this;
+}
+
+template <int Dim, class T>
+Engine<Dim,T,Brick> & Engine<Dim,T,Brick>::operator=(This_t &&modelEngine)
+{
+  if (this == &modelEngine) return *this;
+
+  Base_t::operator=(modelEngine);
+  dataBlock_m = std::move(modelEngine.dataBlock_m);
+  data_m = modelEngine.data_m;
+  modelEngine.data_m = 0;
   return *this;
 }
 
@@ -130,7 +172,8 @@ Engine<Dim,T,Brick> & Engine<Dim,T,Brick>::operator=(const This_t &modelEngine)
 // Engine<Dim,T,Brick> & makeOwnCopy()
 //
 // Causes the Brick-Engine to obtain a private copy of the data
-// that it refers to.
+// that it refers to.  The whole block is copied, so a Brick that
+// does not start at the beginning of its block keeps its offset.
 //
 //-----------------------------------------------------------------------------
 
@@ -139,7 +182,6 @@ Engine<Dim,T,Brick> &Engine<Dim,T,Brick>::makeOwnCopy()
 {
   if (dataBlock_m.isValid() && dataBlock_m.count() > 1) 
     {
-      PAssert(dataBlock_m.isAtBeginning());
       dataBlock_m.makeOwnCopy();
       data_m = dataBlock_m.currentPointer();
     }
@@ -177,6 +219,15 @@ Engine(const This_t &modelEngine)
   : Base_t(modelEngine), dataBlock_m(modelEngine.dataBlock_m), data_m(dataBlock_m.currentPointer())
 { }
 
+template <int Dim, class T>
+Engine<Dim,T,BrickView>::
+Engine(This_t &&modelEngine) noexcept
+  : Base_t(modelEngine), dataBlock_m(std::move(modelEngine.dataBlock_m)),
+    data_m(modelEngine.data_m)
+{
+  modelEngine.data_m = 0;
+}
+
 // What is this for again???
 
 template <int Dim, class T>
@@ -204,6 +255,18 @@ Engine<Dim,T,BrickView>::operator=(const This_t &modelEngine)
   return *this;
 }
 
+template <int Dim, class T>
+Engine<Dim,T,BrickView> &
+Engine<Dim,T,BrickView>::operator=(This_t &&modelEngine)
+{
+  if (this == &modelEngine) return *this;
+  Base_t::operator=(modelEngine);
+  dataBlock_m = std::move(modelEngine.dataBlock_m);
+  data_m = modelEngine.data_m;
+  modelEngine.data_m = 0;
+  return *this;
+}
+
 //-----------------------------------------------------------------------------
 //
 // Engine(const Engine<Dim,T,BrickView<Dim2> > &);
@@ -92,6 +92,9 @@ struct BrickView {};
 template <int Dim, class T>
 class Engine<Dim,T,BrickView>;
 
+struct ComponentBrick;
+struct ComponentBrickView;
+
 /**
  * Engine<Dim,T,Brick>  (aka Brick-Engine)
  *
@@ -175,12 +178,35 @@ public:
   /// data.
 
   Engine(T * foreignData, const Domain_t &domain);
+
+  /// This constructor takes a domain and a data block holding at least
+  /// domain.size() elements from its current position, and constructs a
+  /// Brick-Engine sharing the block.  The data need not start at the
+  /// beginning of the block; the components of a ComponentBrick-Engine
+  /// are Bricks made this way.
+
+  Engine(const DataBlockPtr<T> &dataBlock, const Domain_t &domain);
+
+  /// Build the Brick-Engine holding some components of the elements of
+  /// a ComponentBrick-Engine.  Used for component views.
+
+  template <class T2, class Components>
+  Engine(const Engine<Dim,T2,ComponentBrick> &model, const Components &c)
+    : Base_t(model.component(c).domain()),
+      dataBlock_m(model.component(c).dataBlock()),
+      data_m(dataBlock_m.currentPointer())
+  { }
   
   /// Copy constructor performs a SHALLOW copy.
   /// But NOTE: the layouts will NOT be shared.
 
   Engine(const Engine_t &model);
 
+  /// Move constructor takes the data block over from the model without
+  /// touching its reference count.  The model is left without data.
+
+  Engine(Engine_t &&model) noexcept;
+
   // Subsetting Constructors.
   //   There are none - you cannot create a Brick-Engine by taking
   //   a "view" of another Engine.  Brick-Engines, by definition,
@@ -202,6 +228,8 @@ public:
 
   Engine_t &operator=(const Engine_t &model);
 
+  Engine_t &operator=(Engine_t &&model);
+
   //============================================================
   // Accessor and Mutator functions:
   //============================================================
@@ -327,6 +355,20 @@ public:
 
 private:
 
+  /// Return the tag new storage on the domain is initialized with.  When
+  /// Pooma::firstTouch() is on, the chunks are the elements of one
+  /// iteration of the outermost loop the InlineEvaluator runs over the
+  /// domain, so the storage is first touched by the threads that will
+  /// evaluate on it.  Otherwise it is initialized serially.
+
+  static FirstTouchTag firstTouchTag(const Domain_t &domain)
+  {
+    int n = domain[Dim-1].length();
+    if (!Pooma::firstTouch_g || n == 0)
+      return FirstTouchTag(0);
+    return FirstTouchTag(domain.size() / n);
+  }
+
   //============================================================
   // Private data
   //============================================================
@@ -403,13 +445,19 @@ public:
   Engine(const Engine_t &);
   Engine(const Engine_t &, const EngineConstructTag &);
 
+  // Move constructor takes the data block over from the model.
+
+  Engine(Engine_t &&) noexcept;
+
   // Subsetting Constructors.
   // A BrickView-Engine is a strided, brick-shaped view of a
   // Brick-Engine. Thus we write constructors to build BrickViews from
   // Brick-Engines and all types of brick-shaped Domains.
 
   // Build a BrickView from Brick and a domain like an Interval<Dim> 
-  // or Range<Dim>.
+  // or Range<Dim>.  The offsets are taken from the current position
+  // of the block of the Brick, which is not at its beginning for the
+  // components of a ComponentBrick.
 
   // Why is this templated on ETag???
   
@@ -417,10 +465,7 @@ public:
   Engine(const Engine<Dim,T,ETag> &e, const Domain<Dim, DT> &dom)
   : Base_t(e, dom.unwrap()), dataBlock_m(e.dataBlock(), e.offset(dom.unwrap())),
     data_m(dataBlock_m.currentPointer())
-  { 
-    // The engine's data pointer should be at the beginning.
-    PAssert(e.dataBlock().isAtBeginning());
-  }
+  { }
 
   // Build a BrickView from Brick and a SliceRange<Dim2,Dim>.
 
@@ -428,19 +473,13 @@ public:
   Engine(const Engine<Dim2,T,Brick> &e, const SliceRange<Dim2,Dim> &dom)
     : Base_t(e, dom), dataBlock_m(e.dataBlock(), e.offset(dom.totalDomain())),
     data_m(dataBlock_m.currentPointer())
-  {    
-    // The engine's data pointer should be at the beginning.
-    PAssert(e.dataBlock().isAtBeginning());
-  }
+  { }
   
   template<int Dim2>
   Engine(const Engine<Dim2,T,Brick> &e, const SliceInterval<Dim2,Dim> &dom)
     : Base_t(e, dom), dataBlock_m(e.dataBlock(), e.offset(dom.totalDomain())),
     data_m(dataBlock_m.currentPointer())
-  {    
-    // The engine's data pointer should be at the beginning.
-    PAssert(e.dataBlock().isAtBeginning());
-  }
+  { }
   
   // what is this #if???
 #if 0
@@ -448,20 +487,14 @@ public:
   Engine(const Engine<ODim,T,ETag> &e, const SliceRange<ODim,Dim> &dom)
     : Base_t(e, dom), dataBlock_m(e.dataBlock(), e.offset(dom.totalDomain())),
     data_m(dataBlock_m.currentPointer())
-  {    
-    // The engine's data pointer should be at the beginning.
-    PAssert(e.dataBlock().isAtBeginning());
-  }
+  { }
   // Build a BrickView from Brick and a SliceInterval<Dim2,Dim>.
 
   template <int ODim, class ETag>
   Engine(const Engine<ODim,T,ETag> &e, const SliceInterval<ODim,Dim> &dom)
     : Base_t(e, dom), dataBlock_m(e.dataBlock(), e.offset(dom.totalDomain())),
     data_m(dataBlock_m.currentPointer())
-  {    
-    // The engine's data pointer should be at the beginning.
-    PAssert(e.dataBlock().isAtBeginning());
-  }
+  { }
 #endif
 
 
@@ -499,6 +532,15 @@ public:
     data_m(dataBlock_m.currentPointer())
   { }
 
+  // Build the BrickView holding some components of the elements of a
+  // ComponentBrickView.  Used for component views.
+
+  template <class T2, class Components>
+  Engine(const Engine<Dim,T2,ComponentBrickView> &model, const Components &c)
+    : Base_t(model.component(c)), dataBlock_m(model.component(c).dataBlock()),
+    data_m(dataBlock_m.currentPointer())
+  { }
+
   // Build a BrickView-Engine from a compressible brick.
   
   explicit Engine(const Engine<Dim,T,CompressibleBrick> &);
@@ -518,6 +560,8 @@ public:
 
   Engine_t &operator=(const Engine_t &model);
 
+  Engine_t &operator=(Engine_t &&model);
+
   //============================================================
   // Accessor functions:
   //============================================================
@@ -0,0 +1,555 @@
+// -*- C++ -*-
+//
+// Copyright (C) 1998, 1999, 2000, 2002  Los Alamos National Laboratory,
+// Copyright (C) 1998, 1999, 2000, 2002  CodeSourcery, LLC
+//
+// This file is part of FreePOOMA.
+//
+// FreePOOMA is free software; you can redistribute it and/or modify it
+// under the terms of the Expat license.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the Expat
+// license for more details.
+//
+// You should have received a copy of the Expat license along with
+// FreePOOMA; see the file LICENSE.
+//
+
+//-----------------------------------------------------------------------------
+// Classes:
+//   CachedIndexFunction   - Tag class for defining a cached
+//                           index-function-engine.
+//   IndexFunctionCache    - The values of the function computed so far.
+//   Engine                - Specialization for CachedIndexFunction
+//   NewEngine             - Specializations for CachedIndexFunction
+//   NewEngineEngine       - Specializations for CachedIndexFunction
+//   NewEngineDomain       - Specializations for CachedIndexFunction
+//-----------------------------------------------------------------------------
+
+#ifndef POOMA_ENGINE_CACHEDINDEXFUNCTION_H
+#define POOMA_ENGINE_CACHEDINDEXFUNCTION_H
+
+/** @file
+ * @ingroup Engine
+ * @brief
+ * Cached index-function-engine objects make a function of indices work
+ * like an array, like index-function-engines do, but compute each value
+ * only once and keep it in a Brick.
+ */
+
+//-----------------------------------------------------------------------------
+// Includes:
+//-----------------------------------------------------------------------------
+
+#include "Domain/Interval.h"
+#include "Domain/Range.h"
+#include "Domain/SliceInterval.h"
+#include "Domain/SliceRange.h"
+#include "Domain/Touches.h"
+#include "Engine/BrickEngine.h"
+#include "Engine/Engine.h"
+#include "Engine/IndexFunctionEngine.h"
+#include "Evaluator/InlineEvaluator.h"
+#include "Layout/INode.h"
+#include "Layout/Node.h"
+#include "Layout/DomainLayout.h"
+#include "PETE/PETE.h"
+#include "Threads/PoomaMutex.h"
+#include "Utilities/PAssert.h"
+#include "Utilities/RefCounted.h"
+#include "Utilities/RefCountedPtr.h"
+#include <atomic>
+#include <vector>
+
+
+/**
+ * CachedIndexFunction is the tag class for the cached
+ * index-function-engine.  Like IndexFunction, it takes the Functor that
+ * turns indices into function values as a template argument.
+ */
+
+template<class Functor>
+struct CachedIndexFunction
+{ };
+
+
+namespace Pooma {
+
+/**
+ * IndexFunctionCache<Dim, T, Functor> holds the values of a function
+ * of indices that have been computed so far, in a Brick on the whole
+ * domain of the engine.  The domain is divided into patches, the patches
+ * of the layout the engine was made with, and the values are computed a
+ * patch at a time, the first time anything in the patch is read.
+ *
+ * The cache is shared by copies of an engine.  Computing values is
+ * serialized by a mutex; once every patch has been computed, reads do
+ * not lock.
+ */
+
+template<int Dim, class T, class Functor>
+class IndexFunctionCache : public RefCounted
+{
+public:
+
+  typedef Interval<Dim>                            Domain_t;
+  typedef Engine<Dim, T, Brick>                    Brick_t;
+
+  /// Make a cache with one patch for the domain.
+
+  explicit IndexFunctionCache(const Domain_t &domain)
+    : domain_m(domain), valid_m(1, false), nvalid_m(0), complete_m(false)
+  {
+    patches_m.push_back(domain);
+  }
+
+  /// Make a cache with the patches of the layout.  The patches are the
+  /// owned domains of the layout's nodes, grown to include the external
+  /// guards next to them.
+
+  template<class Layout>
+  explicit IndexFunctionCache(const Layout &layout)
+    : domain_m(layout.domain()), nvalid_m(0), complete_m(false)
+  {
+    typename Layout::const_iterator p = layout.beginGlobal();
+    for (; p != layout.endGlobal(); ++p)
+      {
+	Domain_t patch = p->domain();
+	for (int d = 0; d < Dim; ++d)
+	  {
+	    int first = patch[d].first(), last = patch[d].last();
+	    if (first == layout.innerDomain()[d].first())
+	      first = domain_m[d].first();
+	    if (last == layout.innerDomain()[d].last())
+	      last = domain_m[d].last();
+	    patch[d] = Interval<1>(first, last);
+	  }
+	patches_m.push_back(patch);
+      }
+    valid_m.resize(patches_m.size(), false);
+  }
+
+  /// Make an empty cache with the same patches as the model.
+
+  IndexFunctionCache(const IndexFunctionCache<Dim, T, Functor> &model)
+    : RefCounted(), domain_m(model.domain_m), patches_m(model.patches_m),
+      valid_m(model.patches_m.size(), false), nvalid_m(0), complete_m(false)
+  { }
+
+  /// Return the domain.
+
+  const Domain_t &domain() const { return domain_m; }
+
+  /// Return the number of patches, and the number that have been
+  /// computed.
+
+  int patches() const { return patches_m.size(); }
+  int validPatches() const { return nvalid_m; }
+
+  /// Return whether every patch has been computed.
+
+  bool complete() const { return complete_m.load(std::memory_order_acquire); }
+
+  /// Compute the values of the patches that touch the domain and have
+  /// not been computed yet, and return the Brick with them.
+
+  const Brick_t &fill(const Domain_t &dom, const Functor &f)
+  {
+    // Reads of the whole engine get here from the loops of evaluators,
+    // which may be OpenMP loops even when the mutex is a dummy.
+
+    if (!complete())
+      {
+#pragma omp critical (PoomaIndexFunctionCache)
+	{
+	  mutex_m.lock();
+	  for (int i = 0; i < patches(); ++i)
+	    if (!valid_m[i] && touches(patches_m[i], dom))
+	      compute(i, f);
+	  mutex_m.unlock();
+	}
+      }
+    return brick_m;
+  }
+
+  /// Return the Brick with the values, computing all the patches that
+  /// are missing.
+
+  const Brick_t &fill(const Functor &f)
+  {
+    return fill(domain_m, f);
+  }
+
+private:
+
+  /// Compute the values of patch i.  The Brick is allocated, without
+  /// initializing it, the first time.
+
+  void compute(int i, const Functor &f)
+  {
+    if (!brick_m.dataBlock().isValid())
+      {
+	typedef typename DataBlockPtr<T>::NoInitTag NoInit_t;
+	DataBlockPtr<T> block(domain_m.size(), NoInit_t());
+	block.resize(domain_m.size(), NoInit_t());
+	brick_m = Brick_t(block, domain_m);
+      }
+
+    const Domain_t &patch = patches_m[i];
+    if (!patch.empty())
+      {
+	typedef Engine<Dim, T, IndexFunction<Functor> > Function_t;
+	typedef typename NewEngine<Function_t, Domain_t>::Type_t FView_t;
+	typedef Engine<Dim, T, BrickView> BView_t;
+
+	Function_t function(domain_m, f);
+	KernelEvaluator<InlineKernelTag>::evaluate(BView_t(brick_m, patch),
+						   OpAssign(),
+						   FView_t(function, patch));
+      }
+
+    valid_m[i] = true;
+    if (++nvalid_m == patches())
+      complete_m.store(true, std::memory_order_release);
+  }
+
+  Domain_t domain_m;
+  std::vector<Domain_t> patches_m;
+  std::vector<bool> valid_m;
+  int nvalid_m;
+  std::atomic<bool> complete_m;
+  Brick_t brick_m;
+  Pooma::Mutex_t mutex_m;
+};
+
+} // namespace Pooma
+
+
+/**
+ * Engine<Dim, T, CachedIndexFunction<Functor> > is a specialization of
+ * Engine for CachedIndexFunction.  It is an index-function-engine that
+ * remembers the values: they are computed a patch at a time, the first
+ * time the patch is read, and kept in a Brick.  Expressions that read
+ * the array several times, or several expressions that read it, then
+ * compute the function only once.  This costs a Brick's worth of memory
+ * and is worth it for functions that are expensive to compute.
+ *
+ * The patches are those of the layout the engine is made with, so an
+ * engine made with the layout of the MultiPatch arrays it is used with
+ * computes just the patches the expressions read.  Views of the engine
+ * are BrickViews of the cache.
+ *
+ * Copies of the engine share the cache.  Replacing the functor with
+ * setFunctor() or the domain with setDomain() starts a new cache, so
+ * values of the old functor are never read.
+ */
+
+template<int Dim, class T, class Functor>
+class Engine<Dim, T, CachedIndexFunction<Functor> >
+{
+public:
+
+  //---------------------------------------------------------------------------
+  // Exported typedefs and constants
+
+  typedef CachedIndexFunction<Functor>             Tag_t;
+  typedef Engine<Dim, T, Tag_t>                    This_t;
+  typedef This_t                                   Engine_t;
+  typedef Interval<Dim>                            Domain_t;
+  typedef DomainLayout<Dim>                        Layout_t;
+  typedef T                                        Element_t;
+  typedef ErrorType                                ElementRef_t;
+  typedef Pooma::IndexFunctionCache<Dim, T, Functor> Cache_t;
+  typedef typename Cache_t::Brick_t                Brick_t;
+
+  enum { dimensions = Dim };
+  enum { hasDataObject = false };
+  enum { dynamic = false };
+  enum { zeroBased = false };
+  enum { multiPatch = false };
+
+  //---------------------------------------------------------------------------
+  /// Default constructor (allows subsequent initialization of domain/functor).
+
+  Engine() { }
+
+  //---------------------------------------------------------------------------
+  /// Construct from a domain/layout object and an optional Functor object.
+
+  explicit Engine(const Domain_t &domain, const Functor &f = Functor())
+  : funct_m(f), domain_m(domain), cache_m(new Cache_t(domain))
+  {
+  }
+
+  template<class Layout>
+  explicit Engine(const Layout &layout, const Functor &f = Functor())
+  : funct_m(f), domain_m(layout.domain()), cache_m(new Cache_t(layout))
+  {
+  }
+
+  //---------------------------------------------------------------------------
+  /// Construct from another cached index-function-engine, sharing the
+  /// cache.
+
+  Engine(const This_t &model)
+  : funct_m(model.functor()), domain_m(model.domain()), cache_m(model.cache_m)
+  {
+  }
+
+  //---------------------------------------------------------------------------
+  /// Assign one cached index-function-engine to another.
+
+  This_t &operator=(const This_t &rhs)
+  {
+    domain_m = rhs.domain();
+    funct_m = rhs.functor();
+    cache_m = rhs.cache_m;
+
+    return *this;
+  }
+
+  //---------------------------------------------------------------------------
+  /// @name Element access via ints for speed.  Reading the engine itself,
+  /// rather than a view, computes every patch.
+  //@{
+
+  inline Element_t read(int i0) const
+    {
+      return brick().read(i0);
+    }
+  inline Element_t read(int i0, int i1) const
+    {
+      return brick().read(i0, i1);
+    }
+  inline Element_t read(int i0, int i1, int i2) const
+    {
+      return brick().read(i0, i1, i2);
+    }
+  inline Element_t read(int i0, int i1, int i2, int i3) const
+    {
+      return brick().read(i0, i1, i2, i3);
+    }
+  inline Element_t read(int i0, int i1, int i2, int i3, int i4) const
+    {
+      return brick().read(i0, i1, i2, i3, i4);
+    }
+  inline Element_t read(int i0, int i1, int i2, int i3, int i4,
+    int i5) const
+    {
+      return brick().read(i0, i1, i2, i3, i4, i5);
+    }
+  inline Element_t read(int i0, int i1, int i2, int i3, int i4,
+    int i5, int i6) const
+    {
+      return brick().read(i0, i1, i2, i3, i4, i5, i6);
+    }
+  inline Element_t read(const Loc<Dim> &loc) const
+    {
+      return brick().read(loc);
+    }
+
+  //@}
+
+  //---------------------------------------------------------------------------
+  /// Return/set the domain. Also, return the base domain.
+
+  inline const Domain_t &domain() const { return domain_m; }
+  void setDomain(const Domain_t &dom)
+  {
+    domain_m = dom;
+    cache_m = new Cache_t(dom);
+  }
+
+  //---------------------------------------------------------------------------
+  /// Return the first index value for the specified direction.
+
+  inline int first(int i) const
+  {
+    PAssert(i >= 0 && i < Dim);
+    return domain_m[i].first();
+  }
+
+  //---------------------------------------------------------------------------
+  /// Returns the layout, which is constructed as a DomainLayout.
+
+  Layout_t layout() const
+  {
+    return Layout_t(domain_m);
+  }
+
+  //---------------------------------------------------------------------------
+  /// Accessor/modifier.  Setting the functor throws the cached values
+  /// away.
+
+  const Functor &functor() const { return funct_m; }
+  void setFunctor(const Functor &f)
+  {
+    funct_m = f;
+    if (cache_m.isValid())
+      cache_m = new Cache_t(*cache_m);
+  }
+
+  //---------------------------------------------------------------------------
+  /// Return the cache.
+
+  const Cache_t &cache() const { return *cache_m; }
+
+  //---------------------------------------------------------------------------
+  /// Return the Brick with the values, computing the patches that touch
+  /// the domain, or all of them.
+
+  const Brick_t &brick(const Domain_t &dom) const
+  {
+    return cache_m->fill(dom, funct_m);
+  }
+
+  const Brick_t &brick() const
+  {
+    return cache_m->fill(funct_m);
+  }
+
+private:
+
+  Functor funct_m;
+  Domain_t domain_m;
+  RefCountedPtr<Cache_t> cache_m;
+};
+
+
+/**
+ * NewEngine<Engine,SubDomain>
+ * NewEngineEngine<Engine,SubDomain>
+ * NewEngineDomain<Engine,SubDomain>
+ *
+ * Specializations for subsetting a cached index-function-engine with an
+ * arbitrary domain.  The view is a BrickView of the cache: the patches
+ * the domain touches are computed and the view is taken of the Brick.
+ */
+
+namespace Pooma {
+
+/// The Interval bounding the viewed part of a domain.
+
+template<int Dim>
+inline const Interval<Dim> &cacheBounds(const Interval<Dim> &d)
+{
+  return d;
+}
+
+template<int Dim>
+inline Interval<Dim> cacheBounds(const Range<Dim> &d)
+{
+  Interval<Dim> ret;
+  for (int i = 0; i < Dim; ++i)
+    ret[i] = Interval<1>(d[i].min(), d[i].max());
+  return ret;
+}
+
+template<int Dim>
+inline const Interval<Dim> &cacheBounds(const INode<Dim> &d)
+{
+  return d.domain();
+}
+
+template<int Dim>
+inline const Interval<Dim> &cacheBounds(const Node<Interval<Dim> > &d)
+{
+  return d.domain();
+}
+
+template<int Dim, int SliceDim>
+inline const Interval<Dim> &cacheBounds(const SliceInterval<Dim, SliceDim> &d)
+{
+  return d.totalDomain();
+}
+
+template<int Dim, int SliceDim>
+inline Interval<Dim> cacheBounds(const SliceRange<Dim, SliceDim> &d)
+{
+  return cacheBounds(d.totalDomain());
+}
+
+} // namespace Pooma
+
+template <int Dim, class T, class Functor>
+struct NewEngine<Engine<Dim, T, CachedIndexFunction<Functor> >, Interval<Dim> >
+{
+  typedef Engine<Dim, T, BrickView> Type_t;
+};
+
+template <int Dim, class T, class Functor>
+struct NewEngine<Engine<Dim, T, CachedIndexFunction<Functor> >, Range<Dim> >
+{
+  typedef Engine<Dim, T, BrickView> Type_t;
+};
+
+template <int Dim, class T, class Functor, int SliceDim>
+struct NewEngine<Engine<Dim, T, CachedIndexFunction<Functor> >,
+  SliceInterval<Dim, SliceDim> >
+{
+  typedef Engine<SliceDim, T, BrickView> Type_t;
+};
+
+template <int Dim, class T, class Functor, int SliceDim>
+struct NewEngine<Engine<Dim, T, CachedIndexFunction<Functor> >,
+  SliceRange<Dim, SliceDim> >
+{
+  typedef Engine<SliceDim, T, BrickView> Type_t;
+};
+
+template <int Dim, class T, class Functor>
+struct NewEngine<Engine<Dim, T, CachedIndexFunction<Functor> >,
+  Node<Interval<Dim> > >
+{
+  typedef Engine<Dim, T, BrickView> Type_t;
+};
+
+template <int Dim, class T, class Functor>
+struct NewEngine<Engine<Dim, T, CachedIndexFunction<Functor> >, INode<Dim> >
+{
+  typedef Engine<Dim, T, BrickView> Type_t;
+};
+
+template <int Dim, class T, class Functor, class Domain>
+struct NewEngineEngine<Engine<Dim, T, CachedIndexFunction<Functor> >, Domain>
+{
+  typedef Engine<Dim, T, Brick> Type_t;
+  static inline
+  const Type_t &apply(const Engine<Dim, T, CachedIndexFunction<Functor> > &e,
+		      const Domain &d)
+  {
+    return e.brick(Pooma::cacheBounds(d));
+  }
+};
+
+template <int Dim, class T, class Functor>
+struct NewEngineDomain<Engine<Dim, T, CachedIndexFunction<Functor> >,
+  Node<Interval<Dim> > >
+{
+  typedef Interval<Dim> Type_t;
+  typedef const Interval<Dim> &Return_t;
+  static inline
+  Return_t apply(const Engine<Dim, T, CachedIndexFunction<Functor> > &,
+		 const Node<Interval<Dim> > &node)
+  {
+    return node.domain();
+  }
+};
+
+template <int Dim, class T, class Functor>
+struct NewEngineDomain<Engine<Dim, T, CachedIndexFunction<Functor> >,
+  INode<Dim> >
+{
+  typedef Interval<Dim> Type_t;
+  typedef const Interval<Dim> &Return_t;
+  static inline
+  Return_t apply(const Engine<Dim, T, CachedIndexFunction<Functor> > &,
+		 const INode<Dim> &inode)
+  {
+    return inode.domain();
+  }
+};
+
+#endif // POOMA_ENGINE_CACHEDINDEXFUNCTION_H
@@ -0,0 +1,152 @@
+// -*- C++ -*-
+//
+// Copyright (C) 1998, 1999, 2000, 2002  Los Alamos National Laboratory,
+// Copyright (C) 1998, 1999, 2000, 2002  CodeSourcery, LLC
+//
+// This file is part of FreePOOMA.
+//
+// FreePOOMA is free software; you can redistribute it and/or modify it
+// under the terms of the Expat license.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the Expat
+// license for more details.
+//
+// You should have received a copy of the Expat license along with
+// FreePOOMA; see the file LICENSE.
+//
+
+//-----------------------------------------------------------------------------
+// ComponentBrick-Engine non-inline template definitions.
+//-----------------------------------------------------------------------------
+
+#include "Engine/ComponentBrick.h"
+
+///////////////////////////////////////////////////////////////////////////////
+// namespace Pooma {
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// ComponentBrick-Engine Member Functions
+//
+///////////////////////////////////////////////////////////////////////////////
+
+
+//-----------------------------------------------------------------------------
+//
+// Engine<Dim,T,ComponentBrick> constructors:
+//
+//   Engine(const Domain_t &domain)
+//   Engine(const Domain_t &domain, const T &model)
+//   Engine(const Node<Domain_t> &node)
+//   Engine(const Layout_t &layout)
+//
+// Constructs a ComponentBrick-Engine for the domain.  One block holds
+// all of the components, one after another, and each component is a
+// Brick on its part of the block.
+//
+//-----------------------------------------------------------------------------
+
+template <int Dim, class T>
+Engine<Dim,T,ComponentBrick>::Engine(const Domain_t &domain)
+{
+  init(domain);
+}
+
+template <int Dim, class T>
+Engine<Dim,T,ComponentBrick>::Engine(const Domain_t &domain, const T &model)
+{
+  init(domain);
+  for (int c = 0; c < Base_t::components; ++c)
+    {
+      Component_t v = Base_t::Components_t::get(model, c);
+      Component_t *p = this->data_m[c];
+      for (int i = 0, n = domain.size(); i < n; ++i)
+	p[i] = v;
+    }
+}
+
+template <int Dim, class T>
+Engine<Dim,T,ComponentBrick>::Engine(const Node<Domain_t> &node)
+{
+  init(node.allocated());
+}
+
+template <int Dim, class T>
+Engine<Dim,T,ComponentBrick>::Engine(const Layout_t &layout)
+{
+  init(layout.domain());
+}
+
+template <int Dim, class T>
+void Engine<Dim,T,ComponentBrick>::init(const Domain_t &domain)
+{
+  int n = domain.size();
+  DataBlockPtr<Component_t> block(n * Base_t::components);
+  for (int c = 0; c < Base_t::components; ++c)
+    this->comps_m[c] =
+      ComponentEngine_t(DataBlockPtr<Component_t>(block, c * n), domain);
+  this->resetData();
+}
+
+
+//-----------------------------------------------------------------------------
+//
+// Engine<Dim,T,ComponentBrick> copy constructor and assignment.  These
+// share the block.
+//
+//-----------------------------------------------------------------------------
+
+template <int Dim, class T>
+Engine<Dim,T,ComponentBrick>::Engine(const Engine_t &model)
+  : Base_t(model)
+{
+  this->resetData();
+}
+
+template <int Dim, class T>
+Engine<Dim,T,ComponentBrick> &
+Engine<Dim,T,ComponentBrick>::operator=(const Engine_t &model)
+{
+  if (this != &model)
+    {
+      for (int c = 0; c < Base_t::components; ++c)
+	this->comps_m[c] = model.comps_m[c];
+      this->resetData();
+    }
+  return *this;
+}
+
+
+//-----------------------------------------------------------------------------
+//
+// Engine<Dim,T,ComponentBrick> & makeOwnCopy()
+//
+// Causes the ComponentBrick-Engine to obtain a private copy of the
+// block.  The components themselves hold one reference each, so the
+// block is shared if there are more references than components.
+//
+//-----------------------------------------------------------------------------
+
+template <int Dim, class T>
+Engine<Dim,T,ComponentBrick> &Engine<Dim,T,ComponentBrick>::makeOwnCopy()
+{
+  DataBlockPtr<Component_t> block = this->comps_m[0].dataBlock();
+  if (block.isValid() && block.count() > Base_t::components + 1)
+    {
+      int n = this->domain().size();
+      block.makeOwnCopy();
+      for (int c = 0; c < Base_t::components; ++c)
+	this->comps_m[c] =
+	  ComponentEngine_t(DataBlockPtr<Component_t>(block, c * n),
+			    this->domain());
+      this->resetData();
+    }
+
+  return *this;
+}
+
+// } // namespace Pooma
+///////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,956 @@
+// -*- C++ -*-
+//
+// Copyright (C) 1998, 1999, 2000, 2002  Los Alamos National Laboratory,
+// Copyright (C) 1998, 1999, 2000, 2002  CodeSourcery, LLC
+//
+// This file is part of FreePOOMA.
+//
+// FreePOOMA is free software; you can redistribute it and/or modify it
+// under the terms of the Expat license.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the Expat
+// license for more details.
+//
+// You should have received a copy of the Expat license along with
+// FreePOOMA; see the file LICENSE.
+//
+
+
+/** @file
+ * @ingroup Engine
+ * @brief
+ * ComponentBrick engine: a brick of Vector, Tensor or TinyMatrix elements
+ * that keeps each component in a brick of its own.
+ *
+ * Classes:
+ *  - ComponentBrick & ComponentBrickView, specialization tags.
+ *  - ElementComponents<T>, how an element is split into components.
+ *  - ComponentBrickRef<T>, the proxy used to write an element.
+ *  - Pooma::ComponentBrickBase<Dim,T,ComponentTag>, element access shared
+ *    by the two engines.
+ *  - Engine<Dim,T,ComponentBrick>, the "ComponentBrick-Engine"
+ *    specialization.
+ *  - Engine<Dim,T,ComponentBrickView>, the "ComponentBrickView-Engine"
+ *    specialization.
+ *  - NewEngine<Engine,SubDomain>, specializations for
+ *    ComponentBrickView-Engine.
+ *  - ComponentView specializations making the component views of Arrays
+ *    and Fields Bricks and BrickViews.
+ *  - VectorElem, TensorElem, TinyMatrixElem and ForwardRef
+ *    specializations for ComponentBrickRef.
+ */
+
+#ifndef POOMA_ENGINE_COMPONENTBRICK_H
+#define POOMA_ENGINE_COMPONENTBRICK_H
+
+//-----------------------------------------------------------------------------
+// Includes:
+//-----------------------------------------------------------------------------
+
+#include "Domain/Domain.h"
+#include "Domain/Interval.h"
+#include "Domain/Loc.h"
+#include "Domain/Range.h"
+#include "Domain/SliceInterval.h"
+#include "Domain/SliceRange.h"
+#include "Engine/BrickEngine.h"
+#include "Engine/Engine.h"
+#include "Engine/ForwardingEngine.h"
+#include "Layout/DomainLayout.h"
+#include "Layout/Node.h"
+#include "Layout/INode.h"
+#include "Pooma/View.h"
+#include "Tiny/Vector.h"
+#include "Tiny/Tensor.h"
+#include "Tiny/TinyMatrix.h"
+#include "Utilities/DataBlockPtr.h"
+#include "Utilities/ElementProperties.h"
+#include "Utilities/PAssert.h"
+#include <iosfwd>
+
+
+//-----------------------------------------------------------------------------
+// Forward declarations:
+//-----------------------------------------------------------------------------
+
+template<int Dim, class T, class EngineTag> class Array;
+template<class Mesh, class T, class EngineTag> class Field;
+template<class Components> class ComponentWrapper;
+
+
+///////////////////////////////////////////////////////////////////////////////
+// namespace Pooma {
+
+/**
+ * These are the tag classes used to select the "ComponentBrick" and
+ * "ComponentBrickView" specializations of the Engine class template.
+ */
+
+struct ComponentBrick { };
+struct ComponentBrickView { };
+
+/**
+ * ElementComponents<T> tells how an element of type T is split into
+ * components: there are size components of type Component_t, numbered
+ * as the elements of a Fortran array, and index() turns the indices of
+ * a component into its number.  It is defined for Vectors, Tensors and
+ * TinyMatrices with Full engines.
+ */
+
+template<class T>
+struct ElementComponents;
+
+template<int D, class T>
+struct ElementComponents<Vector<D, T, Full> >
+{
+  typedef Vector<D, T, Full> Element_t;
+  typedef T Component_t;
+  enum { size = D };
+
+  static int index(int i) { return i; }
+  static int index(const Loc<1> &l) { return l[0].first(); }
+
+  static const T &get(const Element_t &x, int c) { return x(c); }
+  static void set(Element_t &x, int c, const T &v) { x(c) = v; }
+};
+
+template<int D, class T>
+struct ElementComponents<Tensor<D, T, Full> >
+{
+  typedef Tensor<D, T, Full> Element_t;
+  typedef T Component_t;
+  enum { size = D * D };
+
+  static int index(int i, int j) { return i + D * j; }
+  static int index(const Loc<2> &l)
+  {
+    return index(l[0].first(), l[1].first());
+  }
+
+  static const T &get(const Element_t &x, int c) { return x(c % D, c / D); }
+  static void set(Element_t &x, int c, const T &v) { x(c % D, c / D) = v; }
+};
+
+template<int D1, int D2, class T>
+struct ElementComponents<TinyMatrix<D1, D2, T, Full> >
+{
+  typedef TinyMatrix<D1, D2, T, Full> Element_t;
+  typedef T Component_t;
+  enum { size = D1 * D2 };
+
+  static int index(int i, int j) { return i + D1 * j; }
+  static int index(const Loc<2> &l)
+  {
+    return index(l[0].first(), l[1].first());
+  }
+
+  static const T &get(const Element_t &x, int c)
+  {
+    return x(c % D1, c / D1);
+  }
+  static void set(Element_t &x, int c, const T &v)
+  {
+    x(c % D1, c / D1) = v;
+  }
+};
+
+/**
+ * ComponentBrickRef<T> is returned by the operator() of ComponentBricks
+ * instead of a T&.  It points at the same position in the storage of
+ * every component.  Converting it to T gathers the components; assigning
+ * to it scatters them.  The components can be written one at a time
+ * with operator(), as for the element itself.
+ */
+
+template<class T>
+class ComponentBrickRef
+{
+public:
+
+  typedef ComponentBrickRef<T>                   This_t;
+  typedef ElementComponents<T>                   Components_t;
+  typedef typename Components_t::Component_t     Component_t;
+
+  enum { size = Components_t::size };
+
+  ComponentBrickRef(Component_t *const *data, int offset)
+    : data_m(data), offset_m(offset)
+  { }
+
+  /// Gather the element.
+
+  T read() const
+  {
+    T x;
+    for (int c = 0; c < size; ++c)
+      Components_t::set(x, c, data_m[c][offset_m]);
+    return x;
+  }
+
+  operator T() const { return read(); }
+
+  //@{
+
+  /// Assignment writes through to the components.  Anything a T can be
+  /// made from can be assigned.
+
+  This_t &operator=(const T &x)
+  {
+    for (int c = 0; c < size; ++c)
+      data_m[c][offset_m] = Components_t::get(x, c);
+    return *this;
+  }
+
+  This_t &operator=(const This_t &x)
+  {
+    return *this = x.read();
+  }
+
+  template<class X>
+  This_t &operator=(const X &x)
+  {
+    T y(x);
+    return *this = y;
+  }
+
+  //@}
+
+  //@{
+
+  /// Computed assignment reads the element and writes it back.
+
+  template<class X>
+  This_t &operator+=(const X &x)
+  {
+    T y = read();
+    y += x;
+    return *this = y;
+  }
+
+  template<class X>
+  This_t &operator-=(const X &x)
+  {
+    T y = read();
+    y -= x;
+    return *this = y;
+  }
+
+  template<class X>
+  This_t &operator*=(const X &x)
+  {
+    T y = read();
+    y *= x;
+    return *this = y;
+  }
+
+  template<class X>
+  This_t &operator/=(const X &x)
+  {
+    T y = read();
+    y /= x;
+    return *this = y;
+  }
+
+  //@}
+
+  //@{
+
+  /// Component access.
+
+  Component_t &operator()(int i) const
+  {
+    return data_m[Components_t::index(i)][offset_m];
+  }
+
+  Component_t &operator()(int i, int j) const
+  {
+    return data_m[Components_t::index(i, j)][offset_m];
+  }
+
+  template<class Components>
+  Component_t &component(const Components &c) const
+  {
+    return data_m[Components_t::index(c)][offset_m];
+  }
+
+  //@}
+
+private:
+
+  Component_t *const *data_m;
+  int offset_m;
+};
+
+template<class T>
+std::ostream &operator<<(std::ostream &out, const ComponentBrickRef<T> &r)
+{
+  return out << r.read();
+}
+
+
+namespace Pooma {
+
+/**
+ * ComponentBrickBase<Dim,T,ComponentTag> holds one
+ * Engine<Dim,Component_t,ComponentTag> for each component of the
+ * elements and does the element access for ComponentBrick and
+ * ComponentBrickView.  All of the components have the same domain and
+ * strides, so an element is found at the same offset from the start
+ * of every component.
+ */
+
+template <int Dim, class T, class ComponentTag>
+class ComponentBrickBase
+{
+public:
+
+  //============================================================
+  // Exported typedefs and constants
+  //============================================================
+
+  typedef ElementComponents<T>                       Components_t;
+  typedef typename Components_t::Component_t         Component_t;
+  typedef Engine<Dim,Component_t,ComponentTag>       ComponentEngine_t;
+  typedef typename ComponentEngine_t::Domain_t       Domain_t;
+  typedef DomainLayout<Dim>                          Layout_t;
+  typedef T                                          Element_t;
+  typedef ComponentBrickRef<T>                       ElementRef_t;
+
+  enum { components = Components_t::size };
+
+  //============================================================
+  // Constructors
+  //============================================================
+
+  ComponentBrickBase()
+  {
+    for (int c = 0; c < components; ++c)
+      data_m[c] = 0;
+  }
+
+  //============================================================
+  // Accessor functions
+  //============================================================
+
+  //@{
+
+  /// Element access via Loc.
+
+  Element_t read(const Loc<Dim> &loc) const
+  {
+    return ElementRef_t(data_m, comps_m[0].offset(loc)).read();
+  }
+  ElementRef_t operator()(const Loc<Dim> &loc) const
+  {
+    return ElementRef_t(data_m, comps_m[0].offset(loc));
+  }
+
+  //@}
+
+  //@{
+
+  /// Element access via ints for speed.
+
+  Element_t read(int i1) const
+  {
+    CTAssert(Dim == 1);
+    return ElementRef_t(data_m, comps_m[0].offset(i1)).read();
+  }
+  Element_t read(int i1, int i2) const
+  {
+    CTAssert(Dim == 2);
+    return ElementRef_t(data_m, comps_m[0].offset(i1,i2)).read();
+  }
+  Element_t read(int i1, int i2, int i3) const
+  {
+    CTAssert(Dim == 3);
+    return ElementRef_t(data_m, comps_m[0].offset(i1,i2,i3)).read();
+  }
+  Element_t read(int i1, int i2, int i3, int i4) const
+  {
+    CTAssert(Dim == 4);
+    return ElementRef_t(data_m, comps_m[0].offset(i1,i2,i3,i4)).read();
+  }
+  Element_t read(int i1, int i2, int i3, int i4, int i5) const
+  {
+    CTAssert(Dim == 5);
+    return ElementRef_t(data_m, comps_m[0].offset(i1,i2,i3,i4,i5)).read();
+  }
+  Element_t read(int i1, int i2, int i3, int i4, int i5, int i6) const
+  {
+    CTAssert(Dim == 6);
+    return ElementRef_t(data_m,
+			comps_m[0].offset(i1,i2,i3,i4,i5,i6)).read();
+  }
+  Element_t read(int i1, int i2, int i3, int i4, int i5, int i6, int i7) const
+  {
+    CTAssert(Dim == 7);
+    return ElementRef_t(data_m,
+			comps_m[0].offset(i1,i2,i3,i4,i5,i6,i7)).read();
+  }
+
+  ElementRef_t operator()(int i1) const
+  {
+    CTAssert(Dim == 1);
+    return ElementRef_t(data_m, comps_m[0].offset(i1));
+  }
+  ElementRef_t operator()(int i1, int i2) const
+  {
+    CTAssert(Dim == 2);
+    return ElementRef_t(data_m, comps_m[0].offset(i1,i2));
+  }
+  ElementRef_t operator()(int i1, int i2, int i3) const
+  {
+    CTAssert(Dim == 3);
+    return ElementRef_t(data_m, comps_m[0].offset(i1,i2,i3));
+  }
+  ElementRef_t operator()(int i1, int i2, int i3, int i4) const
+  {
+    CTAssert(Dim == 4);
+    return ElementRef_t(data_m, comps_m[0].offset(i1,i2,i3,i4));
+  }
+  ElementRef_t operator()(int i1, int i2, int i3, int i4, int i5) const
+  {
+    CTAssert(Dim == 5);
+    return ElementRef_t(data_m, comps_m[0].offset(i1,i2,i3,i4,i5));
+  }
+  ElementRef_t operator()(int i1, int i2, int i3, int i4, int i5, int i6) const
+  {
+    CTAssert(Dim == 6);
+    return ElementRef_t(data_m, comps_m[0].offset(i1,i2,i3,i4,i5,i6));
+  }
+  ElementRef_t operator()(int i1, int i2, int i3, int i4, int i5, int i6,
+			  int i7) const
+  {
+    CTAssert(Dim == 7);
+    return ElementRef_t(data_m, comps_m[0].offset(i1,i2,i3,i4,i5,i6,i7));
+  }
+
+  //@}
+
+  /// Return the domain.
+
+  const Domain_t &domain() const { return comps_m[0].domain(); }
+
+  /// Return a layout.
+
+  Layout_t layout() const { return Layout_t(domain()); }
+
+  //@{
+
+  /// Return the engine holding one component, given by its number or
+  /// by the Loc used for component views.
+
+  const ComponentEngine_t &component(int c) const
+  {
+    PAssert(c >= 0 && c < components);
+    return comps_m[c];
+  }
+
+  template <int N>
+  const ComponentEngine_t &component(const Loc<N> &c) const
+  {
+    return component(Components_t::index(c));
+  }
+
+  //@}
+
+  /// All of the components share the data object of their block.
+
+  Pooma::DataObject_t *dataObject() const { return comps_m[0].dataObject(); }
+
+protected:
+
+  /// Set the pointers to the data of the components after they have
+  /// been changed.
+
+  void resetData()
+  {
+    for (int c = 0; c < components; ++c)
+      data_m[c] = comps_m[c].dataBlock().currentPointer();
+  }
+
+  ComponentEngine_t comps_m[components];
+  Component_t *data_m[components];
+};
+
+} // namespace Pooma
+
+
+/**
+ * Engine<Dim,T,ComponentBrick> (aka ComponentBrick-Engine)
+ *
+ * Engine<Dim,T,ComponentBrick> is an Engine for a local, Dim-dimensional
+ * brick of Vector, Tensor or TinyMatrix elements that stores each
+ * component contiguously, rather than one element after another.
+ * Component views of Arrays and Fields with this engine are Bricks,
+ * and their views BrickViews with unit stride, so expressions on the
+ * components are evaluated with the same loops as on any Brick.
+ *
+ * Template Parameters:
+ *  - Dim: An integer for the dimension of the ComponentBrick.
+ *  - T:   The element type, a Vector, Tensor or TinyMatrix with a Full
+ *         engine.  See ElementComponents.
+ *
+ * The Domain of this engine is an Interval<Dim>.  The components are
+ * Bricks sharing one block, so they have one data object.  Elements are
+ * read as T and written through a ComponentBrickRef.
+ *
+ * Subsetting Engine<Dim,T,ComponentBrick> returns an
+ * Engine<Dim,T,ComponentBrickView>.
+ */
+
+template <int Dim, class T>
+class Engine<Dim,T,ComponentBrick>
+  : public Pooma::ComponentBrickBase<Dim,T,Brick>
+{
+public:
+
+  //============================================================
+  // Exported typedefs and constants
+  //============================================================
+
+  typedef Engine<Dim,T,ComponentBrick>               This_t;
+  typedef Engine<Dim,T,ComponentBrick>               Engine_t;
+  typedef Pooma::ComponentBrickBase<Dim,T,Brick>     Base_t;
+  typedef typename Base_t::Component_t               Component_t;
+  typedef typename Base_t::ComponentEngine_t         ComponentEngine_t;
+  typedef typename Base_t::Domain_t                  Domain_t;
+  typedef typename Base_t::Layout_t                  Layout_t;
+  typedef typename Base_t::Element_t                 Element_t;
+  typedef typename Base_t::ElementRef_t              ElementRef_t;
+  typedef ComponentBrick                             Tag_t;
+
+  enum { dimensions    = Dim   };
+  enum { hasDataObject = true  };
+  enum { dynamic       = false };
+  enum { zeroBased     = false };
+  enum { multiPatch    = false };
+
+  //============================================================
+  // Constructors and Factory Methods
+  //============================================================
+
+  /// Default constructor.  Creates a ComponentBrick-Engine with no
+  /// data.
+
+  Engine() { }
+
+  //@{
+
+  /// Allocate storage for the domain, given directly or through a
+  /// Node or Layout_t object.  The second version initializes the
+  /// elements with a model.
+
+  explicit Engine(const Domain_t &domain);
+
+  Engine(const Domain_t &domain, const T &elementModel);
+
+  explicit Engine(const Layout_t &layout);
+
+  explicit Engine(const Node<Domain_t> &node);
+
+  //@}
+
+  /// Copy constructor performs a SHALLOW copy.
+
+  Engine(const Engine_t &model);
+
+  //============================================================
+  // Assignment operators
+  //============================================================
+
+  /// Assigment is SHALLOW, to be consistent with copy.
+
+  Engine_t &operator=(const Engine_t &model);
+
+  //============================================================
+  // Accessor and Mutator functions:
+  //============================================================
+
+  /// Get a private copy of the data viewed by this Engine.
+
+  Engine_t &makeOwnCopy();
+
+private:
+
+  /// Make the components on a new block for the domain.
+
+  void init(const Domain_t &domain);
+};
+
+
+/**
+ * Engine<Dim,T,ComponentBrickView> (aka ComponentBrickView-Engine)
+ *
+ * A ComponentBrickView-Engine is a view of a ComponentBrick-Engine made
+ * of a BrickView of each component.  As for BrickViews, its domain is
+ * zero-based.
+ */
+
+template <int Dim, class T>
+class Engine<Dim,T,ComponentBrickView>
+  : public Pooma::ComponentBrickBase<Dim,T,BrickView>
+{
+public:
+
+  //============================================================
+  // Exported typedefs and constants
+  //============================================================
+
+  typedef Engine<Dim,T,ComponentBrickView>           This_t;
+  typedef Engine<Dim,T,ComponentBrickView>           Engine_t;
+  typedef Pooma::ComponentBrickBase<Dim,T,BrickView> Base_t;
+  typedef typename Base_t::Component_t               Component_t;
+  typedef typename Base_t::ComponentEngine_t         ComponentEngine_t;
+  typedef typename Base_t::Domain_t                  Domain_t;
+  typedef typename Base_t::Layout_t                  Layout_t;
+  typedef typename Base_t::Element_t                 Element_t;
+  typedef typename Base_t::ElementRef_t              ElementRef_t;
+  typedef ComponentBrickView                         Tag_t;
+
+  enum { dimensions    = Dim   };
+  enum { hasDataObject = true  };
+  enum { dynamic       = false };
+  enum { zeroBased     = true  };
+  enum { multiPatch    = false };
+
+  //============================================================
+  // Constructors
+  //============================================================
+
+  /// Default constructor is required for containers.
+
+  Engine() { }
+
+  //@{
+
+  /// Copy constructors perform a SHALLOW copy.  The second is used for
+  /// the patches of MultiPatch views.
+
+  Engine(const Engine_t &model)
+    : Base_t(model)
+  { }
+
+  Engine(const Engine_t &model, const EngineConstructTag &)
+    : Base_t(model)
+  { }
+
+  //@}
+
+  //@{
+
+  /// Subsetting constructors.  Each component is viewed with the
+  /// domain, which is an Interval<Dim> or a Range<Dim>, or a slice.
+
+  template <class ETag, class DT>
+  Engine(const Engine<Dim,T,ETag> &e, const Domain<Dim, DT> &dom)
+  {
+    for (int c = 0; c < Base_t::components; ++c)
+      this->comps_m[c] = ComponentEngine_t(e.component(c), dom);
+    this->resetData();
+  }
+
+  template <int Dim2, class ETag>
+  Engine(const Engine<Dim2,T,ETag> &e, const SliceRange<Dim2,Dim> &dom)
+  {
+    for (int c = 0; c < Base_t::components; ++c)
+      this->comps_m[c] = ComponentEngine_t(e.component(c), dom);
+    this->resetData();
+  }
+
+  template <int Dim2, class ETag>
+  Engine(const Engine<Dim2,T,ETag> &e, const SliceInterval<Dim2,Dim> &dom)
+  {
+    for (int c = 0; c < Base_t::components; ++c)
+      this->comps_m[c] = ComponentEngine_t(e.component(c), dom);
+    this->resetData();
+  }
+
+  //@}
+
+  //============================================================
+  // Assignment operators
+  //============================================================
+
+  Engine_t &operator=(const Engine_t &model)
+  {
+    Base_t::operator=(model);
+    return *this;
+  }
+};
+
+
+/**
+ * NewEngine<Engine,SubDomain>
+ *
+ * Views of ComponentBrick and ComponentBrickView engines are
+ * ComponentBrickViews.
+ */
+
+template <int Dim, class T>
+struct NewEngine<Engine<Dim,T,ComponentBrick>, Interval<Dim> >
+{
+  typedef Engine<Dim,T,ComponentBrickView> Type_t;
+};
+
+template <int Dim, class T>
+struct NewEngine<Engine<Dim,T,ComponentBrick>, Range<Dim> >
+{
+  typedef Engine<Dim,T,ComponentBrickView> Type_t;
+};
+
+template <int Dim, class T>
+struct NewEngine<Engine<Dim,T,ComponentBrick>, Node<Interval<Dim> > >
+{
+  typedef Engine<Dim,T,ComponentBrickView> Type_t;
+};
+
+template <int Dim, class T>
+struct NewEngine<Engine<Dim,T,ComponentBrick>, INode<Dim> >
+{
+  typedef Engine<Dim,T,ComponentBrickView> Type_t;
+};
+
+template <int Dim, class T, int SliceDim>
+struct NewEngine<Engine<Dim,T,ComponentBrick>, SliceInterval<Dim,SliceDim> >
+{
+  typedef Engine<SliceDim,T,ComponentBrickView> Type_t;
+};
+
+template <int Dim, class T, int SliceDim>
+struct NewEngine<Engine<Dim,T,ComponentBrick>, SliceRange<Dim,SliceDim> >
+{
+  typedef Engine<SliceDim,T,ComponentBrickView> Type_t;
+};
+
+template <int Dim, class T>
+struct NewEngine<Engine<Dim,T,ComponentBrickView>, Interval<Dim> >
+{
+  typedef Engine<Dim,T,ComponentBrickView> Type_t;
+};
+
+template <int Dim, class T>
+struct NewEngine<Engine<Dim,T,ComponentBrickView>, Range<Dim> >
+{
+  typedef Engine<Dim,T,ComponentBrickView> Type_t;
+};
+
+template <int Dim, class T>
+struct NewEngine<Engine<Dim,T,ComponentBrickView>, Node<Interval<Dim> > >
+{
+  typedef Engine<Dim,T,ComponentBrickView> Type_t;
+};
+
+template <int Dim, class T>
+struct NewEngine<Engine<Dim,T,ComponentBrickView>, INode<Dim> >
+{
+  typedef Engine<Dim,T,ComponentBrickView> Type_t;
+};
+
+template <int Dim, class T, int SliceDim>
+struct NewEngine<Engine<Dim,T,ComponentBrickView>,
+  SliceInterval<Dim,SliceDim> >
+{
+  typedef Engine<SliceDim,T,ComponentBrickView> Type_t;
+};
+
+template <int Dim, class T, int SliceDim>
+struct NewEngine<Engine<Dim,T,ComponentBrickView>,
+  SliceRange<Dim,SliceDim> >
+{
+  typedef Engine<SliceDim,T,ComponentBrickView> Type_t;
+};
+
+
+/**
+ * NewEngineDomain<Engine,SubDomain>
+ *
+ * Views through Nodes and INodes are taken with their domains.
+ */
+
+template <int Dim, class T>
+struct NewEngineDomain<Engine<Dim,T,ComponentBrick>, Node<Interval<Dim> > >
+{
+  typedef Interval<Dim> Type_t;
+  typedef const Interval<Dim> &Return_t;
+  static inline
+  Return_t apply(const Engine<Dim,T,ComponentBrick> &,
+		 const Node<Interval<Dim> > &node)
+  {
+    return node.domain();
+  }
+};
+
+template <int Dim, class T>
+struct NewEngineDomain<Engine<Dim,T,ComponentBrick>, INode<Dim> >
+{
+  typedef Interval<Dim> Type_t;
+  typedef const Interval<Dim> &Return_t;
+  static inline
+  Return_t apply(const Engine<Dim,T,ComponentBrick> &,
+		 const INode<Dim> &inode)
+  {
+    return inode.domain();
+  }
+};
+
+template <int Dim, class T>
+struct NewEngineDomain<Engine<Dim,T,ComponentBrickView>,
+  Node<Interval<Dim> > >
+{
+  typedef Interval<Dim> Type_t;
+  typedef const Interval<Dim> &Return_t;
+  static inline
+  Return_t apply(const Engine<Dim,T,ComponentBrickView> &,
+		 const Node<Interval<Dim> > &node)
+  {
+    return node.domain();
+  }
+};
+
+template <int Dim, class T>
+struct NewEngineDomain<Engine<Dim,T,ComponentBrickView>, INode<Dim> >
+{
+  typedef Interval<Dim> Type_t;
+  typedef const Interval<Dim> &Return_t;
+  static inline
+  Return_t apply(const Engine<Dim,T,ComponentBrickView> &,
+		 const INode<Dim> &inode)
+  {
+    return inode.domain();
+  }
+};
+
+
+/**
+ * Traits class telling RefCountedBlockPointer that this class has
+ * shallow semantics and a makeOwnCopy method.
+ */
+
+template <int Dim, class T>
+struct ElementProperties<Engine<Dim, T, ComponentBrick> >
+  : public MakeOwnCopyProperties<Engine<Dim, T, ComponentBrick> >
+{ };
+
+
+/**
+ * Component views of Arrays and Fields with ComponentBrick engines are
+ * made directly from the engine of the component, so they are Bricks
+ * and BrickViews instead of CompFwd engines.
+ */
+
+template<class Components, int Dim, class T>
+struct ComponentView<Components, Array<Dim, T, ComponentBrick> >
+{
+  typedef Array<Dim, T, ComponentBrick> Subject_t;
+  typedef typename ElementComponents<T>::Component_t NewT_t;
+  typedef Array<Dim, NewT_t, Brick> Type_t;
+
+  inline static
+  Type_t make(const Subject_t &a, const Components &c)
+    {
+      return Type_t(a, ComponentWrapper<Components>(c));
+    }
+};
+
+template<class Components, int Dim, class T>
+struct ComponentView<Components, Array<Dim, T, ComponentBrickView> >
+{
+  typedef Array<Dim, T, ComponentBrickView> Subject_t;
+  typedef typename ElementComponents<T>::Component_t NewT_t;
+  typedef Array<Dim, NewT_t, BrickView> Type_t;
+
+  inline static
+  Type_t make(const Subject_t &a, const Components &c)
+    {
+      return Type_t(a, ComponentWrapper<Components>(c));
+    }
+};
+
+template<class Components, class Mesh, class T>
+struct ComponentView<Components, Field<Mesh, T, ComponentBrick> >
+{
+  typedef Field<Mesh, T, ComponentBrick> Subject_t;
+  typedef typename ElementComponents<T>::Component_t NewT_t;
+  typedef Field<Mesh, NewT_t, Brick> Type_t;
+
+  inline static
+  Type_t make(const Subject_t &f, const Components &c)
+    {
+      return Type_t(f, ComponentWrapper<Components>(c));
+    }
+};
+
+template<class Components, class Mesh, class T>
+struct ComponentView<Components, Field<Mesh, T, ComponentBrickView> >
+{
+  typedef Field<Mesh, T, ComponentBrickView> Subject_t;
+  typedef typename ElementComponents<T>::Component_t NewT_t;
+  typedef Field<Mesh, NewT_t, BrickView> Type_t;
+
+  inline static
+  Type_t make(const Subject_t &f, const Components &c)
+    {
+      return Type_t(f, ComponentWrapper<Components>(c));
+    }
+};
+
+
+/**
+ * The Tiny classes can be built from and assigned a ComponentBrickRef
+ * component by component, and CompFwd engines, used for the component
+ * views of MultiPatch arrays, forward to its components.
+ */
+
+template<int D, class T, class E, int I>
+struct VectorElem<ComponentBrickRef<Vector<D, T, E> >, I>
+{
+  typedef ComponentBrickRef<Vector<D, T, E> > V;
+  typedef T Element_t;
+  typedef T &ConstElementRef_t;
+  typedef T &ElementRef_t;
+  static ElementRef_t get(const V &x) { return x(I); }
+};
+
+template<int D, class T, class E, int I, int J>
+struct TensorElem<ComponentBrickRef<Tensor<D, T, E> >, I, J>
+{
+  typedef ComponentBrickRef<Tensor<D, T, E> > V;
+  typedef T Element_t;
+  typedef T &ConstElementRef_t;
+  typedef T &ElementRef_t;
+  static ElementRef_t get(const V &x) { return x(I, J); }
+};
+
+template<int D1, int D2, class T, class E, int I, int J>
+struct TinyMatrixElem<ComponentBrickRef<TinyMatrix<D1, D2, T, E> >, I, J>
+{
+  typedef ComponentBrickRef<TinyMatrix<D1, D2, T, E> > V;
+  typedef T Element_t;
+  typedef T &ConstElementRef_t;
+  typedef T &ElementRef_t;
+  static ElementRef_t get(const V &x) { return x(I, J); }
+};
+
+template<class T, class CompAccess>
+struct ForwardRef<ComponentBrickRef<T>, CompAccess>
+{
+  template<class Components>
+  static inline typename CompAccess::ElementRef_t
+  indexRef(const ComponentBrickRef<T> &r, const Components &c)
+  {
+    return r.component(c);
+  }
+};
+
+// } // namespace Pooma
+///////////////////////////////////////////////////////////////////////////////
+
+// Include .cpp file to get out-of-line functions.
+
+#include "Engine/ComponentBrick.cpp"
+
+#endif // POOMA_ENGINE_COMPONENTBRICK_H
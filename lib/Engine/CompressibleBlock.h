@@ -808,17 +808,20 @@ private:
               if (ptr == end) // All values are the same.
 	        {
 	          // Steps in compressing:
-	          // 1) stop observing the block and invalidate our pointer
-	          // 2) store the compressed value
+	          // 1) store the compressed value
+	          // 2) stop observing the block and invalidate our pointer
 	          // 3) notify compressed brick views that we've compressed
+	          // The value must be stored first, as invalidating the
+	          // block may free it.
 	  
+	          compressedData_m = *begin;
+
 	          block_m.detach();
 	          block_m.invalidate();
 	      
 	          --viewcount_m;
 	          PAssert(viewcount_m == 0);
 	      
-	          compressedData_m = *begin;
 	          ptr_m = &compressedData_m;
 	      
 	          Observable<T*>::notify(notifyCompress);
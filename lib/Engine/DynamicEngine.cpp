@@ -82,6 +82,14 @@ Engine(const This_t &modelEngine)
   PAssert(data_m.isAtBeginning());
 }
 
+template <class T>
+Engine<1,T,Dynamic>::
+Engine(This_t &&modelEngine) noexcept
+  : domain_m(modelEngine.domain_m),
+    data_m(std::move(modelEngine.data_m)),
+    first_m(modelEngine.first_m)
+{ }
+
 //-----------------------------------------------------------------------------
 //
 // Engine<1,T,Dynamic> & operator=(const Engine<1,T,Dynamic> &)
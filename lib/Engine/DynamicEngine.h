@@ -177,6 +177,11 @@ public:
 
   Engine(const Engine_t &model);
 
+  // Move constructor takes the data block over without touching its
+  // reference count.
+
+  Engine(Engine_t &&model) noexcept;
+
   // Subsetting Constructors.
   
   Engine(const Engine_t &model, const Interval<1> &domain);
@@ -54,6 +54,13 @@
 struct Brick;
 struct BrickView;
 struct CompressibleBrick;
+struct TiledCompressibleBrick;
+struct ComponentBrick;
+struct ComponentBrickView;
+template <class S> struct MixedPrecisionBrick;
+template <class S> struct MixedPrecisionBrickView;
+struct MappedBrick;
+struct MappedBrickView;
 struct ConstantFunction;
 template <class LayoutTag, class PatchTag> struct MultiPatch;
 template <class LayoutTag, class PatchTag, int Dim2> struct MultiPatchView;
@@ -100,6 +107,69 @@ struct TypeInfo<CompressibleBrick>
   }
 };
 
+template<>
+struct TypeInfo<TiledCompressibleBrick>
+{
+  static inline std::string name()
+  {
+    return "TiledCompressibleBrick";
+  }
+};
+
+template<>
+struct TypeInfo<ComponentBrick>
+{
+  static inline std::string name()
+  {
+    return "ComponentBrick";
+  }
+};
+
+template<>
+struct TypeInfo<ComponentBrickView>
+{
+  static inline std::string name()
+  {
+    return "ComponentBrickView";
+  }
+};
+
+template<class S>
+struct TypeInfo<MixedPrecisionBrick<S> >
+{
+  static inline std::string name()
+  {
+    return "MixedPrecisionBrick<" + TypeInfo<S>::name() + " >";
+  }
+};
+
+template<class S>
+struct TypeInfo<MixedPrecisionBrickView<S> >
+{
+  static inline std::string name()
+  {
+    return "MixedPrecisionBrickView<" + TypeInfo<S>::name() + " >";
+  }
+};
+
+template<>
+struct TypeInfo<MappedBrick>
+{
+  static inline std::string name()
+  {
+    return "MappedBrick";
+  }
+};
+
+template<>
+struct TypeInfo<MappedBrickView>
+{
+  static inline std::string name()
+  {
+    return "MappedBrickView";
+  }
+};
+
 template<>
 struct TypeInfo<ConstantFunction>
 {
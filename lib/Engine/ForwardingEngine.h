@@ -56,6 +56,24 @@ template <int Dim> class DomainLayout;
 template<class Eng, class Components>
 struct CompFwd { };
 
+/**
+ * ForwardRef<Ref, CompAccess> forwards the components to an element
+ * reference of type Ref, as returned by the operator() of the engine
+ * being forwarded to.  Engines that return a proxy instead of a
+ * reference specialize it.
+ */
+
+template<class Ref, class CompAccess>
+struct ForwardRef
+{
+  template<class Components>
+  static inline typename CompAccess::ElementRef_t
+  indexRef(Ref r, const Components &c)
+  {
+    return CompAccess::indexRef(r, c);
+  }
+};
+
 /**
  * A ForwardingEngine is used to forward indices to the elements of another
  * engine.
@@ -92,6 +110,7 @@ public:
   typedef ComponentAccess<FwdElement_t, Components> CompAccess_t;
   typedef typename CompAccess_t::Element_t  Element_t;
   typedef typename CompAccess_t::ElementRef_t  ElementRef_t;
+  typedef ForwardRef<typename Eng::ElementRef_t, CompAccess_t> FwdRef_t;
   typedef typename Eng::Domain_t Domain_t;
   typedef CompFwd<Eng, Components> Tag_t;
   typedef typename Eng::Layout_t Layout_t;
@@ -151,49 +170,49 @@ public:
 
   inline ElementRef_t operator()(const Loc<dimensions> &eloc) const
   {
-    return CompAccess_t::indexRef(elemEngine()(eloc), components());
+    return FwdRef_t::indexRef(elemEngine()(eloc), components());
   }
 
   inline ElementRef_t operator()(int i1) const
   {
-    return CompAccess_t::indexRef(elemEngine()(i1), components());
+    return FwdRef_t::indexRef(elemEngine()(i1), components());
   }
 
   inline ElementRef_t operator()(int i1, int i2) const
   {
-    return CompAccess_t::indexRef(elemEngine()(i1, i2), components());
+    return FwdRef_t::indexRef(elemEngine()(i1, i2), components());
   }
 
   inline ElementRef_t operator()(int i1, int i2, int i3) const
   {
-    return CompAccess_t::indexRef(elemEngine()(i1, i2, i3), 
-				  components());
+    return FwdRef_t::indexRef(elemEngine()(i1, i2, i3), 
+			      components());
   }
 
   inline ElementRef_t operator()(int i1, int i2, int i3, int i4) const
   {
-    return CompAccess_t::indexRef(elemEngine()(i1, i2, i3, i4), 
-				  components());
+    return FwdRef_t::indexRef(elemEngine()(i1, i2, i3, i4), 
+			      components());
   }
 
   inline ElementRef_t operator()(int i1, int i2, int i3, int i4, int i5) const
   {
-    return CompAccess_t::indexRef(elemEngine()(i1, i2, i3, i4, i5), 
-				  components());
+    return FwdRef_t::indexRef(elemEngine()(i1, i2, i3, i4, i5), 
+			      components());
   }
 
   inline ElementRef_t operator()(int i1, int i2, int i3, int i4, int i5,
 				 int i6) const
   {
-    return CompAccess_t::indexRef(elemEngine()(i1, i2, i3, i4, i5, i6), 
-				  components());
+    return FwdRef_t::indexRef(elemEngine()(i1, i2, i3, i4, i5, i6), 
+			      components());
   }
 
   inline ElementRef_t operator()(int i1, int i2, int i3, int i4, int i5,
 				 int i6, int i7) const
   {
-    return CompAccess_t::indexRef(elemEngine()(i1, i2, i3, i4, i5, i6, i7),
-				  components());
+    return FwdRef_t::indexRef(elemEngine()(i1, i2, i3, i4, i5, i6, i7),
+			      components());
   }
       
   //---------------------------------------------------------------------------
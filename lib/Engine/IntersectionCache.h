@@ -0,0 +1,445 @@
+// -*- C++ -*-
+//
+// Copyright (C) 1998, 1999, 2000, 2002  Los Alamos National Laboratory,
+// Copyright (C) 1998, 1999, 2000, 2002  CodeSourcery, LLC
+//
+// This file is part of FreePOOMA.
+//
+// FreePOOMA is free software; you can redistribute it and/or modify it
+// under the terms of the Expat license.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the Expat
+// license for more details.
+//
+// You should have received a copy of the Expat license along with
+// FreePOOMA; see the file LICENSE.
+//
+
+//-----------------------------------------------------------------------------
+// Classes:
+// IntersectionCache<Dim>
+// IntersectionLayout<Dim,Layout>
+// IntersectionCacheObserver<Dim,Layout>
+// IntersectionBaseLayout<Layout>
+//-----------------------------------------------------------------------------
+
+/** @file
+ * @ingroup Engine
+ * @brief
+ * IntersectionCache remembers the INodes that intersecting a sequence of
+ * layouts produced, so repeated expressions on the same layouts do not
+ * have to intersect them again.
+ */
+
+#ifndef POOMA_ENGINE_INTERSECTIONCACHE_H
+#define POOMA_ENGINE_INTERSECTIONCACHE_H
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+
+#include "Utilities/RefCounted.h"
+#include "Utilities/RefCountedPtr.h"
+#include "Utilities/Observer.h"
+#include "Utilities/ObserverEvent.h"
+#include "Utilities/Observable.h"
+#include "Threads/PoomaMutex.h"
+#include <vector>
+#include <map>
+#include <algorithm>
+
+
+//-----------------------------------------------------------------------------
+// Forward declaratations
+//-----------------------------------------------------------------------------
+
+template<int Dim> class IntersectorData;
+template<int Dim> class IntersectionCache;
+
+template<int Dim> class UniformGridLayout;
+template<int Dim, int Dim2> class UniformGridLayoutView;
+template<int Dim> class GridLayout;
+template<int Dim, int Dim2> class GridLayoutView;
+template<int Dim> class SparseTileLayout;
+template<int Dim, int Dim2> class SparseTileLayoutView;
+class DynamicLayout;
+class DynamicLayoutView;
+
+
+/**
+ * IntersectionBaseLayout<Layout>::baseLayout(layout) returns the layout
+ * whose observer events tell us that intersections with layout have
+ * changed.  Layouts are their own base layouts, views return the layout
+ * they are viewing.
+ */
+
+template<class Layout>
+struct IntersectionBaseLayout
+{
+  typedef Layout Base_t;
+
+  inline static
+  const Base_t &baseLayout(const Layout &layout) { return layout; }
+};
+
+template<int Dim, int Dim2>
+struct IntersectionBaseLayout<UniformGridLayoutView<Dim, Dim2> >
+{
+  typedef UniformGridLayout<Dim2> Base_t;
+
+  inline static
+  const Base_t &baseLayout(const UniformGridLayoutView<Dim, Dim2> &layout)
+  {
+    return layout.baseLayout();
+  }
+};
+
+template<int Dim, int Dim2>
+struct IntersectionBaseLayout<GridLayoutView<Dim, Dim2> >
+{
+  typedef GridLayout<Dim2> Base_t;
+
+  inline static
+  const Base_t &baseLayout(const GridLayoutView<Dim, Dim2> &layout)
+  {
+    return layout.baseLayout();
+  }
+};
+
+template<int Dim, int Dim2>
+struct IntersectionBaseLayout<SparseTileLayoutView<Dim, Dim2> >
+{
+  typedef SparseTileLayout<Dim2> Base_t;
+
+  inline static
+  const Base_t &baseLayout(const SparseTileLayoutView<Dim, Dim2> &layout)
+  {
+    return layout.baseLayout();
+  }
+};
+
+template<>
+struct IntersectionBaseLayout<DynamicLayoutView>
+{
+  typedef DynamicLayout Base_t;
+
+  // A template, so DynamicLayoutView does not have to be defined here.
+
+  template<class View>
+  inline static
+  const Base_t &baseLayout(const View &layout)
+  {
+    return layout.baseLayout();
+  }
+};
+
+
+/**
+ * IntersectionCacheObserver watches the data of a base layout.  It does
+ * not keep a copy of the layout, so the layout can go away while the
+ * cache knows about it.  When the data is repartitioned or changed the
+ * cache drops the intersections with the layout, when the data is
+ * destroyed the cache drops the observer too.
+ */
+
+template<int Dim>
+class IntersectionCacheObserverBase
+  : public RefCounted
+{
+public:
+
+  virtual ~IntersectionCacheObserverBase() { }
+};
+
+template<int Dim, class Layout>
+class IntersectionCacheObserver
+  : public IntersectionCacheObserverBase<Dim>,
+    public Observer<typename Layout::LayoutData_t>
+{
+public:
+
+  typedef typename Layout::LayoutData_t LayoutData_t;
+
+  IntersectionCacheObserver(const Layout &layout,
+			    IntersectionCache<Dim> &cache)
+    : data_m(&layout.layoutData()), id_m(layout.ID()), cache_m(cache)
+  {
+    data_m->attach(*this);
+  }
+
+  virtual ~IntersectionCacheObserver()
+  {
+    if (data_m != 0)
+      data_m->detach(*this);
+  }
+
+  virtual void notify(LayoutData_t &, const ObserverEvent &event)
+  {
+    if (event.event() == Observable<LayoutData_t>::deleteEvent)
+    {
+      // The data has detached us already.  Forgetting the layout
+      // deletes this observer, so nothing may be touched afterwards.
+
+      IntersectionCache<Dim> &cache = cache_m;
+      int id = id_m;
+      data_m = 0;
+      cache.forget(id);
+    }
+    else
+    {
+      cache_m.invalidate(id_m);
+    }
+  }
+
+private:
+
+  LayoutData_t *data_m;
+  int id_m;
+  IntersectionCache<Dim> &cache_m;
+};
+
+
+/**
+ * IntersectionLayout holds a layout that an IntersectorData has been asked
+ * to intersect, until the IntersectorData knows whether the cache already
+ * has the result.  The IntersectorData builds them in a buffer of its
+ * own, so they are not reference counted.
+ */
+
+template<int Dim>
+class IntersectionLayoutBase
+{
+public:
+
+  virtual ~IntersectionLayoutBase() { }
+
+  // Intersect the INodes of data with the layout.
+
+  virtual void touches(IntersectorData<Dim> &data) const = 0;
+
+  // Make an observer of the base layout for the cache.
+
+  virtual IntersectionCacheObserverBase<Dim> *
+  observer(IntersectionCache<Dim> &cache) const = 0;
+};
+
+template<int Dim, class Layout>
+class IntersectionLayout
+  : public IntersectionLayoutBase<Dim>
+{
+public:
+
+  IntersectionLayout(const Layout &layout)
+    : layout_m(layout)
+  { }
+
+  virtual void touches(IntersectorData<Dim> &data) const
+  {
+    data.touchesNodes(layout_m);
+  }
+
+  virtual IntersectionCacheObserverBase<Dim> *
+  observer(IntersectionCache<Dim> &cache) const
+  {
+    typedef IntersectionBaseLayout<Layout> Base_t;
+    return new IntersectionCacheObserver<Dim, typename Base_t::Base_t>
+      (Base_t::baseLayout(layout_m), cache);
+  }
+
+private:
+
+  Layout layout_m;
+};
+
+
+/**
+ * IntersectionCache<Dim> maps the layouts an IntersectorData<Dim> touched
+ * to the IntersectorData that resulted.  The key holds the base ID, base
+ * domain and domain of each layout in the order they were intersected, so
+ * different views of the same arrays find the same entry.
+ *
+ * The cache observes the data of the base layouts of its entries and
+ * drops every entry involving a layout that is repartitioned or
+ * destroyed.  The cache is cleared when it grows beyond maxEntries.
+ *
+ * Layouts may be destroyed on any thread, so the cache is guarded by a
+ * mutex.  Entries and observers are destroyed after the mutex has been
+ * released.
+ */
+
+template<int Dim>
+class IntersectionCache
+{
+public:
+
+  //===========================================================================
+  // Exported typedefs and constants
+  //===========================================================================
+
+  typedef std::vector<int>                              Key_t;
+  typedef RefCountedPtr<IntersectorData<Dim> >          Data_t;
+  typedef IntersectionLayoutBase<Dim>                   Layout_t;
+
+  enum { maxEntries = 256 };
+
+  //===========================================================================
+  // Constructors and destructor
+  //===========================================================================
+
+  IntersectionCache() { }
+
+  ~IntersectionCache() { }
+
+  //===========================================================================
+  // Accessors
+  //===========================================================================
+
+  // The cache shared by all IntersectorData<Dim>.
+
+  static IntersectionCache<Dim> &cache() { return cache_s; }
+
+  // Return the cached intersection for key, or an invalid pointer.
+
+  Data_t find(const Key_t &key) const
+  {
+    Data_t data;
+    mutex_m.lock();
+    typename Entries_t::const_iterator p = entries_m.find(key);
+    if (p != entries_m.end())
+      data = p->second;
+    mutex_m.unlock();
+    return data;
+  }
+
+  int size() const
+  {
+    mutex_m.lock();
+    int n = entries_m.size();
+    mutex_m.unlock();
+    return n;
+  }
+
+  // The number of base layouts the cache observes.
+
+  int layouts() const
+  {
+    mutex_m.lock();
+    int n = observers_m.size();
+    mutex_m.unlock();
+    return n;
+  }
+
+  //===========================================================================
+  // Modifiers
+  //===========================================================================
+
+  // Remember data as the result of intersecting the n layouts and watch
+  // the base layouts for changes.
+
+  void insert(const Key_t &key, const Data_t &data,
+	      const Layout_t *const *layouts, int n)
+  {
+    Entries_t entries;
+    Observers_t observers;
+
+    mutex_m.lock();
+
+    if (entries_m.size() >= maxEntries)
+    {
+      entries.swap(entries_m);
+      observers.swap(observers_m);
+    }
+
+    for (int i = 0; i < n; ++i)
+    {
+      int id = data->baseIDs_m[i];
+      if (observers_m.find(id) == observers_m.end())
+	observers_m[id] = Observer_t(layouts[i]->observer(*this));
+    }
+
+    entries_m[key] = data;
+
+    mutex_m.unlock();
+  }
+
+  // Forget the intersections with the layout that has the given base ID.
+
+  void invalidate(int baseID)
+  {
+    Entries_t entries;
+
+    mutex_m.lock();
+    erase(baseID, entries);
+    mutex_m.unlock();
+  }
+
+  // Forget the intersections with the layout that has the given base ID
+  // and stop observing it, because its data is going away.
+
+  void forget(int baseID)
+  {
+    Entries_t entries;
+    Observer_t observer;
+
+    mutex_m.lock();
+    erase(baseID, entries);
+    typename Observers_t::iterator p = observers_m.find(baseID);
+    if (p != observers_m.end())
+    {
+      observer = p->second;
+      observers_m.erase(p);
+    }
+    mutex_m.unlock();
+  }
+
+  // Forget everything.
+
+  void clear()
+  {
+    Entries_t entries;
+    Observers_t observers;
+
+    mutex_m.lock();
+    entries.swap(entries_m);
+    observers.swap(observers_m);
+    mutex_m.unlock();
+  }
+
+private:
+
+  typedef RefCountedPtr<IntersectionCacheObserverBase<Dim> > Observer_t;
+  typedef std::map<Key_t, Data_t>                             Entries_t;
+  typedef std::map<int, Observer_t>                           Observers_t;
+
+  // Move the entries involving baseID to erased.  The mutex is held.
+
+  void erase(int baseID, Entries_t &erased)
+  {
+    typename Entries_t::iterator p = entries_m.begin();
+    while (p != entries_m.end())
+    {
+      const std::vector<int> &ids = p->second->baseIDs_m;
+      if (std::find(ids.begin(), ids.end(), baseID) != ids.end())
+      {
+	erased.insert(*p);
+	entries_m.erase(p++);
+      }
+      else
+	++p;
+    }
+  }
+
+  Entries_t entries_m;
+  Observers_t observers_m;
+  mutable Pooma::Mutex_t mutex_m;
+
+  static IntersectionCache<Dim> cache_s;
+};
+
+template<int Dim>
+IntersectionCache<Dim> IntersectionCache<Dim>::cache_s;
+
+
+#endif // POOMA_ENGINE_INTERSECTIONCACHE_H
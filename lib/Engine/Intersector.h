@@ -25,6 +25,8 @@
  *    class for managing intersections of engines.
  *  - IntersectEngineTag
  *    a functor for intersecting UMP engines inside an expression
+ *  - GuardFill
+ *    a guard fill put off until the interiors of the patches are handed off
  */
 
 #ifndef POOMA_ENGINE_INTERSECTOR_H
@@ -42,14 +44,56 @@
 #include "Layout/GlobalIDDataBase.h"
 #include "Layout/GuardLayers.h"
 #include "Layout/TouchesConstruct.h"
+#include "Engine/IntersectionCache.h"
+#include "Pooma/Pooma.h"
 
 #include <vector>
+#include <new>
 
 
 //-----------------------------------------------------------------------------
 // Forward declaratations
 //-----------------------------------------------------------------------------
 
+/**
+ * GuardFillBase is a guard fill that an IntersectorData has put off
+ * until the interiors of the patches have been handed off (see
+ * IntersectorData::fillGuards()).  GuardFill<Engine, Dim> keeps the engine
+ * and the guard layers to fill.
+ */
+
+class GuardFillBase
+  : public RefCounted
+{
+public:
+
+  virtual ~GuardFillBase() { }
+
+  virtual void fill() const = 0;
+};
+
+template<class Engine, int Dim>
+class GuardFill
+  : public GuardFillBase
+{
+public:
+
+  GuardFill(const Engine &engine, const GuardLayers<Dim> &guards)
+    : engine_m(engine), guards_m(guards)
+  { }
+
+  virtual void fill() const
+  {
+    engine_m.fillGuards(guards_m);
+  }
+
+private:
+
+  Engine engine_m;
+  GuardLayers<Dim> guards_m;
+};
+
+
 template<int Dim>
 class IntersectorData
   : public RefCounted
@@ -68,6 +112,8 @@ public:
   typedef std::vector<INode_t>                          INodeContainer_t;
   typedef typename INodeContainer_t::const_iterator     const_iterator;
   typedef Unique::Value_t                               LayoutID_t;
+  typedef IntersectionCache<Dim>                        Cache_t;
+  typedef RefCountedPtr<GuardFillBase>                  GuardFill_t;
   
   enum { dimensions = Dim };
   
@@ -78,15 +124,19 @@ public:
 
   // Default constructor is trival.
   
-  inline IntersectorData() { }
+  inline IntersectorData()
+    : touched_m(0), resolved_m(false), npending_m(0), pendingUsed_m(0),
+      deferGuards_m(false), shellGuards_m(0)
+  { }
 
   //===========================================================================
   // Destructor
   //===========================================================================
 
-  // Trival since members manage their own data.
+  // Destroy the layouts that are still pending; the other members manage
+  // their own data.
   
-  inline ~IntersectorData() { }
+  inline ~IntersectorData() { clearPending(); }
   
   template<class Engine>
   void intersect(const Engine &engine) 
@@ -305,10 +355,46 @@ public:
         Range<1>(domain[j].first(), domain[j].last(), domain[j].stride());
   }
   
+  // Add the base ID, base domain and domain of a layout to the key for
+  // the intersection cache.
+
+  template<class Layout>
+  void pushKey(const Layout &l)
+  {
+    int j;
+    key_m.push_back(l.baseID());
+    key_m.push_back(baseDims_m.back());
+    for (j = 0; j < baseDims_m.back(); j++)
+    {
+      key_m.push_back(baseDomains_m.back()[j].first());
+      key_m.push_back(baseDomains_m.back()[j].last());
+      key_m.push_back(baseDomains_m.back()[j].stride());
+    }
+    for (j = 0; j < Dim; j++)
+    {
+      key_m.push_back(l.domain()[j].first());
+      key_m.push_back(l.domain()[j].last());
+    }
+  }
+
+  // Record a layout that contributes unique intersections.  The INodes
+  // are not computed until they are asked for (see resolve()), since the
+  // intersection cache may already know them.  The layout is kept in
+  // pendingBuffer_m until then; if there is no room left, the layouts
+  // recorded so far are resolved, so their intersection can still come
+  // from the cache, and this one is intersected right away.
+
   template<class Layout>
   void touches(const Layout &l)
   {
-    int n = ids_m.size();
+    typedef IntersectionLayout<Dim, Layout> Pending_t;
+    enum { bytes = (sizeof(Pending_t) + pendingAlign - 1) / pendingAlign
+	   * pendingAlign };
+    CTAssert(alignof(Pending_t) <= pendingAlign);
+
+    if (!resolved_m && (npending_m == maxPending ||
+			pendingUsed_m + bytes > pendingBytes))
+      resolve();
 
     // This is a new layout that will contribute unique intersections, save
     // the data.
@@ -317,6 +403,36 @@ public:
     baseIDs_m.push_back(l.baseID());
     pushBaseDomain(l.baseDomain());
 
+    if (resolved_m)
+    {
+      touchesNodes(l);
+    }
+    else
+    {
+      pushKey(l);
+      pending_m[npending_m++] =
+	new (pendingBuffer_m.bytes_m + pendingUsed_m) Pending_t(l);
+      pendingUsed_m += bytes;
+    }
+  }
+
+  // Destroy the pending layouts.
+
+  void clearPending()
+  {
+    for (int i = 0; i < npending_m; ++i)
+      pending_m[i]->~Layout_t();
+    npending_m = 0;
+    pendingUsed_m = 0;
+  }
+
+  // Intersect our INodes with the layout.
+
+  template<class Layout>
+  void touchesNodes(const Layout &l)
+  {
+    int n = touched_m++;
+
     // If we previously had no layouts stored, we simply need to fill our list
     // with INodes constructed using the nodes from the iterators.
     // If this is the second (or later) layout we're being asked to intersect,
@@ -357,6 +473,182 @@ public:
     gidStore_m.shared(id1,id2);
   }
 
+  // Fill the guard layers of a multi-patch engine the expression reads.
+  // If deferGuards() is set, the fills of dirty engines are kept until
+  // fillDeferred(), and shellGuards() grows to cover the layers they
+  // fill.  Engines of other dimensions are filled right away.
+
+  template<class Engine>
+  void fillGuards(const Engine &engine, const GuardLayers<Dim> &usedGuards)
+  {
+    if (!deferGuards_m || !engine.isDirty())
+    {
+      engine.fillGuards(usedGuards);
+      return;
+    }
+
+    for (int d = 0; d < Dim; ++d)
+    {
+      shellGuards_m.lower(d) =
+	std::max(shellGuards_m.lower(d), usedGuards.lower(d));
+      shellGuards_m.upper(d) =
+	std::max(shellGuards_m.upper(d), usedGuards.upper(d));
+    }
+    deferred_m.push_back(GuardFill_t(new GuardFill<Engine, Dim>(engine,
+							       usedGuards)));
+  }
+
+  template<class Engine, int Dim2>
+  void fillGuards(const Engine &engine, const GuardLayers<Dim2> &usedGuards)
+  {
+    engine.fillGuards(usedGuards);
+  }
+
+  inline void deferGuards(bool on) { deferGuards_m = on; }
+
+  inline bool deferGuards() const { return deferGuards_m; }
+
+  // The number of guard fills waiting, and the guard layers they fill.
+
+  inline int deferred() const { return deferred_m.size(); }
+
+  inline const GuardLayers<Dim> &shellGuards() const { return shellGuards_m; }
+
+  // Do the guard fills that fillGuards() put off.
+
+  void fillDeferred()
+  {
+    int n = deferred_m.size();
+    for (int i = 0; i < n; ++i)
+      deferred_m[i]->fill();
+    deferred_m.clear();
+  }
+
+  // Split each INode into its interior, which reads none of the guard
+  // layers of the deferred fills, and the slabs of the shell around the
+  // interior.  Since views may be strided or reversed, the shell is as
+  // wide as the wider of shellGuards() on both sides.
+
+  void shells(INodeContainer_t &interiors, INodeContainer_t &shells)
+  {
+    typedef typename INode_t::Domain_t Domain_t;
+
+    resolve();
+
+    int ni = inodes_m.size();
+    for (int i = 0; i < ni; ++i)
+    {
+      Domain_t rest = inodes_m[i].domain();
+      bool empty = false;
+      for (int d = 0; d < Dim && !empty; ++d)
+      {
+	int w = std::max(shellGuards_m.lower(d), shellGuards_m.upper(d));
+	int first = rest[d].first(), last = rest[d].last();
+	int lo = std::min(first + w, last + 1);
+	int hi = std::max(last - w, lo - 1);
+
+	Domain_t slab = rest;
+	if (lo > first)
+	{
+	  slab[d] = Interval<1>(first, lo - 1);
+	  shells.push_back(INode_t(inodes_m[i], slab));
+	}
+	if (hi < last)
+	{
+	  slab[d] = Interval<1>(hi + 1, last);
+	  shells.push_back(INode_t(inodes_m[i], slab));
+	}
+
+	empty = hi < lo;
+	if (!empty)
+	  rest[d] = Interval<1>(lo, hi);
+      }
+
+      if (!empty)
+	interiors.push_back(INode_t(inodes_m[i], rest));
+    }
+  }
+
+  // Compute the INodes for the layouts recorded by touches(), or copy them
+  // from the intersection cache if the same layouts have been intersected
+  // before.  Layouts touched afterwards are intersected right away.
+
+  void resolve()
+  {
+    if (resolved_m)
+      return;
+    resolved_m = true;
+
+    int n = npending_m;
+    if (n == 0)
+      return;
+
+    if (Pooma::intersectionCache())
+    {
+      typename Cache_t::Data_t cached = Cache_t::cache().find(key_m);
+      if (cached.isValid())
+      {
+	POOMA_INCREMENT_STATISTIC(NumIntersectionCacheHits)
+	copyINodes(*cached);
+      }
+      else
+      {
+	POOMA_INCREMENT_STATISTIC(NumIntersectionCacheMisses)
+	for (int i = 0; i < n; ++i)
+	  pending_m[i]->touches(*this);
+
+	typename Cache_t::Data_t data(new This_t());
+	data->ids_m = ids_m;
+	data->baseIDs_m = baseIDs_m;
+	data->baseDims_m = baseDims_m;
+	data->baseDomains_m = baseDomains_m;
+	data->resolved_m = true;
+	data->copyINodes(*this);
+	Cache_t::cache().insert(key_m, data, pending_m, n);
+      }
+    }
+    else
+    {
+      for (int i = 0; i < n; ++i)
+	pending_m[i]->touches(*this);
+    }
+
+    clearPending();
+    key_m.clear();
+  }
+
+  // Replace our INodes with those of an intersection of the same layouts,
+  // renaming the layout IDs of model to ours.
+
+  void copyINodes(const This_t &model)
+  {
+    PAssert(model.ids_m.size() == ids_m.size());
+
+    gidStore_m.copyNodes(model.gidStore_m, model.ids_m, ids_m);
+
+    int ni = model.inodes_m.size();
+    inodes_m.clear();
+    inodes_m.reserve(ni);
+    for (int i = 0; i < ni; i++)
+      inodes_m.push_back(INode_t(model.inodes_m[i], &gidStore_m));
+    touched_m = model.touched_m;
+  }
+
+  // STL iterator support.
+
+  inline const_iterator begin() { resolve(); return inodes_m.begin(); }
+
+  inline const_iterator end() { resolve(); return inodes_m.end(); }
+
+  inline int size() { resolve(); return inodes_m.size(); }
+
+  // The IDs and base IDs of the layouts that were intersected, in the
+  // order they were seen; the first one is that of the left hand side.
+
+  inline const IDContainer_t &ids() const { return ids_m; }
+
+  inline const IDContainer_t &baseIDs() const { return baseIDs_m; }
+
   //private:  
 
   // Don't ever want to copy one of these.
@@ -371,6 +663,36 @@ public:
   BaseDomainContainer_t baseDomains_m;
   INodeContainer_t inodes_m;
   GlobalIDDataBase gidStore_m;
+
+  // The number of layouts intersected with inodes_m, and whether layouts
+  // are still waiting in pending_m.
+
+  int touched_m;
+  bool resolved_m;
+
+  // The layouts to intersect, built in pendingBuffer_m, and their key
+  // for the intersection cache.
+
+  typedef typename Cache_t::Layout_t Layout_t;
+
+  enum { maxPending = 16, pendingBytes = 1024,
+	 pendingAlign = alignof(long double) };
+
+  Layout_t *pending_m[maxPending];
+  int npending_m, pendingUsed_m;
+  union
+  {
+    char bytes_m[pendingBytes];
+    long double align_m;
+  } pendingBuffer_m;
+  typename Cache_t::Key_t key_m;
+
+  // Whether guard fills are put off, the fills waiting and the widest
+  // guard layers they fill.
+
+  bool deferGuards_m;
+  std::vector<GuardFill_t> deferred_m;
+  GuardLayers<Dim> shellGuards_m;
   
 };
 
@@ -423,11 +745,11 @@ public:
 
   // STL iterator support.
   
-  inline const_iterator begin() const { return data()->inodes_m.begin(); }
+  inline const_iterator begin() const { return data()->begin(); }
   
-  inline const_iterator end() const { return data()->inodes_m.end(); }
+  inline const_iterator end() const { return data()->end(); }
 
-  inline int size() const { return data()->inodes_m.size(); }
+  inline int size() const { return data()->size(); }
 
   //===========================================================================
   // Intersect routines
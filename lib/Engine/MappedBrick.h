@@ -0,0 +1,664 @@
+// -*- C++ -*-
+//
+// Copyright (C) 1998, 1999, 2000, 2002  Los Alamos National Laboratory,
+// Copyright (C) 1998, 1999, 2000, 2002  CodeSourcery, LLC
+//
+// This file is part of FreePOOMA.
+//
+// FreePOOMA is free software; you can redistribute it and/or modify it
+// under the terms of the Expat license.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the Expat
+// license for more details.
+//
+// You should have received a copy of the Expat license along with
+// FreePOOMA; see the file LICENSE.
+//
+
+
+/** @file
+ * @ingroup Engine
+ * @brief
+ * MappedBrick engine: a brick whose elements live in a memory-mapped
+ * file, for arrays larger than memory.
+ *
+ * Classes:
+ *  - MappedBrick & MappedBrickView, specialization tags.
+ *  - Pooma::MappedBrickBase<Dim,T,BrickTag>, element access shared by
+ *    the two engines.
+ *  - Engine<Dim,T,MappedBrick>, the "MappedBrick-Engine" specialization.
+ *  - Engine<Dim,T,MappedBrickView>, the "MappedBrickView-Engine"
+ *    specialization.
+ *  - NewEngine<Engine,SubDomain>, specializations for
+ *    MappedBrickView-Engine.
+ *
+ * Functions:
+ *  - flush(), write the elements back to the file.
+ */
+
+#ifndef POOMA_ENGINE_MAPPEDBRICK_H
+#define POOMA_ENGINE_MAPPEDBRICK_H
+
+//-----------------------------------------------------------------------------
+// Includes:
+//-----------------------------------------------------------------------------
+
+#include "Domain/Domain.h"
+#include "Domain/Interval.h"
+#include "Domain/Loc.h"
+#include "Domain/Range.h"
+#include "Domain/SliceInterval.h"
+#include "Domain/SliceRange.h"
+#include "Engine/BrickEngine.h"
+#include "Engine/Engine.h"
+#include "Layout/DomainLayout.h"
+#include "Layout/Node.h"
+#include "Layout/INode.h"
+#include "Utilities/ElementProperties.h"
+#include "Utilities/MappedFile.h"
+#include "Utilities/PAssert.h"
+#include "Utilities/RefCountedPtr.h"
+#include <algorithm>
+#include <string>
+
+
+///////////////////////////////////////////////////////////////////////////////
+// namespace Pooma {
+
+/**
+ * These are the tag classes used to select the "MappedBrick" and
+ * "MappedBrickView" specializations of the Engine class template.
+ */
+
+struct MappedBrick { };
+
+struct MappedBrickView { };
+
+
+namespace Pooma {
+
+/**
+ * MappedBrickBase<Dim,T,BrickTag> holds the MappedFile and the
+ * Engine<Dim,T,BrickTag> on its data, and does the element access for
+ * MappedBrick and MappedBrickView.  The engines keep a reference to the
+ * file, so it stays mapped as long as any view of it is alive.
+ */
+
+template <int Dim, class T, class BrickTag>
+class MappedBrickBase
+{
+public:
+
+  //============================================================
+  // Exported typedefs and constants
+  //============================================================
+
+  typedef Engine<Dim,T,BrickTag>                    Brick_t;
+  typedef RefCountedPtr<MappedFile>                 File_t;
+  typedef typename Brick_t::Domain_t                Domain_t;
+  typedef DomainLayout<Dim>                         Layout_t;
+  typedef T                                         Element_t;
+  typedef T&                                        ElementRef_t;
+
+  //============================================================
+  // Constructors
+  //============================================================
+
+  MappedBrickBase() { }
+
+  MappedBrickBase(const File_t &file, const Brick_t &brick)
+    : file_m(file), brick_m(brick)
+  { }
+
+  //============================================================
+  // Accessor functions
+  //============================================================
+
+  //@{
+
+  /// Element access via Loc.
+
+  Element_t read(const Loc<Dim> &loc) const
+  {
+    return brick_m.read(loc);
+  }
+  ElementRef_t operator()(const Loc<Dim> &loc) const
+  {
+    return brick_m(loc);
+  }
+
+  //@}
+
+  //@{
+
+  /// Element access via ints for speed.
+
+  Element_t read(int i1) const
+  {
+    return brick_m.read(i1);
+  }
+  Element_t read(int i1, int i2) const
+  {
+    return brick_m.read(i1,i2);
+  }
+  Element_t read(int i1, int i2, int i3) const
+  {
+    return brick_m.read(i1,i2,i3);
+  }
+  Element_t read(int i1, int i2, int i3, int i4) const
+  {
+    return brick_m.read(i1,i2,i3,i4);
+  }
+  Element_t read(int i1, int i2, int i3, int i4, int i5) const
+  {
+    return brick_m.read(i1,i2,i3,i4,i5);
+  }
+  Element_t read(int i1, int i2, int i3, int i4, int i5, int i6) const
+  {
+    return brick_m.read(i1,i2,i3,i4,i5,i6);
+  }
+  Element_t read(int i1, int i2, int i3, int i4, int i5, int i6, int i7) const
+  {
+    return brick_m.read(i1,i2,i3,i4,i5,i6,i7);
+  }
+
+  ElementRef_t operator()(int i1) const
+  {
+    return brick_m(i1);
+  }
+  ElementRef_t operator()(int i1, int i2) const
+  {
+    return brick_m(i1,i2);
+  }
+  ElementRef_t operator()(int i1, int i2, int i3) const
+  {
+    return brick_m(i1,i2,i3);
+  }
+  ElementRef_t operator()(int i1, int i2, int i3, int i4) const
+  {
+    return brick_m(i1,i2,i3,i4);
+  }
+  ElementRef_t operator()(int i1, int i2, int i3, int i4, int i5) const
+  {
+    return brick_m(i1,i2,i3,i4,i5);
+  }
+  ElementRef_t operator()(int i1, int i2, int i3, int i4, int i5, int i6) const
+  {
+    return brick_m(i1,i2,i3,i4,i5,i6);
+  }
+  ElementRef_t operator()(int i1, int i2, int i3, int i4, int i5, int i6,
+			  int i7) const
+  {
+    return brick_m(i1,i2,i3,i4,i5,i6,i7);
+  }
+
+  //@}
+
+  /// Return the domain.
+
+  const Domain_t &domain() const { return brick_m.domain(); }
+
+  /// Return a layout.
+
+  Layout_t layout() const { return Layout_t(domain()); }
+
+  /// Return the Brick or BrickView on the mapped data.
+
+  const Brick_t &brick() const { return brick_m; }
+
+  /// Return the mapped file.
+
+  const File_t &file() const { return file_m; }
+
+  /// Write the whole mapped file back, not just the part this engine
+  /// views.
+
+  void flush() const
+  {
+    if (file_m.isValid())
+      file_m->flush();
+  }
+
+  /// Provide access to the data object.
+
+  Pooma::DataObject_t *dataObject() const { return brick_m.dataObject(); }
+
+protected:
+
+  File_t file_m;
+  Brick_t brick_m;
+};
+
+} // namespace Pooma
+
+
+/**
+ * Engine<Dim,T,MappedBrick> (aka MappedBrick-Engine)
+ *
+ * Engine<Dim,T,MappedBrick> is an Engine for a local, Dim-dimensional
+ * brick of elements of type T, laid out like a Brick, that are kept in a
+ * file mapped into memory with MAP_SHARED.  The system reads pages in as
+ * they are touched and writes them back when it needs the memory, so
+ * the brick can be much larger than memory; expressions run over it in
+ * storage order, which the mapping is advised to expect.
+ *
+ * Template Parameters:
+ *  - Dim: An integer for the dimension of the brick.
+ *  - T:   The element type, which must be a type that can be copied
+ *         byte by byte, like a double or a Vector of them.
+ *
+ * The Domain of this engine is an Interval<Dim>.  Engines made from a
+ * domain, Node or layout, as the patches of MultiPatch engines are, map
+ * scratch files in Pooma::mappedDirectory() (--pooma-mapped-dir), which
+ * start out zero and are removed when the last engine on them goes.  An
+ * engine can also be made on a named file, which keeps its contents.
+ * Changes reach the file when flush() is called, and in any case once
+ * the last engine on it is gone.
+ *
+ * Subsetting Engine<Dim,T,MappedBrick> returns an
+ * Engine<Dim,T,MappedBrickView>.
+ */
+
+template <int Dim, class T>
+class Engine<Dim,T,MappedBrick>
+  : public Pooma::MappedBrickBase<Dim,T,Brick>
+{
+public:
+
+  //============================================================
+  // Exported typedefs and constants
+  //============================================================
+
+  typedef Engine<Dim,T,MappedBrick>                 This_t;
+  typedef Engine<Dim,T,MappedBrick>                 Engine_t;
+  typedef Pooma::MappedBrickBase<Dim,T,Brick>       Base_t;
+  typedef typename Base_t::Brick_t                  Brick_t;
+  typedef typename Base_t::File_t                   File_t;
+  typedef typename Base_t::Domain_t                 Domain_t;
+  typedef typename Base_t::Layout_t                 Layout_t;
+  typedef typename Base_t::Element_t                Element_t;
+  typedef typename Base_t::ElementRef_t             ElementRef_t;
+  typedef MappedBrick                               Tag_t;
+
+  enum { dimensions    = Dim   };
+  enum { hasDataObject = true  };
+  enum { dynamic       = false };
+  enum { zeroBased     = false };
+  enum { multiPatch    = false };
+
+  //============================================================
+  // Constructors and Factory Methods
+  //============================================================
+
+  /// Default constructor.  Creates a MappedBrick-Engine with no data.
+
+  Engine() { }
+
+  //@{
+
+  /// Map a scratch file for the domain, given directly or through a
+  /// Node or Layout_t object.  The second version initializes the
+  /// elements with a model.
+
+  explicit Engine(const Domain_t &domain)
+  {
+    init(new MappedFile(bytes(domain)), domain);
+  }
+
+  Engine(const Domain_t &domain, const T &elementModel)
+  {
+    init(new MappedFile(bytes(domain)), domain);
+    std::fill(data(), data() + domain.size(), elementModel);
+  }
+
+  explicit Engine(const Layout_t &layout)
+  {
+    init(new MappedFile(bytes(layout.domain())), layout.domain());
+  }
+
+  explicit Engine(const Node<Domain_t> &node)
+  {
+    init(new MappedFile(bytes(node.allocated())), node.allocated());
+  }
+
+  //@}
+
+  /// Map the named file for the domain.  The file is created or
+  /// extended as needed, and its contents are the elements in storage
+  /// order.
+
+  Engine(const std::string &name, const Domain_t &domain)
+  {
+    init(new MappedFile(name, bytes(domain)), domain);
+  }
+
+  /// Copy constructor performs a SHALLOW copy.
+
+  Engine(const Engine_t &model)
+    : Base_t(model)
+  { }
+
+  //============================================================
+  // Assignment operators
+  //============================================================
+
+  /// Assigment is SHALLOW, to be consistent with copy.
+
+  Engine_t &operator=(const Engine_t &model)
+  {
+    this->file_m = model.file_m;
+    this->brick_m = model.brick_m;
+    return *this;
+  }
+
+  //============================================================
+  // Accessor and Mutator functions:
+  //============================================================
+
+  /// Get a private copy of the data viewed by this Engine.  The copy is
+  /// in a new scratch file, even if the data was in a named one.
+
+  Engine_t &makeOwnCopy()
+  {
+    if (this->file_m.isValid() && this->file_m.isShared())
+      {
+	T *old = data();
+	File_t file = this->file_m;
+	init(new MappedFile(file->size()), this->domain());
+	std::copy(old, old + this->domain().size(), data());
+      }
+    return *this;
+  }
+
+private:
+
+  /// The number of bytes of file for the domain.
+
+  static size_t bytes(const Domain_t &domain)
+  {
+    return domain.size() * sizeof(T);
+  }
+
+  /// The start of the elements.
+
+  T *data() const { return static_cast<T *>(this->file_m->data()); }
+
+  /// Take over the file and make the Brick on its data.
+
+  void init(MappedFile *file, const Domain_t &domain)
+  {
+    this->file_m = File_t(file);
+    this->brick_m = Brick_t(data(), domain);
+  }
+};
+
+
+/**
+ * Engine<Dim,T,MappedBrickView> (aka MappedBrickView-Engine)
+ *
+ * A MappedBrickView-Engine is a view of a MappedBrick-Engine.  Its
+ * elements are viewed by an Engine<Dim,T,BrickView>, so, as for
+ * BrickViews, its domain is zero-based.
+ */
+
+template <int Dim, class T>
+class Engine<Dim,T,MappedBrickView>
+  : public Pooma::MappedBrickBase<Dim,T,BrickView>
+{
+public:
+
+  //============================================================
+  // Exported typedefs and constants
+  //============================================================
+
+  typedef Engine<Dim,T,MappedBrickView>             This_t;
+  typedef Engine<Dim,T,MappedBrickView>             Engine_t;
+  typedef Pooma::MappedBrickBase<Dim,T,BrickView>   Base_t;
+  typedef typename Base_t::Brick_t                  Brick_t;
+  typedef typename Base_t::File_t                   File_t;
+  typedef typename Base_t::Domain_t                 Domain_t;
+  typedef typename Base_t::Layout_t                 Layout_t;
+  typedef typename Base_t::Element_t                Element_t;
+  typedef typename Base_t::ElementRef_t             ElementRef_t;
+  typedef MappedBrickView                           Tag_t;
+
+  enum { dimensions    = Dim   };
+  enum { hasDataObject = true  };
+  enum { dynamic       = false };
+  enum { zeroBased     = true  };
+  enum { multiPatch    = false };
+
+  //============================================================
+  // Constructors
+  //============================================================
+
+  /// Default constructor is required for containers.
+
+  Engine() { }
+
+  //@{
+
+  /// Copy constructors perform a SHALLOW copy.  The second is used for
+  /// the patches of MultiPatch views.
+
+  Engine(const Engine_t &model)
+    : Base_t(model)
+  { }
+
+  Engine(const Engine_t &model, const EngineConstructTag &)
+    : Base_t(model)
+  { }
+
+  //@}
+
+  //@{
+
+  /// Subsetting constructors.  The brick is viewed with the domain,
+  /// which is an Interval<Dim> or a Range<Dim>, or a slice.
+
+  template <class ETag, class DT>
+  Engine(const Engine<Dim,T,ETag> &e, const Domain<Dim, DT> &dom)
+    : Base_t(e.file(), Brick_t(e.brick(), dom))
+  { }
+
+  template <int Dim2, class ETag>
+  Engine(const Engine<Dim2,T,ETag> &e, const SliceRange<Dim2,Dim> &dom)
+    : Base_t(e.file(), Brick_t(e.brick(), dom))
+  { }
+
+  template <int Dim2, class ETag>
+  Engine(const Engine<Dim2,T,ETag> &e, const SliceInterval<Dim2,Dim> &dom)
+    : Base_t(e.file(), Brick_t(e.brick(), dom))
+  { }
+
+  //@}
+
+  //============================================================
+  // Assignment operators
+  //============================================================
+
+  Engine_t &operator=(const Engine_t &model)
+  {
+    this->file_m = model.file_m;
+    this->brick_m = model.brick_m;
+    return *this;
+  }
+};
+
+
+/**
+ * NewEngine<Engine,SubDomain>
+ *
+ * Views of MappedBrick and MappedBrickView engines are MappedBrickViews.
+ */
+
+template <int Dim, class T>
+struct NewEngine<Engine<Dim,T,MappedBrick>, Interval<Dim> >
+{
+  typedef Engine<Dim,T,MappedBrickView> Type_t;
+};
+
+template <int Dim, class T>
+struct NewEngine<Engine<Dim,T,MappedBrick>, Range<Dim> >
+{
+  typedef Engine<Dim,T,MappedBrickView> Type_t;
+};
+
+template <int Dim, class T>
+struct NewEngine<Engine<Dim,T,MappedBrick>, Node<Interval<Dim> > >
+{
+  typedef Engine<Dim,T,MappedBrickView> Type_t;
+};
+
+template <int Dim, class T>
+struct NewEngine<Engine<Dim,T,MappedBrick>, INode<Dim> >
+{
+  typedef Engine<Dim,T,MappedBrickView> Type_t;
+};
+
+template <int Dim, class T, int SliceDim>
+struct NewEngine<Engine<Dim,T,MappedBrick>, SliceInterval<Dim,SliceDim> >
+{
+  typedef Engine<SliceDim,T,MappedBrickView> Type_t;
+};
+
+template <int Dim, class T, int SliceDim>
+struct NewEngine<Engine<Dim,T,MappedBrick>, SliceRange<Dim,SliceDim> >
+{
+  typedef Engine<SliceDim,T,MappedBrickView> Type_t;
+};
+
+template <int Dim, class T>
+struct NewEngine<Engine<Dim,T,MappedBrickView>, Interval<Dim> >
+{
+  typedef Engine<Dim,T,MappedBrickView> Type_t;
+};
+
+template <int Dim, class T>
+struct NewEngine<Engine<Dim,T,MappedBrickView>, Range<Dim> >
+{
+  typedef Engine<Dim,T,MappedBrickView> Type_t;
+};
+
+template <int Dim, class T>
+struct NewEngine<Engine<Dim,T,MappedBrickView>, Node<Interval<Dim> > >
+{
+  typedef Engine<Dim,T,MappedBrickView> Type_t;
+};
+
+template <int Dim, class T>
+struct NewEngine<Engine<Dim,T,MappedBrickView>, INode<Dim> >
+{
+  typedef Engine<Dim,T,MappedBrickView> Type_t;
+};
+
+template <int Dim, class T, int SliceDim>
+struct NewEngine<Engine<Dim,T,MappedBrickView>, SliceInterval<Dim,SliceDim> >
+{
+  typedef Engine<SliceDim,T,MappedBrickView> Type_t;
+};
+
+template <int Dim, class T, int SliceDim>
+struct NewEngine<Engine<Dim,T,MappedBrickView>, SliceRange<Dim,SliceDim> >
+{
+  typedef Engine<SliceDim,T,MappedBrickView> Type_t;
+};
+
+
+/**
+ * NewEngineDomain<Engine,SubDomain>
+ *
+ * Views through Nodes and INodes are taken with their domains.
+ */
+
+template <int Dim, class T>
+struct NewEngineDomain<Engine<Dim,T,MappedBrick>, Node<Interval<Dim> > >
+{
+  typedef Interval<Dim> Type_t;
+  typedef const Interval<Dim> &Return_t;
+  static inline
+  Return_t apply(const Engine<Dim,T,MappedBrick> &,
+		 const Node<Interval<Dim> > &node)
+  {
+    return node.domain();
+  }
+};
+
+template <int Dim, class T>
+struct NewEngineDomain<Engine<Dim,T,MappedBrick>, INode<Dim> >
+{
+  typedef Interval<Dim> Type_t;
+  typedef const Interval<Dim> &Return_t;
+  static inline
+  Return_t apply(const Engine<Dim,T,MappedBrick> &,
+		 const INode<Dim> &inode)
+  {
+    return inode.domain();
+  }
+};
+
+template <int Dim, class T>
+struct NewEngineDomain<Engine<Dim,T,MappedBrickView>, Node<Interval<Dim> > >
+{
+  typedef Interval<Dim> Type_t;
+  typedef const Interval<Dim> &Return_t;
+  static inline
+  Return_t apply(const Engine<Dim,T,MappedBrickView> &,
+		 const Node<Interval<Dim> > &node)
+  {
+    return node.domain();
+  }
+};
+
+template <int Dim, class T>
+struct NewEngineDomain<Engine<Dim,T,MappedBrickView>, INode<Dim> >
+{
+  typedef Interval<Dim> Type_t;
+  typedef const Interval<Dim> &Return_t;
+  static inline
+  Return_t apply(const Engine<Dim,T,MappedBrickView> &,
+		 const INode<Dim> &inode)
+  {
+    return inode.domain();
+  }
+};
+
+
+/**
+ * Traits class telling RefCountedBlockPointer that this class has
+ * shallow semantics and a makeOwnCopy method.
+ */
+
+template <int Dim, class T>
+struct ElementProperties<Engine<Dim, T, MappedBrick> >
+  : public MakeOwnCopyProperties<Engine<Dim, T, MappedBrick> >
+{ };
+
+
+//-----------------------------------------------------------------------------
+//
+// void flush()
+//
+// Write the elements back to the mapped file.  This does not wait for
+// pending expressions; use flush() on the Array for that.
+//
+//-----------------------------------------------------------------------------
+
+template <int Dim, class T>
+inline void flush(const Engine<Dim, T, MappedBrick> &e)
+{
+  e.flush();
+}
+
+template <int Dim, class T>
+inline void flush(const Engine<Dim, T, MappedBrickView> &e)
+{
+  e.flush();
+}
+
+// } // namespace Pooma
+///////////////////////////////////////////////////////////////////////////////
+
+#endif // POOMA_ENGINE_MAPPEDBRICK_H
@@ -0,0 +1,688 @@
+// -*- C++ -*-
+//
+// Copyright (C) 1998, 1999, 2000, 2002  Los Alamos National Laboratory,
+// Copyright (C) 1998, 1999, 2000, 2002  CodeSourcery, LLC
+//
+// This file is part of FreePOOMA.
+//
+// FreePOOMA is free software; you can redistribute it and/or modify it
+// under the terms of the Expat license.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the Expat
+// license for more details.
+//
+// You should have received a copy of the Expat license along with
+// FreePOOMA; see the file LICENSE.
+//
+
+
+/** @file
+ * @ingroup Engine
+ * @brief
+ * MixedPrecisionBrick engine: a brick that stores its elements with a
+ * narrower type than the one it computes with.
+ *
+ * Classes:
+ *  - MixedPrecisionBrick<S> & MixedPrecisionBrickView<S>, specialization
+ *    tags.
+ *  - MixedPrecisionRef<T,S>, the proxy used to write an element.
+ *  - Pooma::MixedPrecisionBase<Dim,T,S,StorageTag>, element access shared
+ *    by the two engines.
+ *  - Engine<Dim,T,MixedPrecisionBrick<S> >, the "MixedPrecisionBrick-Engine"
+ *    specialization.
+ *  - Engine<Dim,T,MixedPrecisionBrickView<S> >, the
+ *    "MixedPrecisionBrickView-Engine" specialization.
+ *  - NewEngine<Engine,SubDomain>, specializations for
+ *    MixedPrecisionBrickView-Engine.
+ */
+
+#ifndef POOMA_ENGINE_MIXEDPRECISIONBRICK_H
+#define POOMA_ENGINE_MIXEDPRECISIONBRICK_H
+
+//-----------------------------------------------------------------------------
+// Includes:
+//-----------------------------------------------------------------------------
+
+#include "Domain/Domain.h"
+#include "Domain/Interval.h"
+#include "Domain/Loc.h"
+#include "Domain/Range.h"
+#include "Domain/SliceInterval.h"
+#include "Domain/SliceRange.h"
+#include "Engine/BrickEngine.h"
+#include "Engine/Engine.h"
+#include "Layout/DomainLayout.h"
+#include "Layout/Node.h"
+#include "Layout/INode.h"
+#include "Utilities/ElementProperties.h"
+#include "Utilities/PAssert.h"
+#include <iosfwd>
+
+
+///////////////////////////////////////////////////////////////////////////////
+// namespace Pooma {
+
+/**
+ * These are the tag classes used to select the "MixedPrecisionBrick" and
+ * "MixedPrecisionBrickView" specializations of the Engine class template.
+ * S is the type the elements are stored as.
+ */
+
+template <class S = float>
+struct MixedPrecisionBrick { };
+
+template <class S = float>
+struct MixedPrecisionBrickView { };
+
+/**
+ * MixedPrecisionRef<T,S> is returned by the operator() of
+ * MixedPrecisionBricks instead of a T&.  It points at an element stored
+ * as an S.  Converting it to T widens the element; assigning to it
+ * narrows the value.
+ */
+
+template <class T, class S>
+class MixedPrecisionRef
+{
+public:
+
+  typedef MixedPrecisionRef<T,S> This_t;
+
+  explicit MixedPrecisionRef(S *p)
+    : p_m(p)
+  { }
+
+  /// Widen the element.
+
+  T read() const { return T(*p_m); }
+
+  operator T() const { return read(); }
+
+  //@{
+
+  /// Assignment narrows the value.  Anything a T can be made from can
+  /// be assigned.
+
+  This_t &operator=(const T &x)
+  {
+    *p_m = S(x);
+    return *this;
+  }
+
+  This_t &operator=(const This_t &x)
+  {
+    return *this = x.read();
+  }
+
+  template <class X>
+  This_t &operator=(const X &x)
+  {
+    T y(x);
+    return *this = y;
+  }
+
+  //@}
+
+  //@{
+
+  /// Computed assignment is done with T.
+
+  template <class X>
+  This_t &operator+=(const X &x)
+  {
+    T y = read();
+    y += x;
+    return *this = y;
+  }
+
+  template <class X>
+  This_t &operator-=(const X &x)
+  {
+    T y = read();
+    y -= x;
+    return *this = y;
+  }
+
+  template <class X>
+  This_t &operator*=(const X &x)
+  {
+    T y = read();
+    y *= x;
+    return *this = y;
+  }
+
+  template <class X>
+  This_t &operator/=(const X &x)
+  {
+    T y = read();
+    y /= x;
+    return *this = y;
+  }
+
+  //@}
+
+private:
+
+  S *p_m;
+};
+
+template <class T, class S>
+std::ostream &operator<<(std::ostream &out, const MixedPrecisionRef<T,S> &r)
+{
+  return out << r.read();
+}
+
+
+namespace Pooma {
+
+/**
+ * MixedPrecisionBase<Dim,T,S,StorageTag> holds the
+ * Engine<Dim,S,StorageTag> the elements are stored in and does the
+ * element access for MixedPrecisionBrick and MixedPrecisionBrickView.
+ */
+
+template <int Dim, class T, class S, class StorageTag>
+class MixedPrecisionBase
+{
+public:
+
+  //============================================================
+  // Exported typedefs and constants
+  //============================================================
+
+  typedef Engine<Dim,S,StorageTag>                  Storage_t;
+  typedef typename Storage_t::Domain_t              Domain_t;
+  typedef DomainLayout<Dim>                         Layout_t;
+  typedef T                                         Element_t;
+  typedef MixedPrecisionRef<T,S>                    ElementRef_t;
+
+  //============================================================
+  // Constructors
+  //============================================================
+
+  MixedPrecisionBase() { }
+
+  explicit MixedPrecisionBase(const Storage_t &storage)
+    : storage_m(storage)
+  { }
+
+  //============================================================
+  // Accessor functions
+  //============================================================
+
+  //@{
+
+  /// Element access via Loc.
+
+  Element_t read(const Loc<Dim> &loc) const
+  {
+    return Element_t(storage_m.read(loc));
+  }
+  ElementRef_t operator()(const Loc<Dim> &loc) const
+  {
+    return ElementRef_t(&storage_m(loc));
+  }
+
+  //@}
+
+  //@{
+
+  /// Element access via ints for speed.
+
+  Element_t read(int i1) const
+  {
+    return Element_t(storage_m.read(i1));
+  }
+  Element_t read(int i1, int i2) const
+  {
+    return Element_t(storage_m.read(i1,i2));
+  }
+  Element_t read(int i1, int i2, int i3) const
+  {
+    return Element_t(storage_m.read(i1,i2,i3));
+  }
+  Element_t read(int i1, int i2, int i3, int i4) const
+  {
+    return Element_t(storage_m.read(i1,i2,i3,i4));
+  }
+  Element_t read(int i1, int i2, int i3, int i4, int i5) const
+  {
+    return Element_t(storage_m.read(i1,i2,i3,i4,i5));
+  }
+  Element_t read(int i1, int i2, int i3, int i4, int i5, int i6) const
+  {
+    return Element_t(storage_m.read(i1,i2,i3,i4,i5,i6));
+  }
+  Element_t read(int i1, int i2, int i3, int i4, int i5, int i6, int i7) const
+  {
+    return Element_t(storage_m.read(i1,i2,i3,i4,i5,i6,i7));
+  }
+
+  ElementRef_t operator()(int i1) const
+  {
+    return ElementRef_t(&storage_m(i1));
+  }
+  ElementRef_t operator()(int i1, int i2) const
+  {
+    return ElementRef_t(&storage_m(i1,i2));
+  }
+  ElementRef_t operator()(int i1, int i2, int i3) const
+  {
+    return ElementRef_t(&storage_m(i1,i2,i3));
+  }
+  ElementRef_t operator()(int i1, int i2, int i3, int i4) const
+  {
+    return ElementRef_t(&storage_m(i1,i2,i3,i4));
+  }
+  ElementRef_t operator()(int i1, int i2, int i3, int i4, int i5) const
+  {
+    return ElementRef_t(&storage_m(i1,i2,i3,i4,i5));
+  }
+  ElementRef_t operator()(int i1, int i2, int i3, int i4, int i5, int i6) const
+  {
+    return ElementRef_t(&storage_m(i1,i2,i3,i4,i5,i6));
+  }
+  ElementRef_t operator()(int i1, int i2, int i3, int i4, int i5, int i6,
+			  int i7) const
+  {
+    return ElementRef_t(&storage_m(i1,i2,i3,i4,i5,i6,i7));
+  }
+
+  //@}
+
+  /// Return the domain.
+
+  const Domain_t &domain() const { return storage_m.domain(); }
+
+  /// Return a layout.
+
+  Layout_t layout() const { return Layout_t(domain()); }
+
+  /// Return the engine the elements are stored in.
+
+  const Storage_t &storage() const { return storage_m; }
+
+  /// Provide access to the data object.
+
+  Pooma::DataObject_t *dataObject() const { return storage_m.dataObject(); }
+
+protected:
+
+  Storage_t storage_m;
+};
+
+} // namespace Pooma
+
+
+/**
+ * Engine<Dim,T,MixedPrecisionBrick<S> > (aka MixedPrecisionBrick-Engine)
+ *
+ * Engine<Dim,T,MixedPrecisionBrick<S> > is an Engine for a local,
+ * Dim-dimensional brick of elements of type T that are stored as S,
+ * usually doubles stored as floats.  Expressions read the elements as T
+ * and compute with T; only the storage is narrower, which halves the
+ * memory and the bandwidth of bandwidth-bound expressions on doubles.
+ *
+ * Template Parameters:
+ *  - Dim: An integer for the dimension of the brick.
+ *  - T:   The element type.
+ *  - S:   The type the elements are stored as.  T and S must be
+ *         constructible from one another.
+ *
+ * The Domain of this engine is an Interval<Dim>.  The elements are held
+ * by an Engine<Dim,S,Brick>.  Elements are written through a
+ * MixedPrecisionRef, so component views of arrays of Vectors stored as
+ * Vectors of floats can be read but not written.
+ *
+ * Subsetting Engine<Dim,T,MixedPrecisionBrick<S> > returns an
+ * Engine<Dim,T,MixedPrecisionBrickView<S> >.
+ */
+
+template <int Dim, class T, class S>
+class Engine<Dim,T,MixedPrecisionBrick<S> >
+  : public Pooma::MixedPrecisionBase<Dim,T,S,Brick>
+{
+public:
+
+  //============================================================
+  // Exported typedefs and constants
+  //============================================================
+
+  typedef Engine<Dim,T,MixedPrecisionBrick<S> >       This_t;
+  typedef Engine<Dim,T,MixedPrecisionBrick<S> >       Engine_t;
+  typedef Pooma::MixedPrecisionBase<Dim,T,S,Brick>    Base_t;
+  typedef typename Base_t::Storage_t                  Storage_t;
+  typedef typename Base_t::Domain_t                   Domain_t;
+  typedef typename Base_t::Layout_t                   Layout_t;
+  typedef typename Base_t::Element_t                  Element_t;
+  typedef typename Base_t::ElementRef_t               ElementRef_t;
+  typedef MixedPrecisionBrick<S>                      Tag_t;
+
+  enum { dimensions    = Dim   };
+  enum { hasDataObject = true  };
+  enum { dynamic       = false };
+  enum { zeroBased     = false };
+  enum { multiPatch    = false };
+
+  //============================================================
+  // Constructors and Factory Methods
+  //============================================================
+
+  /// Default constructor.  Creates a MixedPrecisionBrick-Engine with no
+  /// data.
+
+  Engine() { }
+
+  //@{
+
+  /// Allocate storage for the domain, given directly or through a
+  /// Node or Layout_t object.  The second version initializes the
+  /// elements with a model.
+
+  explicit Engine(const Domain_t &domain)
+    : Base_t(Storage_t(domain))
+  { }
+
+  Engine(const Domain_t &domain, const T &elementModel)
+    : Base_t(Storage_t(domain, S(elementModel)))
+  { }
+
+  explicit Engine(const Layout_t &layout)
+    : Base_t(Storage_t(layout))
+  { }
+
+  explicit Engine(const Node<Domain_t> &node)
+    : Base_t(Storage_t(node))
+  { }
+
+  //@}
+
+  /// Copy constructor performs a SHALLOW copy.
+
+  Engine(const Engine_t &model)
+    : Base_t(model)
+  { }
+
+  //============================================================
+  // Assignment operators
+  //============================================================
+
+  /// Assigment is SHALLOW, to be consistent with copy.
+
+  Engine_t &operator=(const Engine_t &model)
+  {
+    this->storage_m = model.storage_m;
+    return *this;
+  }
+
+  //============================================================
+  // Accessor and Mutator functions:
+  //============================================================
+
+  /// Get a private copy of the data viewed by this Engine.
+
+  Engine_t &makeOwnCopy()
+  {
+    this->storage_m.makeOwnCopy();
+    return *this;
+  }
+};
+
+
+/**
+ * Engine<Dim,T,MixedPrecisionBrickView<S> > (aka
+ * MixedPrecisionBrickView-Engine)
+ *
+ * A MixedPrecisionBrickView-Engine is a view of a
+ * MixedPrecisionBrick-Engine.  Its elements are held by an
+ * Engine<Dim,S,BrickView>, so, as for BrickViews, its domain is
+ * zero-based.
+ */
+
+template <int Dim, class T, class S>
+class Engine<Dim,T,MixedPrecisionBrickView<S> >
+  : public Pooma::MixedPrecisionBase<Dim,T,S,BrickView>
+{
+public:
+
+  //============================================================
+  // Exported typedefs and constants
+  //============================================================
+
+  typedef Engine<Dim,T,MixedPrecisionBrickView<S> >   This_t;
+  typedef Engine<Dim,T,MixedPrecisionBrickView<S> >   Engine_t;
+  typedef Pooma::MixedPrecisionBase<Dim,T,S,BrickView> Base_t;
+  typedef typename Base_t::Storage_t                  Storage_t;
+  typedef typename Base_t::Domain_t                   Domain_t;
+  typedef typename Base_t::Layout_t                   Layout_t;
+  typedef typename Base_t::Element_t                  Element_t;
+  typedef typename Base_t::ElementRef_t               ElementRef_t;
+  typedef MixedPrecisionBrickView<S>                  Tag_t;
+
+  enum { dimensions    = Dim   };
+  enum { hasDataObject = true  };
+  enum { dynamic       = false };
+  enum { zeroBased     = true  };
+  enum { multiPatch    = false };
+
+  //============================================================
+  // Constructors
+  //============================================================
+
+  /// Default constructor is required for containers.
+
+  Engine() { }
+
+  //@{
+
+  /// Copy constructors perform a SHALLOW copy.  The second is used for
+  /// the patches of MultiPatch views.
+
+  Engine(const Engine_t &model)
+    : Base_t(model)
+  { }
+
+  Engine(const Engine_t &model, const EngineConstructTag &)
+    : Base_t(model)
+  { }
+
+  //@}
+
+  //@{
+
+  /// Subsetting constructors.  The storage is viewed with the domain,
+  /// which is an Interval<Dim> or a Range<Dim>, or a slice.
+
+  template <class ETag, class DT>
+  Engine(const Engine<Dim,T,ETag> &e, const Domain<Dim, DT> &dom)
+    : Base_t(Storage_t(e.storage(), dom))
+  { }
+
+  template <int Dim2, class ETag>
+  Engine(const Engine<Dim2,T,ETag> &e, const SliceRange<Dim2,Dim> &dom)
+    : Base_t(Storage_t(e.storage(), dom))
+  { }
+
+  template <int Dim2, class ETag>
+  Engine(const Engine<Dim2,T,ETag> &e, const SliceInterval<Dim2,Dim> &dom)
+    : Base_t(Storage_t(e.storage(), dom))
+  { }
+
+  //@}
+
+  //============================================================
+  // Assignment operators
+  //============================================================
+
+  Engine_t &operator=(const Engine_t &model)
+  {
+    this->storage_m = model.storage_m;
+    return *this;
+  }
+};
+
+
+/**
+ * NewEngine<Engine,SubDomain>
+ *
+ * Views of MixedPrecisionBrick and MixedPrecisionBrickView engines are
+ * MixedPrecisionBrickViews.
+ */
+
+template <int Dim, class T, class S>
+struct NewEngine<Engine<Dim,T,MixedPrecisionBrick<S> >, Interval<Dim> >
+{
+  typedef Engine<Dim,T,MixedPrecisionBrickView<S> > Type_t;
+};
+
+template <int Dim, class T, class S>
+struct NewEngine<Engine<Dim,T,MixedPrecisionBrick<S> >, Range<Dim> >
+{
+  typedef Engine<Dim,T,MixedPrecisionBrickView<S> > Type_t;
+};
+
+template <int Dim, class T, class S>
+struct NewEngine<Engine<Dim,T,MixedPrecisionBrick<S> >,
+  Node<Interval<Dim> > >
+{
+  typedef Engine<Dim,T,MixedPrecisionBrickView<S> > Type_t;
+};
+
+template <int Dim, class T, class S>
+struct NewEngine<Engine<Dim,T,MixedPrecisionBrick<S> >, INode<Dim> >
+{
+  typedef Engine<Dim,T,MixedPrecisionBrickView<S> > Type_t;
+};
+
+template <int Dim, class T, class S, int SliceDim>
+struct NewEngine<Engine<Dim,T,MixedPrecisionBrick<S> >,
+  SliceInterval<Dim,SliceDim> >
+{
+  typedef Engine<SliceDim,T,MixedPrecisionBrickView<S> > Type_t;
+};
+
+template <int Dim, class T, class S, int SliceDim>
+struct NewEngine<Engine<Dim,T,MixedPrecisionBrick<S> >,
+  SliceRange<Dim,SliceDim> >
+{
+  typedef Engine<SliceDim,T,MixedPrecisionBrickView<S> > Type_t;
+};
+
+template <int Dim, class T, class S>
+struct NewEngine<Engine<Dim,T,MixedPrecisionBrickView<S> >, Interval<Dim> >
+{
+  typedef Engine<Dim,T,MixedPrecisionBrickView<S> > Type_t;
+};
+
+template <int Dim, class T, class S>
+struct NewEngine<Engine<Dim,T,MixedPrecisionBrickView<S> >, Range<Dim> >
+{
+  typedef Engine<Dim,T,MixedPrecisionBrickView<S> > Type_t;
+};
+
+template <int Dim, class T, class S>
+struct NewEngine<Engine<Dim,T,MixedPrecisionBrickView<S> >,
+  Node<Interval<Dim> > >
+{
+  typedef Engine<Dim,T,MixedPrecisionBrickView<S> > Type_t;
+};
+
+template <int Dim, class T, class S>
+struct NewEngine<Engine<Dim,T,MixedPrecisionBrickView<S> >, INode<Dim> >
+{
+  typedef Engine<Dim,T,MixedPrecisionBrickView<S> > Type_t;
+};
+
+template <int Dim, class T, class S, int SliceDim>
+struct NewEngine<Engine<Dim,T,MixedPrecisionBrickView<S> >,
+  SliceInterval<Dim,SliceDim> >
+{
+  typedef Engine<SliceDim,T,MixedPrecisionBrickView<S> > Type_t;
+};
+
+template <int Dim, class T, class S, int SliceDim>
+struct NewEngine<Engine<Dim,T,MixedPrecisionBrickView<S> >,
+  SliceRange<Dim,SliceDim> >
+{
+  typedef Engine<SliceDim,T,MixedPrecisionBrickView<S> > Type_t;
+};
+
+
+/**
+ * NewEngineDomain<Engine,SubDomain>
+ *
+ * Views through Nodes and INodes are taken with their domains.
+ */
+
+template <int Dim, class T, class S>
+struct NewEngineDomain<Engine<Dim,T,MixedPrecisionBrick<S> >,
+  Node<Interval<Dim> > >
+{
+  typedef Interval<Dim> Type_t;
+  typedef const Interval<Dim> &Return_t;
+  static inline
+  Return_t apply(const Engine<Dim,T,MixedPrecisionBrick<S> > &,
+		 const Node<Interval<Dim> > &node)
+  {
+    return node.domain();
+  }
+};
+
+template <int Dim, class T, class S>
+struct NewEngineDomain<Engine<Dim,T,MixedPrecisionBrick<S> >, INode<Dim> >
+{
+  typedef Interval<Dim> Type_t;
+  typedef const Interval<Dim> &Return_t;
+  static inline
+  Return_t apply(const Engine<Dim,T,MixedPrecisionBrick<S> > &,
+		 const INode<Dim> &inode)
+  {
+    return inode.domain();
+  }
+};
+
+template <int Dim, class T, class S>
+struct NewEngineDomain<Engine<Dim,T,MixedPrecisionBrickView<S> >,
+  Node<Interval<Dim> > >
+{
+  typedef Interval<Dim> Type_t;
+  typedef const Interval<Dim> &Return_t;
+  static inline
+  Return_t apply(const Engine<Dim,T,MixedPrecisionBrickView<S> > &,
+		 const Node<Interval<Dim> > &node)
+  {
+    return node.domain();
+  }
+};
+
+template <int Dim, class T, class S>
+struct NewEngineDomain<Engine<Dim,T,MixedPrecisionBrickView<S> >,
+  INode<Dim> >
+{
+  typedef Interval<Dim> Type_t;
+  typedef const Interval<Dim> &Return_t;
+  static inline
+  Return_t apply(const Engine<Dim,T,MixedPrecisionBrickView<S> > &,
+		 const INode<Dim> &inode)
+  {
+    return inode.domain();
+  }
+};
+
+
+/**
+ * Traits class telling RefCountedBlockPointer that this class has
+ * shallow semantics and a makeOwnCopy method.
+ */
+
+template <int Dim, class T, class S>
+struct ElementProperties<Engine<Dim, T, MixedPrecisionBrick<S> > >
+  : public MakeOwnCopyProperties<Engine<Dim, T, MixedPrecisionBrick<S> > >
+{ };
+
+// } // namespace Pooma
+///////////////////////////////////////////////////////////////////////////////
+
+#endif // POOMA_ENGINE_MIXEDPRECISIONBRICK_H
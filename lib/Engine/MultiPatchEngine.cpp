@@ -69,7 +69,7 @@ Engine<Dim, T, MultiPatch<LayoutTag, PatchTag> >::
 Engine(const Layout_t &layout)
   : layout_m(layout),
     data_m(layout.sizeGlobal()),
-    pDirty_m(new int)
+    pDirty_m(new DirtyFlags(layout.sizeGlobal()))
 {
   typedef typename Layout_t::Value_t Node_t;
 
@@ -149,6 +149,31 @@ Engine(const Engine_t &modelEngine)
 }
 
 
+//-----------------------------------------------------------------------------
+//
+// Engine<Dim,T,MultiPatch>::Engine(Engine_t &&model)
+//
+// Move constructor.  The model's layout handle keeps its own observers,
+// so the model is taken off it by hand.
+//
+//-----------------------------------------------------------------------------
+
+template <int Dim, class T, class LayoutTag, class PatchTag>
+Engine<Dim, T, MultiPatch<LayoutTag, PatchTag> >::
+Engine(Engine_t &&modelEngine)
+  : layout_m(std::move(modelEngine.layout_m)),
+    data_m(std::move(modelEngine.data_m)),
+    pDirty_m(modelEngine.pDirty_m)
+{
+  modelEngine.layout_m.detach(modelEngine);
+  modelEngine.pDirty_m = 0;
+
+  // Attach ourself to the layout so we can receive messages.
+
+  layout_m.attach(*this);  
+}
+
+
 //-----------------------------------------------------------------------------
 //
 // Engine<Dim,T,MultiPatch>::~Engine()
@@ -240,7 +265,7 @@ makeOwnCopy()
 {
   if (data_m.isValid() && data_m.isShared()) {
     data_m.makeOwnCopy();
-    pDirty_m = new int(*pDirty_m);
+    pDirty_m = new DirtyFlags(*pDirty_m);
   }
 
   return *this;
@@ -294,7 +319,20 @@ fillGuardsHandler(const GuardLayers<Dim>& g, const WrappedInt<true> &) const
 {
   if (!isDirty()) return;
 
-  int updated = 0;
+  // Only the guards filled from patches written since the last fill
+  // are copied.  Layouts that do not know the face of a guard layer
+  // (face_m == -1) fill all the guards of a dirty patch.
+
+  std::vector<int> &dirty = pDirty_m->patches_m;
+  int filled = 0;
+  for (int d = 0; d < Dim; ++d)
+    {
+      if (g.lower(d) != 0)
+	filled |= 1<<(2*d);
+      if (g.upper(d) != 0)
+	filled |= 1<<(2*d+1);
+    }
+
   typename Layout_t::FillIterator_t p = layout_m.beginFillList();
 
   while (p != layout_m.endFillList())
@@ -302,9 +340,13 @@ fillGuardsHandler(const GuardLayers<Dim>& g, const WrappedInt<true> &) const
       int src  = p->ownedID_m;
       int dest = p->guardID_m;
       
+      if (p->face_m == -1)
+	filled = ~0;
+
       // Skip face, if not dirty.
 
-      if (isDirty(p->face_m)) {
+      if (p->face_m == -1 ? dirty[src] != 0
+	  : (dirty[src] & (1<<p->face_m)) != 0) {
 
         // Check, if the p->domain_m is a guard which matches the
         // needed guard g.
@@ -325,9 +367,6 @@ fillGuardsHandler(const GuardLayers<Dim>& g, const WrappedInt<true> &) const
           lhs(p->domain_m) = rhs(p->domain_m);
 #endif
 
-	  // Mark up-to-date.
-	  updated |= 1<<p->face_m;
-
 	}
 
       }
@@ -335,7 +374,15 @@ fillGuardsHandler(const GuardLayers<Dim>& g, const WrappedInt<true> &) const
       ++p;
     }
 
-  *pDirty_m &= ~updated;
+  // Mark up-to-date.
+
+  int faces = 0, size = dirty.size();
+  for (int i = 0; i < size; ++i)
+    {
+      dirty[i] &= ~filled;
+      faces |= dirty[i];
+    }
+  pDirty_m->faces_m = faces;
 }
 
 
@@ -590,11 +637,25 @@ notify(Observable_t &observed, const ObserverEvent &event)
     {
       typedef typename Layout_t::Value_t Node_t;
   
-      // Reinitialize the patches. We need to make a new ref-counted
-      // pointer since the number of nodes could have changed.
-      // We then replace our data pointer with this new one.
-      
       int sz = layout().sizeGlobal();
+
+      // Copies of this engine share the patches and are notified too.  If
+      // the number of patches did not change, the first copy replaces
+      // them in place, so the others find patches that already fit the
+      // layout and have nothing left to do.
+
+      bool current = static_cast<int>(data_m.size()) == sz &&
+	static_cast<int>(pDirty_m->affinities_m.size()) == sz;
+      typename Layout_t::const_iterator node = layout().beginGlobal();
+      for (int i = 0; i < sz && current; ++i, ++node)
+	current = data_m[i].domain() == node->allocated() &&
+	  pDirty_m->affinities_m[i] == node->affinity() &&
+	  pDirty_m->contexts_m[i] == node->context();
+      if (current)
+	return;
+
+      // Reinitialize the patches, and move the elements of the old
+      // patches to them.
       
       PatchContainer_t newData(sz);
       
@@ -616,8 +677,42 @@ notify(Observable_t &observed, const ObserverEvent &event)
         }
         
       csem.wait();
-      
-      data_m = newData;
+
+      movePatches(data_m, newData,
+		  moveGuards(WrappedInt<Layout_t::supportsGuards>()));
+
+      // If the number of patches did not change, we replace them in
+      // place so the copies keep sharing them.  Otherwise we need a new
+      // ref-counted pointer and the copies get their own patches.
+
+      if (static_cast<int>(data_m.size()) == sz)
+	{
+	  for (int i = 0; i < sz; ++i)
+	    data_m[i] = newData[i];
+	}
+      else
+	{
+	  // The dirty flags go with the patches, so we need our own too.
+	  // The last engine to let go of the old patches deletes the old
+	  // flags.
+
+	  DirtyFlags *flags = new DirtyFlags(sz);
+	  if (!data_m.isShared())
+	    delete pDirty_m;
+	  pDirty_m = flags;
+	  data_m = newData;
+	}
+
+      pDirty_m->patches_m.resize(sz);
+      pDirty_m->affinities_m.resize(sz);
+      pDirty_m->contexts_m.resize(sz);
+      typename Layout_t::const_iterator q = layout().beginGlobal();
+      for (int i = 0; i < sz; ++i, ++q)
+	{
+	  pDirty_m->affinities_m[i] = q->affinity();
+	  pDirty_m->contexts_m[i] = q->context();
+	}
+      setDirty();
     }
   else
     {
@@ -637,6 +732,59 @@ notify(Observable_t &observed, const ObserverEvent &event)
 }
 
 
+//-----------------------------------------------------------------------------
+//
+// void Engine<Dim,T,MultiPatch>::movePatches(from, to)
+//
+// Copy the elements of the patches in from to the patches in to, after
+// the layout has been repartitioned.  Each old patch provides the
+// elements it owns, together with the external guards next to them, so
+// every element of the new patches, including their internal guards,
+// comes from its owner.  The old patches are assumed to have the given
+// internal guards, those of the layout.
+//
+//-----------------------------------------------------------------------------
+
+template <int Dim, class T, class LayoutTag, class PatchTag>
+void Engine<Dim, T, MultiPatch<LayoutTag, PatchTag> >::
+movePatches(const PatchContainer_t &from, const PatchContainer_t &to,
+	    const GuardLayers<Dim> &guards) const
+{
+  const Domain_t &dom = layout().domain();
+  int nfrom = from.size(), nto = to.size();
+
+  for (int j = 0; j < nfrom; ++j)
+    {
+      Domain_t owned = from[j].domain();
+      if (owned.empty())
+	continue;
+      for (int d = 0; d < Dim; ++d)
+	{
+	  int first = owned[d].first(), last = owned[d].last();
+	  if (first != dom[d].first())
+	    first += guards.lower(d);
+	  if (last != dom[d].last())
+	    last -= guards.upper(d);
+	  owned[d] = Interval<1>(first, last);
+	}
+
+      for (int i = 0; i < nto; ++i)
+	{
+	  Domain_t piece = intersect(to[i].domain(), owned);
+	  if (piece.empty())
+	    continue;
+
+	  Array<Dim, T, PatchTag> lhs(to[i]), rhs(from[j]);
+#if POOMA_MPI
+	  simpleAssign(lhs, rhs, piece);
+#else
+	  lhs(piece) = rhs(piece);
+#endif
+	}
+    }
+}
+
+
 //-----------------------------------------------------------------------------
 //
 // void Engine<Dim,T,MultiPatch>::performCreate(CreateSize_t n, PatchID_t p)
@@ -996,6 +1144,21 @@ void uncompress(Engine<Dim, T, MultiPatch<LTag, PatchTag> > &engine)
     uncompress(engine.localPatch(i));
 }
 
+//-----------------------------------------------------------------------------
+//
+// void flush()
+//
+// Write all the local patches back to the files they are mapped from.
+//
+//-----------------------------------------------------------------------------
+
+template<int Dim, class T, class LTag, class PatchTag>
+void flush(const Engine<Dim, T, MultiPatch<LTag, PatchTag> > &engine)
+{
+  for (int i = 0; i < engine.layout().sizeLocal(); ++i)
+    flush(engine.localPatch(i));
+}
+
 // ACL:rcsinfo
 // ----------------------------------------------------------------------
 // $RCSfile: MultiPatchEngine.cpp,v $   $Author: richard $
@@ -71,6 +71,9 @@
 #include "Utilities/WrappedInt.h"
 #include "Layout/DynamicEvents.h"
 
+#include <algorithm>
+#include <vector>
+
 //-----------------------------------------------------------------------------
 // Forward declarations
 //-----------------------------------------------------------------------------
@@ -459,6 +462,12 @@ public:
 
   Engine(const Engine_t &model);
 
+  //---------------------------------------------------------------------------
+  /// Move constructor.  Takes the layout, patches and dirty flag over
+  /// from the model, which is left uninitialized.
+
+  Engine(Engine_t &&model);
+
 
   //===========================================================================
   // Destructor
@@ -642,33 +651,62 @@ public:
   void accumulateFromGuards() const;
 
   //---------------------------------------------------------------------------
-  /// Set and get the dirty flag (fillGuards is a no-op unless the 
-  /// dirty flag is true).
+  /// Set and get the dirty flags (fillGuards is a no-op unless a 
+  /// dirty flag is true).  There is a set of flags for each patch,
+  /// one for each face, telling whether the guards that the patch fills
+  /// on that face of its neighbors are out of date.  dirty() and
+  /// isDirty() without a patch number look at all the patches.
     
-  inline int dirty() const { return *pDirty_m; }
+  inline int dirty() const { return pDirty_m->faces_m; }
+
+  inline int dirty(int patch) const
+  {
+    PAssert(patch >= 0 &&
+	    patch < static_cast<int>(pDirty_m->patches_m.size()));
+    return pDirty_m->patches_m[patch];
+  }
+
+  /// Mark all the patches dirty.
 
   inline void setDirty() const
   {
-    *pDirty_m = (1<<(Dim*2))-1;
+    pDirty_m->faces_m = (1<<(Dim*2))-1;
+    std::fill(pDirty_m->patches_m.begin(), pDirty_m->patches_m.end(),
+	      pDirty_m->faces_m);
+  }
+
+  /// Mark the patch with the given global ID dirty, after it is written.
+
+  inline void setDirty(int patch) const
+  {
+    PAssert(patch >= 0 &&
+	    patch < static_cast<int>(pDirty_m->patches_m.size()));
+    pDirty_m->faces_m = (1<<(Dim*2))-1;
+    pDirty_m->patches_m[patch] = pDirty_m->faces_m;
   }
 
   inline void clearDirty(int face = -1) const
   {
-    if (face == -1)
-      *pDirty_m = 0;
+    if (face == -1) {
+      pDirty_m->faces_m = 0;
+      std::fill(pDirty_m->patches_m.begin(), pDirty_m->patches_m.end(), 0);
+    }
     else {
       PAssert(face >= 0 && face <= Dim*2-1);
-      *pDirty_m &= ~(1<<face);
+      pDirty_m->faces_m &= ~(1<<face);
+      int size = pDirty_m->patches_m.size();
+      for (int i = 0; i < size; ++i)
+	pDirty_m->patches_m[i] &= ~(1<<face);
     }
   }
 
   inline bool isDirty(int face = -1) const
   {
     if (face == -1)
-      return *pDirty_m != 0;
+      return pDirty_m->faces_m != 0;
     else {
       PAssert(face >= 0 && face <= Dim*2-1);
-      return *pDirty_m & (1<<face);
+      return pDirty_m->faces_m & (1<<face);
     }
   }
 
@@ -795,6 +833,23 @@ public:
 
 private:
 
+  /// Copy the elements of the old patches to the patches made for the
+  /// repartitioned layout.
+
+  void movePatches(const PatchContainer_t &from, const PatchContainer_t &to,
+		   const GuardLayers<Dim> &guards) const;
+
+  /// The internal guards of the old patches, if the layout has any.
+
+  inline GuardLayers<Dim> moveGuards(const WrappedInt<false>&) const
+  {
+    return GuardLayers<Dim>(0);
+  }
+  inline GuardLayers<Dim> moveGuards(const WrappedInt<true>&) const
+  {
+    return layout().internalGuards();
+  }
+
   //===========================================================================
   // Private dynamic routines
   //===========================================================================
@@ -881,12 +936,26 @@ private:
 
   PatchContainer_t data_m;
   
-  /// Flag indicating whether internal guard cells need to be filled.
-  /// We store a pointer to the flag since all copies and views
-  /// must share the same flag. We use the reference count in
+  /// Flags indicating which internal guard cells need to be filled: a
+  /// mask of faces for each patch, and the union of the masks.  They also
+  /// keep the affinities and contexts of the nodes the patches were last
+  /// repartitioned for, so the copies sharing the patches can tell that
+  /// the patches already fit the layout.
+
+  struct DirtyFlags
+  {
+    DirtyFlags(int patches) : faces_m(0), patches_m(patches, 0) { }
+
+    int faces_m;
+    std::vector<int> patches_m;
+    std::vector<int> affinities_m, contexts_m;
+  };
+
+  /// We store a pointer to the flags since all copies and views
+  /// must share the same flags. We use the reference count in
   /// data_m to decide whether to clean this up.
 
-  int *pDirty_m;
+  DirtyFlags *pDirty_m;
 };
 
 
@@ -1235,6 +1304,11 @@ public:
     baseEngine_m.setDirty();
   }
 
+  inline void setDirty(int patch) const
+  {
+    baseEngine_m.setDirty(patch);
+  }
+
   inline void clearDirty(int face=-1) const
   {
     baseEngine_m.clearDirty(face);
@@ -1295,10 +1369,10 @@ private:
   Layout_t layout_m;
 
   /// Shallow copy of the underyling engine.
-  /// We have to have this to support filling guard cells. There
-  /// is only a single dirty flag, so guard cell fill requests must
-  /// fill the guards for the entire engine, and we need a reference
-  /// to that engine in order to carry this out.
+  /// We have to have this to support filling guard cells. The dirty
+  /// flags are those of the underlying engine, so guard cell fill
+  /// requests must fill the guards for the entire engine, and we need
+  /// a reference to that engine in order to carry this out.
   
   ViewedEngine_t baseEngine_m;
 
@@ -1703,7 +1777,9 @@ operator()(int i0, int i1, int i2, int i3, int i4, int i5, int i6) const
 // Specialization of IntersectEngine because these engines contain multiple
 // patches.
 // Respond to the IntersecEngineTag<Dim> message by intersecting our layout
-// with the enclosed intersector.
+// with the enclosed intersector.  The guard layers the expression reads
+// are filled through the intersector, which may put the fill off until
+// the interiors of the patches are handed off (see Pooma::overlapGuards()).
 //---------------------------------------------------------------------------
 
 template <int Dim, class T, class LayoutTag, class PatchTag, class Intersect>
@@ -1722,7 +1798,7 @@ struct LeafFunctor<Engine<Dim, T, MultiPatch<LayoutTag,PatchTag> >,
 				  engine.layout().internalGuards(), usedGuards);
 
     if (useGuards)
-      engine.fillGuards(usedGuards);
+      tag.tag().intersector_m.data()->fillGuards(engine, usedGuards);
 
     return 0;
   }
@@ -1755,7 +1831,7 @@ struct LeafFunctor<Engine<Dim, T, MultiPatchView<LT,PatchTag,BD> >,
 		engine.layout().baseLayout().internalGuards(), usedGuards);
 
     if (useGuards)
-      engine.fillGuards(usedGuards);
+      tag.tag().intersector_m.data()->fillGuards(engine, usedGuards);
 
     return 0;
   }
@@ -1832,13 +1908,21 @@ struct NotifyEngineWrite<Engine<Dim, T, MultiPatch<LayoutTag,PatchTag> > >
   }
 };
 
+/// A view only writes the patches it touches, so only those are marked
+/// dirty.  The nodes of the view's layout carry the global IDs of the
+/// underlying patches.
+
 template <int Dim, class T, class LT, class PatchTag, int BD>
 struct NotifyEngineWrite<Engine<Dim, T, MultiPatchView<LT,PatchTag,BD> > >
 {
   inline static void
   notify(const Engine<Dim,T,MultiPatchView<LT,PatchTag,BD> > &engine)
   {
-    engine.setDirty();
+    typedef typename Engine<Dim,T,MultiPatchView<LT,PatchTag,BD> >::Layout_t
+      Layout_t;
+    typename Layout_t::const_iterator p = engine.layout().beginGlobal();
+    for (; p != engine.layout().endGlobal(); ++p)
+      engine.setDirty(p->globalID());
   }
 };
 
@@ -1973,7 +1973,9 @@ struct Evaluator<RemoteMultiPatchEvaluatorTag>
 
   // evaluate(expression)
   // Input an expression and cause it to be evaluated.
-  // We just pass the buck to a special evaluator.
+  // We just pass the buck to a special evaluator.  If guard fills were
+  // put off (see Pooma::overlapGuards()), the interiors of the patches
+  // are handed off before the guard messages and the shells after them.
 
   template <class LHS, class RHS, class Op>
   void evaluate(const LHS &lhs, const Op &op, const RHS &rhs) const
@@ -1981,8 +1983,29 @@ struct Evaluator<RemoteMultiPatchEvaluatorTag>
     typedef Intersector<LHS::dimensions> Inter_t;
     Inter_t inter;
 
+    inter.data()->deferGuards(Pooma::overlapGuards());
     expressionApply(lhs, IntersectorTag<Inter_t>(inter));
     expressionApply(rhs, IntersectorTag<Inter_t>(inter));
+
+    if (inter.data()->deferred() > 0)
+      {
+        typename Inter_t::INodeContainer_t interiors, shells;
+        inter.data()->shells(interiors, shells);
+
+        int n, size = interiors.size();
+        for (n = 0; n < size; ++n)
+          Evaluator<RemoteSinglePatchEvaluatorTag>().
+            evaluate(lhs(interiors[n]), op, rhs(interiors[n]));
+
+        inter.data()->fillDeferred();
+
+        size = shells.size();
+        for (n = 0; n < size; ++n)
+          Evaluator<RemoteSinglePatchEvaluatorTag>().
+            evaluate(lhs(shells[n]), op, rhs(shells[n]));
+
+        return;
+      }
   
     typename Inter_t::const_iterator i = inter.begin();
     while (i != inter.end())
@@ -0,0 +1,348 @@
+// -*- C++ -*-
+//
+// Copyright (C) 1998, 1999, 2000, 2002  Los Alamos National Laboratory,
+// Copyright (C) 1998, 1999, 2000, 2002  CodeSourcery, LLC
+//
+// This file is part of FreePOOMA.
+//
+// FreePOOMA is free software; you can redistribute it and/or modify it
+// under the terms of the Expat license.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the Expat
+// license for more details.
+//
+// You should have received a copy of the Expat license along with
+// FreePOOMA; see the file LICENSE.
+//
+
+//-----------------------------------------------------------------------------
+// TiledCompressibleBrick-Engine non-inline template definitions.
+//-----------------------------------------------------------------------------
+
+#include "Engine/TiledCompressibleBrick.h"
+
+///////////////////////////////////////////////////////////////////////////////
+// namespace Pooma {
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// TiledCompressibleBrick-Engine Member Functions
+//
+///////////////////////////////////////////////////////////////////////////////
+
+
+//-----------------------------------------------------------------------------
+//
+// Engine<Dim,T,TiledCompressibleBrick> constructors:
+//
+//   Engine(const Domain_t &domain)
+//   Engine(const Domain_t &domain, const T &model)
+//   Engine(const Node<Domain_t> &node)
+//   Engine(const Layout_t &layout)
+//
+// Constructs a TiledCompressibleBrick-Engine for the domain and makes
+// one compressed CompressibleBrick for each tile.  The tiles at the
+// upper end of a direction are cut short by the domain.
+//
+//-----------------------------------------------------------------------------
+
+template <int Dim, class T>
+Engine<Dim,T,TiledCompressibleBrick>::Engine(const Domain_t &domain)
+  : domain_m(domain)
+{
+  init(0);
+}
+
+template <int Dim, class T>
+Engine<Dim,T,TiledCompressibleBrick>::
+Engine(const Domain_t &domain, const T &model)
+  : domain_m(domain)
+{
+  init(&model);
+}
+
+template <int Dim, class T>
+Engine<Dim,T,TiledCompressibleBrick>::Engine(const Node<Domain_t> &node)
+  : domain_m(node.allocated())
+{
+  init(0);
+}
+
+template <int Dim, class T>
+Engine<Dim,T,TiledCompressibleBrick>::Engine(const Layout_t &layout)
+  : domain_m(layout.domain())
+{
+  init(0);
+}
+
+template <int Dim, class T>
+void Engine<Dim,T,TiledCompressibleBrick>::init(const T *model)
+{
+  int n = 1;
+  for (int d = 0; d < Dim; ++d)
+    {
+      shift_m[d] = 0;
+      origin_m[d] = domain_m[d].first();
+      counts_m[d] = (domain_m[d].length() + tileExtent - 1) / tileExtent;
+      strides_m[d] = n;
+      n *= counts_m[d];
+    }
+
+  if (n == 0)
+    return;
+
+  tiles_m = DataBlockPtr<Tile_t>(n);
+
+  // Each tile covers its part of the domain, so it can be indexed with
+  // the same indices as this engine.
+
+  Domain_t tiles = tileIndices();
+  typename Domain_t::const_iterator t = tiles.begin(), end = tiles.end();
+  for (; t != end; ++t)
+    {
+      Domain_t piece;
+      for (int d = 0; d < Dim; ++d)
+	{
+	  int first = origin_m[d] + (*t)[d].first() * tileExtent;
+	  int last = std::min(first + tileExtent - 1, domain_m[d].last());
+	  piece[d] = Interval<1>(first, last);
+	}
+      if (model)
+	tile(*t) = Tile_t(piece, *model);
+      else
+	tile(*t) = Tile_t(piece);
+    }
+}
+
+
+//-----------------------------------------------------------------------------
+//
+// Engine<Dim,T,TiledCompressibleBrick> copy and view constructors, and
+// assignment.  These share the tiles.  A view translates its indices
+// to those of the tiles with shift_m.
+//
+//-----------------------------------------------------------------------------
+
+template <int Dim, class T>
+Engine<Dim,T,TiledCompressibleBrick>::Engine(const Engine_t &model)
+  : tiles_m(model.tiles_m), domain_m(model.domain_m)
+{
+  for (int d = 0; d < Dim; ++d)
+    {
+      shift_m[d] = model.shift_m[d];
+      origin_m[d] = model.origin_m[d];
+      counts_m[d] = model.counts_m[d];
+      strides_m[d] = model.strides_m[d];
+    }
+}
+
+template <int Dim, class T>
+Engine<Dim,T,TiledCompressibleBrick>::
+Engine(const Engine_t &model, const Domain_t &domain)
+  : tiles_m(model.tiles_m)
+{
+  PAssert(contains(model.domain(), domain));
+
+  for (int d = 0; d < Dim; ++d)
+    {
+      domain_m[d] = Interval<1>(domain[d].length());
+      shift_m[d] = model.shift_m[d] + domain[d].first();
+      origin_m[d] = model.origin_m[d];
+      counts_m[d] = model.counts_m[d];
+      strides_m[d] = model.strides_m[d];
+    }
+}
+
+template <int Dim, class T>
+Engine<Dim,T,TiledCompressibleBrick>::
+Engine(const Engine_t &model, const INode<Dim> &inode)
+  : tiles_m(model.tiles_m)
+{
+  PAssert(contains(model.domain(), inode.domain()));
+
+  for (int d = 0; d < Dim; ++d)
+    {
+      domain_m[d] = Interval<1>(inode.domain()[d].length());
+      shift_m[d] = model.shift_m[d] + inode.domain()[d].first();
+      origin_m[d] = model.origin_m[d];
+      counts_m[d] = model.counts_m[d];
+      strides_m[d] = model.strides_m[d];
+    }
+}
+
+template <int Dim, class T>
+Engine<Dim,T,TiledCompressibleBrick> &
+Engine<Dim,T,TiledCompressibleBrick>::operator=(const Engine_t &model)
+{
+  if (this != &model)
+    {
+      tiles_m = model.tiles_m;
+      domain_m = model.domain_m;
+      for (int d = 0; d < Dim; ++d)
+	{
+	  shift_m[d] = model.shift_m[d];
+	  origin_m[d] = model.origin_m[d];
+	  counts_m[d] = model.counts_m[d];
+	  strides_m[d] = model.strides_m[d];
+	}
+    }
+  return *this;
+}
+
+
+//-----------------------------------------------------------------------------
+//
+// Engine<Dim,T,TiledCompressibleBrick> & makeOwnCopy()
+//
+// Causes the TiledCompressibleBrick-Engine to obtain a private copy of
+// all of the tiles.  As for CompressibleBricks, this should only be
+// called after a blockAndEvaluate().
+//
+//-----------------------------------------------------------------------------
+
+template <int Dim, class T>
+Engine<Dim,T,TiledCompressibleBrick> &
+Engine<Dim,T,TiledCompressibleBrick>::makeOwnCopy()
+{
+  if (tiles_m.isValid() && tiles_m.isShared())
+    tiles_m.makeOwnCopy();
+
+  return *this;
+}
+
+
+//-----------------------------------------------------------------------------
+//
+// Tile access.  Tile indices count tiles from the start of the domain
+// of the engine that made them.  tileDomain() and tileView() give the
+// part of a tile that this engine sees, in the indices of this engine
+// and of the tile.
+//
+//-----------------------------------------------------------------------------
+
+template <int Dim, class T>
+typename Engine<Dim,T,TiledCompressibleBrick>::Domain_t
+Engine<Dim,T,TiledCompressibleBrick>::tileIndices() const
+{
+  Domain_t tiles;
+  if (domain_m.size() == 0)
+    return tiles;
+
+  for (int d = 0; d < Dim; ++d)
+    {
+      int first = domain_m[d].first() + shift_m[d] - origin_m[d];
+      int last = domain_m[d].last() + shift_m[d] - origin_m[d];
+      tiles[d] = Interval<1>(first / tileExtent, last / tileExtent);
+    }
+  return tiles;
+}
+
+template <int Dim, class T>
+typename Engine<Dim,T,TiledCompressibleBrick>::Domain_t
+Engine<Dim,T,TiledCompressibleBrick>::tileDomain(const Loc<Dim> &tile) const
+{
+  Domain_t piece;
+  for (int d = 0; d < Dim; ++d)
+    {
+      int first = origin_m[d] + tile[d].first() * tileExtent - shift_m[d];
+      int last = first + tileExtent - 1;
+      piece[d] = Interval<1>(std::max(first, domain_m[d].first()),
+			     std::min(last, domain_m[d].last()));
+    }
+  return piece;
+}
+
+template <int Dim, class T>
+typename Engine<Dim,T,TiledCompressibleBrick>::TileView_t
+Engine<Dim,T,TiledCompressibleBrick>::tileView(const Loc<Dim> &t) const
+{
+  Domain_t piece = tileDomain(t);
+  for (int d = 0; d < Dim; ++d)
+    piece[d] = piece[d] + shift_m[d];
+  return TileView_t(tile(t), piece);
+}
+
+template <int Dim, class T>
+typename Engine<Dim,T,TiledCompressibleBrick>::Tile_t &
+Engine<Dim,T,TiledCompressibleBrick>::tile(const Loc<Dim> &t) const
+{
+  int offset = 0;
+  for (int d = 0; d < Dim; ++d)
+    {
+      PAssert(t[d].first() >= 0 && t[d].first() < counts_m[d]);
+      offset += t[d].first() * strides_m[d];
+    }
+  return tiles_m[offset];
+}
+
+
+//-----------------------------------------------------------------------------
+//
+// Compression status of the tiles in view.  The engine counts as
+// compressed if all of these tiles are compressed to the same value.
+//
+//-----------------------------------------------------------------------------
+
+template <int Dim, class T>
+bool Engine<Dim,T,TiledCompressibleBrick>::compressed() const
+{
+  Domain_t tiles = tileIndices();
+  typename Domain_t::const_iterator t = tiles.begin(), end = tiles.end();
+  if (t == end)
+    return false;
+
+  const Tile_t &first = tile(*t);
+  if (!first.compressed())
+    return false;
+
+  for (++t; t != end; ++t)
+    {
+      const Tile_t &e = tile(*t);
+      if (!e.compressed() || e.compressedRead() != first.compressedRead())
+	return false;
+    }
+  return true;
+}
+
+template <int Dim, class T>
+T Engine<Dim,T,TiledCompressibleBrick>::compressedRead() const
+{
+  PAssert(compressed());
+  return tile(*tileIndices().begin()).compressedRead();
+}
+
+template <int Dim, class T>
+long Engine<Dim,T,TiledCompressibleBrick>::elementsCompressed() const
+{
+  long n = 0;
+  Domain_t tiles = tileIndices();
+  typename Domain_t::const_iterator t = tiles.begin(), end = tiles.end();
+  for (; t != end; ++t)
+    if (tile(*t).compressed())
+      n += tileDomain(*t).size();
+  return n;
+}
+
+template <int Dim, class T>
+void Engine<Dim,T,TiledCompressibleBrick>::tryCompress() const
+{
+  Domain_t tiles = tileIndices();
+  typename Domain_t::const_iterator t = tiles.begin(), end = tiles.end();
+  for (; t != end; ++t)
+    tile(*t).tryCompress();
+}
+
+template <int Dim, class T>
+void Engine<Dim,T,TiledCompressibleBrick>::uncompress() const
+{
+  Domain_t tiles = tileIndices();
+  typename Domain_t::const_iterator t = tiles.begin(), end = tiles.end();
+  for (; t != end; ++t)
+    tile(*t).uncompress();
+}
+
+// } // namespace Pooma
+///////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,567 @@
+// -*- C++ -*-
+//
+// Copyright (C) 1998, 1999, 2000, 2002  Los Alamos National Laboratory,
+// Copyright (C) 1998, 1999, 2000, 2002  CodeSourcery, LLC
+//
+// This file is part of FreePOOMA.
+//
+// FreePOOMA is free software; you can redistribute it and/or modify it
+// under the terms of the Expat license.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the Expat
+// license for more details.
+//
+// You should have received a copy of the Expat license along with
+// FreePOOMA; see the file LICENSE.
+//
+
+
+/** @file
+ * @ingroup Engine
+ * @brief
+ * TiledCompressibleBrick engine.
+ *
+ * Classes:
+ *  - TiledCompressibleBrick, TiledCompressibleBrick-Engine specialization
+ *    tag.
+ *  - CompressibleTile<Dim>, the extent of the tiles.
+ *  - Engine<Dim,T,TiledCompressibleBrick>, the "TiledCompressibleBrick-Engine"
+ *    specialization.
+ *  - NewEngine<Engine,SubDomain>, specializations for
+ *    TiledCompressibleBrick-Engine.
+ */
+
+#ifndef POOMA_ENGINE_TILEDCOMPRESSIBLEBRICK_H
+#define POOMA_ENGINE_TILEDCOMPRESSIBLEBRICK_H
+
+//-----------------------------------------------------------------------------
+// Includes:
+//-----------------------------------------------------------------------------
+
+#include "Domain/Interval.h"
+#include "Domain/Loc.h"
+#include "Domain/Contains.h"
+#include "Engine/CompressibleBrick.h"
+#include "Engine/Engine.h"
+#include "Layout/DomainLayout.h"
+#include "Layout/Node.h"
+#include "Layout/INode.h"
+#include "Utilities/DataBlockPtr.h"
+#include "Utilities/PAssert.h"
+#include <algorithm>
+
+
+///////////////////////////////////////////////////////////////////////////////
+// namespace Pooma {
+
+/**
+ * This is the tag class used to select the "TiledCompressibleBrick"
+ * specialization of the Engine class template.
+ */
+
+struct TiledCompressibleBrick { };
+
+/**
+ * CompressibleTile<Dim>::extent is the length of the tiles of a
+ * TiledCompressibleBrick in each direction.  The tiles hold 256 to 1024
+ * elements for up to three dimensions, so a tile that cannot be
+ * compressed is still cheap to sweep.
+ */
+
+template <int Dim>
+struct CompressibleTile
+{
+  enum { extent = (Dim == 1 ? 512 : (Dim == 2 ? 32 : (Dim == 3 ? 8 : 4))) };
+};
+
+/**
+ * Engine<Dim,T,TiledCompressibleBrick>  (aka TiledCompressibleBrick-Engine)
+ *
+ * Engine<Dim,T,TiledCompressibleBrick> is an Engine that cuts a local,
+ * Dim-dimensional brick of data into tiles of CompressibleTile<Dim>::extent
+ * elements in each direction.  Every tile is a CompressibleBrick of its
+ * own, so a tile holding a single value is stored as just that value
+ * even where the rest of the brick is not.  This suits data that is
+ * constant over most, but not all, of the domain.
+ *
+ * Template Parameters:
+ *  - Dim: An integer for the dimension of the TiledCompressibleBrick.
+ *  - T:   The type of object stored.  T needs a copy constructor,
+ *         assignment and operator!=.
+ *
+ * The Domain of this engine is an Interval<Dim>.  Views through an
+ * Interval<Dim> or an INode<Dim> are TiledCompressibleBricks again that
+ * share the tiles and are zero-based.  Strided and sliced views are not
+ * supported, so the engine cannot be used for the patches of a
+ * MultiPatch engine, which views its patches through Ranges.
+ *
+ * Assignments to a TiledCompressibleBrick are done one tile at a time by
+ * KernelEvaluator<TiledCompressibleKernelTag>, which uses compressed
+ * assignment for the tiles on which the right-hand side is compressed.
+ * Reductions skip compressed tiles in the same way.  Writing single
+ * elements through operator() uncompresses the tile that holds them;
+ * compress() tries to compress all of the tiles again.
+ */
+
+template <int Dim, class T>
+class Engine<Dim, T, TiledCompressibleBrick>
+{
+public:
+
+  //============================================================
+  // Exported typedefs and constants
+  //============================================================
+
+  typedef Engine<Dim,T,TiledCompressibleBrick>  This_t;
+  typedef Engine<Dim,T,TiledCompressibleBrick>  Engine_t;
+  typedef Interval<Dim>                         Domain_t;
+  typedef DomainLayout<Dim>                     Layout_t;
+  typedef T                                     Element_t;
+  typedef T&                                    ElementRef_t;
+  typedef TiledCompressibleBrick                Tag_t;
+  typedef Engine<Dim,T,CompressibleBrick>       Tile_t;
+  typedef Engine<Dim,T,CompressibleBrickView>   TileView_t;
+
+  enum { dimensions    = Dim   };
+  enum { hasDataObject = true  };
+  enum { dynamic       = false };
+  enum { zeroBased     = false };
+  enum { multiPatch    = false };
+  enum { tileExtent    = CompressibleTile<Dim>::extent };
+
+  //============================================================
+  // Constructors and Factory Methods
+  //============================================================
+
+  // Default constructor. Creates a TiledCompressibleBrick-Engine with no
+  // data and an "empty" domain.
+
+  Engine() { }
+
+  // Construct a TiledCompressibleBrick-Engine for a domain, given directly
+  // or through a Node or Layout_t object. The tiles are born compressed,
+  // holding the model element if one is given.
+
+  explicit Engine(const Domain_t &domain);
+  Engine(const Domain_t &domain, const T &elementModel);
+  explicit Engine(const Layout_t &layout);
+  explicit Engine(const Node<Domain_t> &node);
+
+  // Copy constructor performs a SHALLOW copy.
+
+  Engine(const Engine_t &model);
+
+  // Subsetting Constructors. The view shares the tiles of the model and
+  // is zero-based.
+
+  Engine(const Engine_t &model, const Domain_t &domain);
+  Engine(const Engine_t &model, const INode<Dim> &inode);
+
+  //============================================================
+  // Assignment operators
+  //============================================================
+
+  // Assigment is SHALLOW, to be consistent with copy.
+
+  Engine_t &operator=(const Engine_t &model);
+
+  //============================================================
+  // Accessor and Mutator functions:
+  //============================================================
+
+  // Element access via ints. These find the tile holding the element
+  // and pass the request on to it, so writing an element uncompresses
+  // its tile.
+
+  ElementRef_t operator()(int) const;
+  ElementRef_t operator()(int, int) const;
+  ElementRef_t operator()(int, int, int) const;
+  ElementRef_t operator()(int, int, int, int) const;
+  ElementRef_t operator()(int, int, int, int, int) const;
+  ElementRef_t operator()(int, int, int, int, int, int) const;
+  ElementRef_t operator()(int, int, int, int, int, int, int) const;
+
+  Element_t read(int) const;
+  Element_t read(int, int) const;
+  Element_t read(int, int, int) const;
+  Element_t read(int, int, int, int) const;
+  Element_t read(int, int, int, int, int) const;
+  Element_t read(int, int, int, int, int, int) const;
+  Element_t read(int, int, int, int, int, int, int) const;
+
+  // Element access via Loc.
+
+  ElementRef_t operator()(const Loc<Dim> &) const;
+  Element_t read(const Loc<Dim> &) const;
+
+  // Return the domain and the layout.
+
+  inline const Domain_t &domain() const { return domain_m; }
+
+  inline Layout_t layout() const { return Layout_t(domain_m); }
+
+  // Get a private copy of the tiles viewed by this Engine.
+
+  Engine_t &makeOwnCopy();
+
+  // Provide access to the data object. There is one for all the tiles.
+
+  Pooma::DataObject_t *dataObject() const { return tiles_m.dataObject(); }
+
+  //============================================================
+  // Tiles
+  //============================================================
+
+  // Return the indices of the tiles this engine touches.
+
+  Domain_t tileIndices() const;
+
+  // Return the part of the domain of this engine that lies in a tile.
+
+  Domain_t tileDomain(const Loc<Dim> &tile) const;
+
+  // Return a zero-based view of the same part of a tile.
+
+  TileView_t tileView(const Loc<Dim> &tile) const;
+
+  //============================================================
+  // Compressibility-related Accessors & Mutators
+  //============================================================
+
+  // As for CompressibleBricks, these report the state of the tiles at
+  // one point in time.
+
+  // Check if all the tiles in view are compressed to the same value.
+
+  bool compressed() const;
+
+  // Return the compressed value. Only valid if compressed() is true.
+
+  T compressedRead() const;
+
+  // Return the number of elements in view in compressed tiles.
+
+  long elementsCompressed() const;
+
+  // Try to compress or manually uncompress the tiles in view.
+
+  void tryCompress() const;
+  void uncompress() const;
+
+private:
+
+  // Set up the tiles of a new engine.
+
+  void init(const T *model);
+
+  // Return the tile with the given tile indices, and the contribution of
+  // the element with base index i in direction d to the tile's offset.
+
+  Tile_t &tile(const Loc<Dim> &tile) const;
+
+  inline int tileOffset(int d, int i) const
+  {
+    return (i - origin_m[d]) / tileExtent * strides_m[d];
+  }
+
+  //============================================================
+  // Data
+  //============================================================
+
+  // The tiles, in Fortran order.
+
+  DataBlockPtr<Tile_t> tiles_m;
+
+  // The domain of this engine.
+
+  Domain_t domain_m;
+
+  // Index i of this engine is index i + shift_m of the engine that
+  // created the tiles, whose domain started at origin_m.
+
+  int shift_m[Dim];
+  int origin_m[Dim];
+
+  // The number of tiles in each direction and the tile strides.
+
+  int counts_m[Dim];
+  int strides_m[Dim];
+};
+
+/**
+ * NewEngine<Engine,SubDomain>
+ *
+ * Specializations of NewEngine for subsetting a TiledCompressibleBrick
+ * with an Interval<Dim> or an INode<Dim>.
+ */
+
+template <int Dim, class T>
+struct NewEngine<Engine<Dim,T,TiledCompressibleBrick>, Interval<Dim> >
+{
+  typedef Engine<Dim,T,TiledCompressibleBrick> Type_t;
+};
+
+template <int Dim, class T>
+struct NewEngine<Engine<Dim,T,TiledCompressibleBrick>, INode<Dim> >
+{
+  typedef Engine<Dim,T,TiledCompressibleBrick> Type_t;
+};
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Inline implementation of the functions for
+// Engine<D,T,TiledCompressibleBrick>
+//
+///////////////////////////////////////////////////////////////////////////////
+
+template <int Dim, class T>
+inline T & Engine<Dim,T,TiledCompressibleBrick>::
+operator()(const Loc<Dim> &loc) const
+{
+  Loc<Dim> i;
+  int t = 0;
+  for (int d = 0; d < Dim; ++d)
+    {
+      i[d] = loc[d].first() + shift_m[d];
+      t += tileOffset(d, i[d].first());
+    }
+  return tiles_m[t](i);
+}
+
+template <int Dim, class T>
+inline T & Engine<Dim,T,TiledCompressibleBrick>::
+operator()(int i1) const
+{
+  PAssert(Dim == 1);
+  i1 += shift_m[0];
+  return tiles_m[tileOffset(0, i1)](i1);
+}
+
+template <int Dim, class T>
+inline T & Engine<Dim,T,TiledCompressibleBrick>::
+operator()(int i1, int i2) const
+{
+  PAssert(Dim == 2);
+  i1 += shift_m[0];
+  i2 += shift_m[1];
+  return tiles_m[tileOffset(0, i1) + tileOffset(1, i2)](i1, i2);
+}
+
+template <int Dim, class T>
+inline T & Engine<Dim,T,TiledCompressibleBrick>::
+operator()(int i1, int i2, int i3) const
+{
+  PAssert(Dim == 3);
+  i1 += shift_m[0];
+  i2 += shift_m[1];
+  i3 += shift_m[2];
+  return tiles_m[tileOffset(0, i1) + tileOffset(1, i2) + tileOffset(2, i3)]
+    (i1, i2, i3);
+}
+
+template <int Dim, class T>
+inline T & Engine<Dim,T,TiledCompressibleBrick>::
+operator()(int i1, int i2, int i3, int i4) const
+{
+  PAssert(Dim == 4);
+  i1 += shift_m[0];
+  i2 += shift_m[1];
+  i3 += shift_m[2];
+  i4 += shift_m[3];
+  return tiles_m[tileOffset(0, i1) + tileOffset(1, i2) + tileOffset(2, i3)
+		 + tileOffset(3, i4)](i1, i2, i3, i4);
+}
+
+template <int Dim, class T>
+inline T & Engine<Dim,T,TiledCompressibleBrick>::
+operator()(int i1, int i2, int i3, int i4, int i5) const
+{
+  PAssert(Dim == 5);
+  i1 += shift_m[0];
+  i2 += shift_m[1];
+  i3 += shift_m[2];
+  i4 += shift_m[3];
+  i5 += shift_m[4];
+  return tiles_m[tileOffset(0, i1) + tileOffset(1, i2) + tileOffset(2, i3)
+		 + tileOffset(3, i4) + tileOffset(4, i5)](i1, i2, i3, i4, i5);
+}
+
+template <int Dim, class T>
+inline T & Engine<Dim,T,TiledCompressibleBrick>::
+operator()(int i1, int i2, int i3, int i4, int i5, int i6) const
+{
+  PAssert(Dim == 6);
+  i1 += shift_m[0];
+  i2 += shift_m[1];
+  i3 += shift_m[2];
+  i4 += shift_m[3];
+  i5 += shift_m[4];
+  i6 += shift_m[5];
+  return tiles_m[tileOffset(0, i1) + tileOffset(1, i2) + tileOffset(2, i3)
+		 + tileOffset(3, i4) + tileOffset(4, i5) + tileOffset(5, i6)]
+    (i1, i2, i3, i4, i5, i6);
+}
+
+template <int Dim, class T>
+inline T & Engine<Dim,T,TiledCompressibleBrick>::
+operator()(int i1, int i2, int i3, int i4, int i5, int i6, int i7) const
+{
+  PAssert(Dim == 7);
+  i1 += shift_m[0];
+  i2 += shift_m[1];
+  i3 += shift_m[2];
+  i4 += shift_m[3];
+  i5 += shift_m[4];
+  i6 += shift_m[5];
+  i7 += shift_m[6];
+  return tiles_m[tileOffset(0, i1) + tileOffset(1, i2) + tileOffset(2, i3)
+		 + tileOffset(3, i4) + tileOffset(4, i5) + tileOffset(5, i6)
+		 + tileOffset(6, i7)](i1, i2, i3, i4, i5, i6, i7);
+}
+
+template <int Dim, class T>
+inline T Engine<Dim,T,TiledCompressibleBrick>::
+read(const Loc<Dim> &loc) const
+{
+  Loc<Dim> i;
+  int t = 0;
+  for (int d = 0; d < Dim; ++d)
+    {
+      i[d] = loc[d].first() + shift_m[d];
+      t += tileOffset(d, i[d].first());
+    }
+  return tiles_m[t].read(i);
+}
+
+template <int Dim, class T>
+inline T Engine<Dim,T,TiledCompressibleBrick>::
+read(int i1) const
+{
+  PAssert(Dim == 1);
+  i1 += shift_m[0];
+  return tiles_m[tileOffset(0, i1)].read(i1);
+}
+
+template <int Dim, class T>
+inline T Engine<Dim,T,TiledCompressibleBrick>::
+read(int i1, int i2) const
+{
+  PAssert(Dim == 2);
+  i1 += shift_m[0];
+  i2 += shift_m[1];
+  return tiles_m[tileOffset(0, i1) + tileOffset(1, i2)].read(i1, i2);
+}
+
+template <int Dim, class T>
+inline T Engine<Dim,T,TiledCompressibleBrick>::
+read(int i1, int i2, int i3) const
+{
+  PAssert(Dim == 3);
+  i1 += shift_m[0];
+  i2 += shift_m[1];
+  i3 += shift_m[2];
+  return tiles_m[tileOffset(0, i1) + tileOffset(1, i2) + tileOffset(2, i3)]
+    .read(i1, i2, i3);
+}
+
+template <int Dim, class T>
+inline T Engine<Dim,T,TiledCompressibleBrick>::
+read(int i1, int i2, int i3, int i4) const
+{
+  PAssert(Dim == 4);
+  i1 += shift_m[0];
+  i2 += shift_m[1];
+  i3 += shift_m[2];
+  i4 += shift_m[3];
+  return tiles_m[tileOffset(0, i1) + tileOffset(1, i2) + tileOffset(2, i3)
+		 + tileOffset(3, i4)].read(i1, i2, i3, i4);
+}
+
+template <int Dim, class T>
+inline T Engine<Dim,T,TiledCompressibleBrick>::
+read(int i1, int i2, int i3, int i4, int i5) const
+{
+  PAssert(Dim == 5);
+  i1 += shift_m[0];
+  i2 += shift_m[1];
+  i3 += shift_m[2];
+  i4 += shift_m[3];
+  i5 += shift_m[4];
+  return tiles_m[tileOffset(0, i1) + tileOffset(1, i2) + tileOffset(2, i3)
+		 + tileOffset(3, i4) + tileOffset(4, i5)].read(i1, i2, i3, i4, i5);
+}
+
+template <int Dim, class T>
+inline T Engine<Dim,T,TiledCompressibleBrick>::
+read(int i1, int i2, int i3, int i4, int i5, int i6) const
+{
+  PAssert(Dim == 6);
+  i1 += shift_m[0];
+  i2 += shift_m[1];
+  i3 += shift_m[2];
+  i4 += shift_m[3];
+  i5 += shift_m[4];
+  i6 += shift_m[5];
+  return tiles_m[tileOffset(0, i1) + tileOffset(1, i2) + tileOffset(2, i3)
+		 + tileOffset(3, i4) + tileOffset(4, i5) + tileOffset(5, i6)]
+    .read(i1, i2, i3, i4, i5, i6);
+}
+
+template <int Dim, class T>
+inline T Engine<Dim,T,TiledCompressibleBrick>::
+read(int i1, int i2, int i3, int i4, int i5, int i6, int i7) const
+{
+  PAssert(Dim == 7);
+  i1 += shift_m[0];
+  i2 += shift_m[1];
+  i3 += shift_m[2];
+  i4 += shift_m[3];
+  i5 += shift_m[4];
+  i6 += shift_m[5];
+  i7 += shift_m[6];
+  return tiles_m[tileOffset(0, i1) + tileOffset(1, i2) + tileOffset(2, i3)
+		 + tileOffset(3, i4) + tileOffset(4, i5) + tileOffset(5, i6)
+		 + tileOffset(6, i7)].read(i1, i2, i3, i4, i5, i6, i7);
+}
+
+
+//
+// Free functions returning compressed status or doing compress/uncompress.
+//
+
+template <int Dim, class T>
+inline bool compressed(const Engine<Dim, T, TiledCompressibleBrick> &e)
+{
+  return e.compressed();
+}
+
+template <int Dim, class T>
+inline long
+elementsCompressed(const Engine<Dim, T, TiledCompressibleBrick> &e)
+{
+  return e.elementsCompressed();
+}
+
+template <int Dim, class T>
+inline void compress(Engine<Dim, T, TiledCompressibleBrick> &e)
+{
+  e.tryCompress();
+}
+
+template <int Dim, class T>
+inline void uncompress(Engine<Dim, T, TiledCompressibleBrick> &e)
+{
+  e.uncompress();
+}
+
+// } // namespace Pooma
+///////////////////////////////////////////////////////////////////////////////
+
+// Include .cpp file to get out-of-line functions.
+
+#include "Engine/TiledCompressibleBrick.cpp"
+
+#endif // POOMA_ENGINE_TILEDCOMPRESSIBLEBRICK_H
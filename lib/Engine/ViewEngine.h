@@ -495,9 +495,9 @@ public:
 
   // STL iterator support.
   
-  inline const_iterator begin() const { return data()->inodes_m.begin(); }
+  inline const_iterator begin() const { return data()->begin(); }
   
-  inline const_iterator end() const { return data()->inodes_m.end(); }
+  inline const_iterator end() const { return data()->end(); }
   
 
   //===========================================================================
@@ -510,6 +510,8 @@ public:
   inline
   void intersect(const Engine &e) 
   {
+    data()->resolve();
+
     int n = data()->ids_m.size();
 
     typedef INode<ViewD2> INode2_t;
@@ -25,6 +25,7 @@
 // CompressedReadWrite
 // CompressedBrickIsWholeView
 // UnCompressedViewEngine
+// TiledCompressible
 //
 // Classes:
 // EngineFunctor<Engine,Tag>  for above tags.
@@ -75,6 +76,7 @@ struct Brick;
 struct BrickView;
 struct CompressibleBrick;
 struct CompressibleBrickView;
+struct TiledCompressibleBrick;
 template<class Eng, class Components> struct CompFwd;
 template<class A1,class A2> struct IndirectionTag;
 struct ConstantFunction;
@@ -113,6 +115,10 @@ template<class Stencil, class Expression> struct StencilEngine;
  * bool compressedBrickIsWholeView(const Engine &)
  * typedef ... ViewEngine_t; - Tag for efficient uncompressed view engine.
  * ViewEngine_t viewEngine(const Engine &) - an uncompressed view.
+ *
+ * TiledCompressibleBricks only support the first two, as they are
+ * written one tile at a time.  TiledCompressible<Engine> tells if an
+ * engine is, or an expression contains, a TiledCompressibleBrick.
  */
 
 struct Compressible
@@ -145,6 +151,11 @@ struct UnCompressedViewEngine
   //  typedef NullCombine Combine_t;
 };
 
+struct TiledCompressible
+{
+  typedef OrCombine Combine_t;
+};
+
 //-----------------------------------------------------------------------------
 //-----------------------------------------------------------------------------
 
@@ -160,6 +171,18 @@ struct Combine2<WrappedInt<A>, WrappedInt<B>, Op, AndCombine>
   }
 };
 
+template<int A, int B, class Op>
+struct Combine2<WrappedInt<A>, WrappedInt<B>, Op, OrCombine>
+{
+  enum { val = A || B };
+  typedef WrappedInt<val> Type_t;
+  inline static
+  Type_t combine(WrappedInt<A> , WrappedInt<B>, OrCombine)
+  {
+    return Type_t();
+  }
+};
+
 //-----------------------------------------------------------------------------
 // PETE functors to check the compression status of an expression.
 //-----------------------------------------------------------------------------
@@ -200,6 +223,20 @@ struct EngineFunctorScalar<T, Compressed >
   }
 };
 
+/**
+ * Scalars are not tiled.
+ */
+
+template<class T>
+struct EngineFunctorScalar<T, TiledCompressible >
+{
+  typedef WrappedInt<false> Type_t;
+  static Type_t apply(const T &, const TiledCompressible &)
+  {
+    return Type_t();
+  }
+};
+
 /**
  * PETE functors to perform compressed assignment.
  */
@@ -230,6 +267,12 @@ struct EngineFunctorDefault<Engine,Compressible>
   typedef WrappedInt<false> Type_t;
 };
 
+template<class Engine>
+struct EngineFunctorDefault<Engine,TiledCompressible>
+{
+  typedef WrappedInt<false> Type_t;
+};
+
 template<class Engine>
 struct EngineFunctorDefault<Engine,Compressed>
 {
@@ -408,6 +451,52 @@ struct EngineFunctor<Engine<Dim,T,CompressibleBrickView >,
   }
 };
     
+/**
+ * TiledCompressibleBricks are compressed if all of the tiles in view are
+ * compressed to the same value, so they can appear on the right-hand
+ * side of compressed assignments.
+ */
+
+template<int Dim, class T>
+struct EngineFunctor<Engine<Dim,T,TiledCompressibleBrick>,Compressible>
+{
+  typedef WrappedInt<true> Type_t;
+};
+
+template<int Dim, class T>
+struct EngineFunctor<Engine<Dim,T,TiledCompressibleBrick>,TiledCompressible>
+{
+  typedef WrappedInt<true> Type_t;
+};
+
+template<int Dim, class T>
+struct EngineFunctor<Engine<Dim,T,TiledCompressibleBrick>,Compressed>
+{
+  typedef Engine<Dim,T,TiledCompressibleBrick> Engine_t;
+
+  typedef bool Type_t;
+
+  static inline
+  Type_t apply(const Engine_t &e, const Compressed &)
+  {
+    return e.compressed();
+  }
+};
+
+template<int Dim, class T>
+struct EngineFunctor<Engine<Dim,T,TiledCompressibleBrick>,CompressedRead>
+{
+  typedef Engine<Dim,T,TiledCompressibleBrick> Engine_t;
+
+  typedef T Type_t;
+
+  static inline
+  Type_t apply(const Engine_t &e, const CompressedRead &)
+  {
+    return e.compressedRead();
+  }
+};
+
 /**
  * Constant function engine is definitely compressed. (You can't write to it,
  * though.)
@@ -463,6 +552,26 @@ struct EngineFunctor<Engine<Dim,T,CompFwd<Eng, Components> >,Compressible>
   typedef WrappedInt<compressible> Type_t;
 };
 
+/**
+ * Components of TiledCompressibleBricks are written element by element,
+ * so they do not count as compressible.
+ */
+
+template<int Dim, class T, int Dim2, class T2, class Components>
+struct EngineFunctor<Engine<Dim,T,
+  CompFwd<Engine<Dim2,T2,TiledCompressibleBrick>, Components> >,Compressible>
+{
+  typedef WrappedInt<false> Type_t;
+};
+
+template<int Dim, class T, int Dim2, class T2, class Components>
+struct EngineFunctor<Engine<Dim,T,
+  CompFwd<Engine<Dim2,T2,TiledCompressibleBrick>, Components> >,
+  TiledCompressible>
+{
+  typedef WrappedInt<false> Type_t;
+};
+
 template<int Dim, class T, class Eng, class Components>
 struct EngineFunctor<Engine<Dim,T,CompFwd<Eng, Components> >,CompressedRead>
 {
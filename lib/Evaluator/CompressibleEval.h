@@ -42,6 +42,10 @@
  * with CompressibleEvalTag, which checks the compression status and perhaps
  * performs a compressed assign.
  *
+ * TiledCompressibleBricks are assigned to with TiledCompressibleKernelTag,
+ * which uses one of the two on each tile in turn, so compressed tiles
+ * are handled as cheaply as whole compressed blocks.
+ *
  * This file should really be called CompressibleKernel.h.
  */
 
@@ -55,6 +59,8 @@
 
 #include "PETE/PETE.h"
 #include "Engine/CompressibleBrick.h"
+#include "Engine/TiledCompressibleBrick.h"
+#include "Pooma/View.h"
 #include "Evaluator/KernelTags.h"
 #include "Evaluator/CompressibleEngines.h"
 #include "Evaluator/InlineEvaluator.h"
@@ -153,6 +159,36 @@ struct KernelEvaluator<CompressibleKernelTag>
   }
 };
 
+template<>
+struct KernelEvaluator<TiledCompressibleKernelTag>
+{
+  template<class LHS, class Op, class RHS>
+  static void evaluate(const LHS &lhs, const Op &op, const RHS &rhs)
+  {
+    // Each tile of the left-hand side is a CompressibleBrick, so we take
+    // a view of the tile and the matching view of the right-hand side
+    // and evaluate them as we would whole CompressibleBricks.  A tile is
+    // only uncompressed if the right-hand side is not compressed on it,
+    // and tries to compress itself again when we are done with it.
+
+    typedef typename LHS::Engine_t LHSEngine_t;
+    typedef typename LHSEngine_t::Domain_t Domain_t;
+    typedef typename View1<RHS, Domain_t>::Type_t RHSView_t;
+    typedef typename RHSView_t::Engine_t RHSEngine_t;
+    typedef typename EngineFunctor<RHSEngine_t,Compressible>::Type_t RHST_t;
+    typedef typename CompressibleKernel<true, RHST_t::val>::Kernel_t Kernel_t;
+
+    const LHSEngine_t &e = lhs.engine();
+    Domain_t tiles = e.tileIndices();
+    typename Domain_t::const_iterator t = tiles.begin(), end = tiles.end();
+    for (; t != end; ++t)
+      {
+	RHSView_t r = rhs(e.tileDomain(*t));
+	KernelEvaluator<Kernel_t>::evaluate(e.tileView(*t), op, r);
+      }
+  }
+};
+
 #endif
 
 // ACL:rcsinfo
@@ -0,0 +1,130 @@
+// -*- C++ -*-
+//
+// Copyright (C) 1998, 1999, 2000, 2002  Los Alamos National Laboratory,
+// Copyright (C) 1998, 1999, 2000, 2002  CodeSourcery, LLC
+//
+// This file is part of FreePOOMA.
+//
+// FreePOOMA is free software; you can redistribute it and/or modify it
+// under the terms of the Expat license.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the Expat
+// license for more details.
+//
+// You should have received a copy of the Expat license along with
+// FreePOOMA; see the file LICENSE.
+//
+
+//-----------------------------------------------------------------------------
+// Classes:
+// ElementCost<T>
+//-----------------------------------------------------------------------------
+
+#ifndef POOMA_EVALUATOR_ELEMENTCOST_H
+#define POOMA_EVALUATOR_ELEMENTCOST_H
+
+/** @file
+ * @ingroup Evaluator
+ * @brief
+ * ElementCost<T>::cost is a compile-time estimate of the work needed to
+ * compute one element of an engine, array or expression.  The evaluators
+ * multiply it with the number of elements in a loop nest and only open an
+ * OpenMP parallel region if the product exceeds Pooma::ompThreshold().
+ */
+
+//-----------------------------------------------------------------------------
+// Includes:
+//-----------------------------------------------------------------------------
+
+#include "PETE/PETE.h"
+
+//-----------------------------------------------------------------------------
+// Forward Declarations:
+//-----------------------------------------------------------------------------
+
+template<int Dim, class T, class EngineTag> class Engine;
+template<int Dim, class T, class EngineTag> class Array;
+template<class Expr> struct ExpressionTag;
+template<class Function, class Expression> struct StencilEngine;
+
+
+/**
+ * The cost is counted in units of one memory access or one arithmetic
+ * operation.  Anything that is not known to be more expensive, such as a
+ * leaf of an expression or a user functor, costs one unit.  Specialize
+ * ElementCost for engines or functors that do much more work per element.
+ */
+
+template<class T>
+struct ElementCost
+{
+  enum { cost = 1 };
+};
+
+template<class T>
+struct ElementCost<Scalar<T> >
+{
+  enum { cost = 0 };
+};
+
+template<class T>
+struct ElementCost<Reference<T> >
+{
+  enum { cost = ElementCost<T>::cost };
+};
+
+template<class Op, class Child>
+struct ElementCost<UnaryNode<Op, Child> >
+{
+  enum { cost = 1 + ElementCost<Child>::cost };
+};
+
+template<class Op, class Left, class Right>
+struct ElementCost<BinaryNode<Op, Left, Right> >
+{
+  enum { cost = 1 + ElementCost<Left>::cost + ElementCost<Right>::cost };
+};
+
+template<class Op, class Left, class Middle, class Right>
+struct ElementCost<TrinaryNode<Op, Left, Middle, Right> >
+{
+  enum { cost = 1 + ElementCost<Left>::cost + ElementCost<Middle>::cost
+	 + ElementCost<Right>::cost };
+};
+
+template<int Dim, class T, class EngineTag>
+struct ElementCost<Array<Dim, T, EngineTag> >
+{
+  enum { cost = ElementCost<Engine<Dim, T, EngineTag> >::cost };
+};
+
+template<int Dim, class T, class Expr>
+struct ElementCost<Engine<Dim, T, ExpressionTag<Expr> > >
+{
+  enum { cost = ElementCost<Expr>::cost };
+};
+
+// A stencil reads several neighbors of every element.  We assume a
+// nearest-neighbor stencil with one operation per point.
+
+template<int Dim, class T, class Function, class Expression>
+struct ElementCost<Engine<Dim, T, StencilEngine<Function, Expression> > >
+{
+  enum { cost = 2 * (2 * Dim + 1) * ElementCost<Expression>::cost };
+};
+
+
+/**
+ * AssignCost is the cost of evaluating op(lhs(i), rhs(i)) for one element.
+ */
+
+template<class LHS, class RHS>
+struct AssignCost
+{
+  enum { cost = 1 + ElementCost<LHS>::cost + ElementCost<RHS>::cost };
+};
+
+
+#endif // POOMA_EVALUATOR_ELEMENTCOST_H
@@ -46,6 +46,15 @@ struct BrickView;
 
 struct CompressibleBrick;
 struct CompressibleBrickView;
+struct TiledCompressibleBrick;
+struct ComponentBrick;
+struct ComponentBrickView;
+template<class S>
+struct MixedPrecisionBrick;
+template<class S>
+struct MixedPrecisionBrickView;
+struct MappedBrick;
+struct MappedBrickView;
 
 struct Dynamic;
 struct DynamicView;
@@ -59,6 +68,8 @@ template<class Functor>
 struct IndexFunction;
 template<int Dim2, class Functor>
 struct IndexFunctionView;
+template<class Functor>
+struct CachedIndexFunction;
 
 template<class Eng, class Components>
 struct CompFwd;
@@ -219,6 +230,14 @@ struct EvaluatorEngineTraits<IndexFunctionView<Dim2, Functor> >
   typedef SinglePatchEvaluatorTag Evaluator_t;
 };
 
+template<class Functor>
+struct EvaluatorEngineTraits<CachedIndexFunction<Functor> >
+{
+  EvaluatorEngineTraits() {}
+  ~EvaluatorEngineTraits() {}
+  typedef SinglePatchEvaluatorTag Evaluator_t;
+};
+
 template<>
 struct EvaluatorEngineTraits<Brick>
 {
@@ -251,6 +270,62 @@ struct EvaluatorEngineTraits<CompressibleBrickView>
   typedef SinglePatchEvaluatorTag Evaluator_t;
 };
 
+template<>
+struct EvaluatorEngineTraits<TiledCompressibleBrick>
+{
+  EvaluatorEngineTraits() {}
+  ~EvaluatorEngineTraits() {}
+  typedef SinglePatchEvaluatorTag Evaluator_t;
+};
+
+template<>
+struct EvaluatorEngineTraits<ComponentBrick>
+{
+  EvaluatorEngineTraits() {}
+  ~EvaluatorEngineTraits() {}
+  typedef SinglePatchEvaluatorTag Evaluator_t;
+};
+
+template<>
+struct EvaluatorEngineTraits<ComponentBrickView>
+{
+  EvaluatorEngineTraits() {}
+  ~EvaluatorEngineTraits() {}
+  typedef SinglePatchEvaluatorTag Evaluator_t;
+};
+
+template<class S>
+struct EvaluatorEngineTraits<MixedPrecisionBrick<S> >
+{
+  EvaluatorEngineTraits() {}
+  ~EvaluatorEngineTraits() {}
+  typedef SinglePatchEvaluatorTag Evaluator_t;
+};
+
+template<class S>
+struct EvaluatorEngineTraits<MixedPrecisionBrickView<S> >
+{
+  EvaluatorEngineTraits() {}
+  ~EvaluatorEngineTraits() {}
+  typedef SinglePatchEvaluatorTag Evaluator_t;
+};
+
+template<>
+struct EvaluatorEngineTraits<MappedBrick>
+{
+  EvaluatorEngineTraits() {}
+  ~EvaluatorEngineTraits() {}
+  typedef SinglePatchEvaluatorTag Evaluator_t;
+};
+
+template<>
+struct EvaluatorEngineTraits<MappedBrickView>
+{
+  EvaluatorEngineTraits() {}
+  ~EvaluatorEngineTraits() {}
+  typedef SinglePatchEvaluatorTag Evaluator_t;
+};
+
 template<>
 struct EvaluatorEngineTraits<Dynamic>
 {
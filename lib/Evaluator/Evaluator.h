@@ -41,10 +41,13 @@
 
 #include "Evaluator/CompressibleEval.h"
 #include "Evaluator/ExpressionKernel.h"
+#include "Evaluator/ParallelPatchKernel.h"
+#include "Evaluator/PatchCosts.h"
 #include "Evaluator/EvaluatorTags.h"
 #include "Engine/Intersector.h"
 #include "Engine/IntersectEngine.h"
 #include "Engine/NotifyEngineWrite.h"
+#include "Utilities/Clock.h"
 
 //-----------------------------------------------------------------------------
 // Forward Declarations:
@@ -176,19 +179,143 @@ struct Evaluator<MultiPatchEvaluatorTag>
     typedef Intersector<LHS::dimensions> Inter_t;
     Inter_t inter;
 
+    inter.data()->deferGuards(Pooma::overlapGuards());
     expressionApply(lhs, IntersectorTag<Inter_t>(inter));
     expressionApply(rhs, IntersectorTag<Inter_t>(inter));
+
+    PatchCosts<LHS::dimensions> *costs = 0;
+    if (PatchCosts<LHS::dimensions>::any())
+      costs = PatchCosts<LHS::dimensions>::find(inter.data()->baseIDs()[0]);
   
-    typename Inter_t::const_iterator i = inter.begin();
-    while (i != inter.end())
+    if (costs != 0)
     {
-      Evaluator<SinglePatchEvaluatorTag>().evaluate(lhs(*i), op, rhs(*i));
-      ++i;
+      inter.data()->fillDeferred();
+      evaluateTimed(lhs, op, rhs, inter, *costs);
+    }
+    else if (inter.data()->deferred() > 0)
+    {
+      evaluateOverlapped(lhs, op, rhs, inter);
+    }
+    else
+    {
+      evaluateNodes(lhs, op, rhs, inter.begin(), inter.end());
     }
     
     POOMA_INCREMENT_STATISTIC(NumMultiPatchExpressions)
     POOMA_INCREMENT_STATISTIC_BY(NumLocalPatchesEvaluated, inter.size())
   }
+
+  /// evaluateTimed(expression, intersector, costs)
+  /// Used while a PatchCosts object measures the layout of the left hand
+  /// side.  The patches are evaluated one at a time, and the time each
+  /// takes is added to the cost of the left hand side's patch.  Small
+  /// patches take microseconds, so they are timed with the monotonic
+  /// clock.
+
+  template <class LHS, class RHS, class Op, class Inter, class Costs>
+  void evaluateTimed(const LHS& lhs, const Op& op, const RHS& rhs,
+		     const Inter& inter, Costs& costs) const
+  {
+    int id = inter.data()->ids()[0];
+
+    Pooma::blockAndEvaluate();
+    typename Inter::const_iterator i = inter.begin();
+    while (i != inter.end())
+    {
+      double start = Pooma::Clock::monotonic();
+      Evaluator<SinglePatchEvaluatorTag>().evaluate(lhs(*i), op, rhs(*i));
+      Pooma::blockAndEvaluate();
+      costs.add(i->globalID(id), Pooma::Clock::monotonic() - start);
+      ++i;
+    }
+  }
+
+  /// evaluateOverlapped(expression, intersector)
+  /// Used if Pooma::overlapGuards() is true and guard fills were put off.
+  /// The interiors of the patches, which read no guard layers, are handed
+  /// off before the guard layers are filled, so they are computed while
+  /// the guard copies are done.  The shells around the interiors are
+  /// handed off last and wait for the copies.  With
+  /// Pooma::parallelPatches() the interiors, and then the shells, are
+  /// evaluated concurrently.
+
+  template <class LHS, class RHS, class Op, class Inter>
+  void evaluateOverlapped(const LHS& lhs, const Op& op, const RHS& rhs,
+			  const Inter& inter) const
+  {
+    typedef typename Inter::INodeContainer_t INodeContainer_t;
+
+    INodeContainer_t interiors, shells;
+    inter.data()->shells(interiors, shells);
+
+    evaluateNodes(lhs, op, rhs, interiors.begin(), interiors.end());
+
+    inter.data()->fillDeferred();
+
+    evaluateNodes(lhs, op, rhs, shells.begin(), shells.end());
+
+    POOMA_INCREMENT_STATISTIC_BY(NumOverlappedInteriors, interiors.size())
+  }
+
+  /// evaluateNodes(expression, first, last)
+  /// Evaluate the expression on the INodes in [first, last), with
+  /// evaluatePatches() if Pooma::parallelPatches() is true and there is
+  /// more than one, and one kernel per INode otherwise.
+
+  template <class LHS, class RHS, class Op, class Iter>
+  void evaluateNodes(const LHS& lhs, const Op& op, const RHS& rhs,
+		     Iter first, Iter last) const
+  {
+    if (Pooma::parallelPatches() && last - first > 1)
+    {
+      evaluatePatches(lhs, op, rhs, first, last);
+      return;
+    }
+
+    for (Iter i = first; i != last; ++i)
+      Evaluator<SinglePatchEvaluatorTag>().evaluate(lhs(*i), op, rhs(*i));
+  }
+
+  /// evaluatePatches(expression, first, last)
+  /// Used if Pooma::parallelPatches() is true.  If the patches are
+  /// independent, a single ParallelPatchKernel evaluates all of them
+  /// concurrently.  Otherwise we fall back to one kernel per patch, so the
+  /// data dependencies between the patches keep them in order.
+
+  template <class LHS, class RHS, class Op, class Iter>
+  void evaluatePatches(const LHS& lhs, const Op& op, const RHS& rhs,
+		       Iter first, Iter last) const
+  {
+    typedef INode<LHS::dimensions> INode_t;
+    typedef typename View1<LHS, INode_t>::Type_t LHSPatch_t;
+    typedef typename View1<RHS, INode_t>::Type_t RHSPatch_t;
+    typedef typename KernelTag<LHSPatch_t, RHSPatch_t>::Kernel_t Kernel_t;
+
+    std::vector<LHSPatch_t> lhsPatches;
+    std::vector<RHSPatch_t> rhsPatches;
+    lhsPatches.reserve(last - first);
+    rhsPatches.reserve(last - first);
+
+    for (Iter i = first; i != last; ++i)
+    {
+      lhsPatches.push_back(lhs(*i));
+      rhsPatches.push_back(rhs(*i));
+    }
+
+    if (independentPatches(lhsPatches, rhsPatches))
+    {
+      Pooma::scheduler().handOff(
+        new ParallelPatchKernel<LHSPatch_t, Op, RHSPatch_t, Kernel_t>(
+          lhsPatches, op, rhsPatches));
+    }
+    else
+    {
+      int n, size = lhsPatches.size();
+      for (n = 0; n < size; ++n)
+        Evaluator<SinglePatchEvaluatorTag>().evaluate(lhsPatches[n], op,
+						      rhsPatches[n]);
+    }
+  }
 };
 
 
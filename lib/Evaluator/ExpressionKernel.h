@@ -44,6 +44,7 @@
 
 #include "Threads/PoomaSmarts.h"
 #include "Evaluator/InlineEvaluator.h"
+#include "Evaluator/SimdEvaluator.h"
 #include "Evaluator/EvaluatorTags.h"
 #include "Evaluator/RequestLocks.h"
 #include "Engine/Engine.h"
@@ -0,0 +1,277 @@
+// -*- C++ -*-
+//
+// Copyright (C) 1998, 1999, 2000, 2002  Los Alamos National Laboratory,
+// Copyright (C) 1998, 1999, 2000, 2002  CodeSourcery, LLC
+//
+// This file is part of FreePOOMA.
+//
+// FreePOOMA is free software; you can redistribute it and/or modify it
+// under the terms of the Expat license.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the Expat
+// license for more details.
+//
+// You should have received a copy of the Expat license along with
+// FreePOOMA; see the file LICENSE.
+//
+
+//-----------------------------------------------------------------------------
+// Classes:
+// Footprint
+// FootprintTag
+//
+// Functions:
+// footprintsCovered()
+// footprintsAgree()
+//-----------------------------------------------------------------------------
+
+#ifndef POOMA_EVALUATOR_FOOTPRINT_H
+#define POOMA_EVALUATOR_FOOTPRINT_H
+
+/** @file
+ * @ingroup Evaluator
+ * @brief
+ * Footprints describe which elements of its data block an engine touches.
+ * Evaluators use them to decide whether pieces of work that share data
+ * objects can be run in a different order than they were written.
+ */
+
+//-----------------------------------------------------------------------------
+// Includes:
+//-----------------------------------------------------------------------------
+
+#include "Threads/PoomaSmarts.h"
+#include "Engine/DataObject.h"
+#include "Engine/EngineFunctor.h"
+#include <vector>
+#include <map>
+#include <set>
+#include <algorithm>
+
+//-----------------------------------------------------------------------------
+// Forward Declarations:
+//-----------------------------------------------------------------------------
+
+template<int Dim, class T, class EngineTag> class Engine;
+struct Brick;
+struct BrickView;
+
+
+/**
+ * A Footprint holds the data object of an engine and, for Bricks and
+ * BrickViews, the address of the first element together with the lengths
+ * and strides.  Two footprints with the same address, lengths and strides
+ * visit the same elements in the same order.  Footprints of other engines
+ * only know their data object.  The source says which of several pieces
+ * of work run in order, such as the statements of a block, the footprint
+ * belongs to.
+ */
+
+struct Footprint
+{
+  Footprint(Pooma::DataObject_t *object)
+    : object_m(object), first_m(0), dim_m(0), source_m(0)
+  { }
+
+  template<class Eng>
+  Footprint(Pooma::DataObject_t *object, const Eng &e)
+    : object_m(object), first_m(&e(e.domain().firsts())),
+      dim_m(Eng::dimensions), source_m(0)
+  {
+    for (int d = 0; d < dim_m; ++d)
+      {
+	lengths_m[d] = e.domain()[d].length();
+	strides_m[d] = e.strides()[d];
+      }
+  }
+
+  bool known() const { return first_m != 0; }
+
+  bool operator==(const Footprint &f) const
+  {
+    if (object_m != f.object_m || first_m != f.first_m || dim_m != f.dim_m)
+      return false;
+    for (int d = 0; d < dim_m; ++d)
+      if (lengths_m[d] != f.lengths_m[d] || strides_m[d] != f.strides_m[d])
+	return false;
+    return true;
+  }
+
+  Pooma::DataObject_t *object_m;
+  const void *first_m;
+  int dim_m;
+  int lengths_m[7];
+  int strides_m[7];
+  int source_m;
+};
+
+/**
+ * FootprintTag is used with expressionApply to collect the footprints of
+ * all the engines in an expression that have data objects.  It also serves
+ * as the functor for DataObjectApply.
+ */
+
+struct FootprintTag
+{
+  typedef int Type_t;
+
+  FootprintTag(std::vector<Footprint> &footprints)
+    : footprints_m(footprints)
+  { }
+
+  Type_t operator()(Pooma::DataObject_t *obj) const
+  {
+    footprints_m.push_back(Footprint(obj));
+    return 0;
+  }
+
+  Type_t defaultValue() const { return 0; }
+
+  std::vector<Footprint> &footprints_m;
+};
+
+template<class Eng>
+struct DefaultExpressionApply<Eng, FootprintTag>
+{
+  inline static
+  int apply(const Eng &e, const ExpressionApply<FootprintTag> &tag)
+  {
+    return DataObjectApply<Eng::hasDataObject>::apply(e, tag.tag());
+  }
+};
+
+template<int Dim, class T>
+struct DefaultExpressionApply<Engine<Dim, T, Brick>, FootprintTag>
+{
+  inline static
+  int apply(const Engine<Dim, T, Brick> &e,
+	    const ExpressionApply<FootprintTag> &tag)
+  {
+    tag.tag().footprints_m.push_back(Footprint(e.dataObject(), e));
+    return 0;
+  }
+};
+
+template<int Dim, class T>
+struct DefaultExpressionApply<Engine<Dim, T, BrickView>, FootprintTag>
+{
+  inline static
+  int apply(const Engine<Dim, T, BrickView> &e,
+	    const ExpressionApply<FootprintTag> &tag)
+  {
+    tag.tag().footprints_m.push_back(Footprint(e.dataObject(), e));
+    return 0;
+  }
+};
+
+/**
+ * footprintsCovered(allWrites, writes, footprints) is true if every one
+ * of the footprints that touches a data object in allWrites is known and
+ * is one of the footprints in writes.
+ */
+
+inline bool
+footprintsCovered(const std::vector<Footprint> &allWrites,
+		  const std::vector<Footprint> &writes,
+		  const std::vector<Footprint> &footprints)
+{
+  std::vector<Footprint>::const_iterator f, w;
+  for (f = footprints.begin(); f != footprints.end(); ++f)
+    {
+      for (w = allWrites.begin(); w != allWrites.end(); ++w)
+	if (w->object_m == f->object_m)
+	  break;
+      if (w == allWrites.end())
+	continue;
+      if (!f->known() ||
+	  std::find(writes.begin(), writes.end(), *f) == writes.end())
+	return false;
+    }
+  return true;
+}
+
+/**
+ * writtenObjects(allWrites) returns the data objects of the footprints,
+ * sorted and without duplicates, for the overload of footprintsCovered()
+ * below.
+ */
+
+inline std::vector<Pooma::DataObject_t *>
+writtenObjects(const std::vector<Footprint> &allWrites)
+{
+  std::vector<Pooma::DataObject_t *> objects;
+  objects.reserve(allWrites.size());
+  std::vector<Footprint>::const_iterator w;
+  for (w = allWrites.begin(); w != allWrites.end(); ++w)
+    objects.push_back(w->object_m);
+  std::sort(objects.begin(), objects.end());
+  objects.erase(std::unique(objects.begin(), objects.end()), objects.end());
+  return objects;
+}
+
+/**
+ * footprintsCovered(objects, writes, footprints) is footprintsCovered()
+ * with the written data objects given by writtenObjects(), so checking
+ * many pieces of work against the same writes takes a binary search per
+ * footprint.
+ */
+
+inline bool
+footprintsCovered(const std::vector<Pooma::DataObject_t *> &objects,
+		  const std::vector<Footprint> &writes,
+		  const std::vector<Footprint> &footprints)
+{
+  std::vector<Footprint>::const_iterator f;
+  for (f = footprints.begin(); f != footprints.end(); ++f)
+    {
+      if (!std::binary_search(objects.begin(), objects.end(), f->object_m))
+	continue;
+      if (!f->known() ||
+	  std::find(writes.begin(), writes.end(), *f) == writes.end())
+	return false;
+    }
+  return true;
+}
+
+/**
+ * footprintsAgree(writes) takes the footprints written on each of a number
+ * of patches, which may be run in any order.  It is true if all of them
+ * are known, if every data object written on a patch is written there
+ * through a single footprint, and if every patch that writes a data object
+ * has it written by all the sources that write it anywhere.  Then two
+ * sources that write the same data object, such as a(I) and a(I+1), write
+ * the same elements and the last of them always wins.
+ */
+
+inline bool
+footprintsAgree(const std::vector<std::vector<Footprint> > &writes)
+{
+  typedef std::map<Pooma::DataObject_t *, std::set<int> > Sources_t;
+  Sources_t sources;
+  std::vector<Sources_t> patchSources(writes.size());
+  std::vector<Footprint>::const_iterator f, w;
+  int n, size = writes.size();
+  for (n = 0; n < size; ++n)
+    for (f = writes[n].begin(); f != writes[n].end(); ++f)
+      {
+	if (!f->known())
+	  return false;
+	for (w = writes[n].begin(); w != f; ++w)
+	  if (w->object_m == f->object_m && !(*w == *f))
+	    return false;
+	sources[f->object_m].insert(f->source_m);
+	patchSources[n][f->object_m].insert(f->source_m);
+      }
+
+  Sources_t::const_iterator s;
+  for (n = 0; n < size; ++n)
+    for (s = patchSources[n].begin(); s != patchSources[n].end(); ++s)
+      if (s->second.size() != sources[s->first].size())
+	return false;
+  return true;
+}
+
+
+#endif     // POOMA_EVALUATOR_FOOTPRINT_H
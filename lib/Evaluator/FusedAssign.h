@@ -0,0 +1,726 @@
+// -*- C++ -*-
+//
+// Copyright (C) 1998, 1999, 2000, 2002  Los Alamos National Laboratory,
+// Copyright (C) 1998, 1999, 2000, 2002  CodeSourcery, LLC
+//
+// This file is part of FreePOOMA.
+//
+// FreePOOMA is free software; you can redistribute it and/or modify it
+// under the terms of the Expat license.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the Expat
+// license for more details.
+//
+// You should have received a copy of the Expat license along with
+// FreePOOMA; see the file LICENSE.
+//
+
+//-----------------------------------------------------------------------------
+// Classes:
+// FusedEnd
+// FusedAssign<Prev,LHS,RHS,Op>
+// FusedKernel<Statements>
+// FusedEvaluator<EvalTag>
+//
+// Functions:
+// fuse()
+//-----------------------------------------------------------------------------
+
+#ifndef POOMA_EVALUATOR_FUSEDASSIGN_H
+#define POOMA_EVALUATOR_FUSEDASSIGN_H
+
+/** @file
+ * @ingroup Evaluator
+ * @brief
+ * Evaluation of a block of array assignments in a single loop nest.
+ *
+ * A block of statements like
+ * <PRE>
+ *   a = b + c;
+ *   d = a * e;
+ *   f = d - a;
+ * </PRE>
+ * normally sweeps over memory three times.  Written as
+ * <PRE>
+ *   fuse(a, b + c)(d, a * e)(f, d - a).evaluate();
+ * </PRE>
+ * the statements are evaluated one after the other at each point of a
+ * single loop nest, one kernel per patch.  This is only correct if every
+ * element an earlier statement writes is read back by later statements
+ * at the same point, so evaluate() first compares the memory footprints
+ * of the written arrays with everything read or written on each patch.
+ * If they do not match exactly (a written array is read with an offset,
+ * through its guard layers, from another patch or through an engine that
+ * is not a Brick or a BrickView, or is written through two different
+ * views) the statements are assigned one after the other, as if they had
+ * been written separately.  evaluate() returns true if the block was
+ * fused.
+ *
+ * The statements hold references to the arrays in their expressions, so
+ * the block should be evaluated in the full expression that builds it.
+ */
+
+//-----------------------------------------------------------------------------
+// Includes:
+//-----------------------------------------------------------------------------
+
+#include "Pooma/Configuration.h"
+#include "Threads/PoomaSmarts.h"
+#include "Evaluator/Evaluator.h"
+#include "Evaluator/EvaluatorTags.h"
+#include "Evaluator/ElementCost.h"
+#include "Evaluator/Footprint.h"
+#include "Evaluator/RequestLocks.h"
+#include "Engine/ConstantFunctionEngine.h"
+#include "Engine/EngineFunctor.h"
+#include "Engine/Intersector.h"
+#include "Engine/IntersectEngine.h"
+#include "Engine/NotifyEngineWrite.h"
+#include "PETE/PETE.h"
+#include "Utilities/Conform.h"
+#include "Utilities/PAssert.h"
+#include "Utilities/WrappedInt.h"
+#include <vector>
+
+//-----------------------------------------------------------------------------
+// Forward Declarations:
+//-----------------------------------------------------------------------------
+
+template<int Dim, class T, class EngineTag> class Array;
+
+
+/**
+ * fusedElementWise() takes the footprints written and read on each patch.
+ * It checks that every written data object is written through the same
+ * footprint by all the statements that write it, and that every footprint
+ * in a patch that touches a data object written anywhere in the block is
+ * one of the footprints written in that patch.  Then all the dependencies
+ * between the statements are between elements at the same point of the
+ * loop nest.
+ */
+
+inline bool
+fusedElementWise(const std::vector<std::vector<Footprint> > &writes,
+		 const std::vector<std::vector<Footprint> > &reads)
+{
+  if (!footprintsAgree(writes))
+    return false;
+
+  std::vector<Footprint> allWrites;
+  int n, size = writes.size();
+  for (n = 0; n < size; ++n)
+    allWrites.insert(allWrites.end(), writes[n].begin(), writes[n].end());
+  for (n = 0; n < size; ++n)
+    if (!footprintsCovered(allWrites, writes[n], reads[n]))
+      return false;
+  return true;
+}
+
+
+/**
+ * FusedEnd terminates the list of statements in a fused block.  All of its
+ * operations do nothing.  Its evaluator tag is SinglePatchEvaluatorTag,
+ * which leaves the tag of any other statement unchanged when combined.
+ */
+
+struct FusedEnd
+{
+  enum { statements = 0 };
+  typedef SinglePatchEvaluatorTag Evaluator_t;
+  typedef FusedEnd ZeroBased_t;
+
+  template<class Domain>
+  struct View
+  {
+    typedef FusedEnd Type_t;
+  };
+
+  FusedEnd() { }
+
+  FusedEnd zeroBased() const { return FusedEnd(); }
+
+  template<class Domain>
+  FusedEnd view(const Domain &) const { return FusedEnd(); }
+
+  template<class Inter>
+  void intersect(Inter &) const { }
+
+  template<class Tag>
+  bool conforms(const Tag &) const { return true; }
+
+  void writes(std::vector<Footprint> &) const { }
+  void reads(std::vector<Footprint> &) const { }
+
+  template<class Request>
+  void applyLHS(const Request &) const { }
+
+  template<class Request>
+  void applyRHS(const Request &) const { }
+
+  void notifyWrites() const { }
+  void assignEach() const { }
+
+  inline void apply(int) const { }
+  inline void apply(int, int) const { }
+  inline void apply(int, int, int) const { }
+  inline void apply(int, int, int, int) const { }
+  inline void apply(int, int, int, int, int) const { }
+  inline void apply(int, int, int, int, int, int) const { }
+  inline void apply(int, int, int, int, int, int, int) const { }
+};
+
+
+/**
+ * FusedAssign<Prev,LHS,RHS,Op> is a block of statements that ends with
+ * "op(lhs, rhs)".  Prev holds the statements before it.  New statements are
+ * appended with operator() and the block is run with evaluate().
+ *
+ * The Evaluator_t of the block is the combination of the evaluator tags of
+ * all of its statements.  The single and multi-patch evaluators build one
+ * FusedKernel per patch; other evaluators are not fused.
+ */
+
+template<class EvalTag>
+struct FusedEvaluator;
+
+template<class Prev, class LHS, class RHS, class Op>
+class FusedAssign
+{
+public:
+
+  //---------------------------------------------------------------------------
+  // Exported typedefs and constants
+
+  typedef FusedAssign<Prev, LHS, RHS, Op> This_t;
+  typedef LHS LHS_t;
+
+  enum { dimensions = LHS::dimensions };
+  enum { statements = Prev::statements + 1 };
+
+  typedef typename EvaluatorCombine<typename Prev::Evaluator_t,
+    typename EvaluatorTag<LHS, RHS>::Evaluator_t>::Evaluator_t Evaluator_t;
+
+  typedef FusedAssign<typename Prev::ZeroBased_t,
+    typename View0<LHS>::Type_t, typename View0<RHS>::Type_t, Op>
+    ZeroBased_t;
+
+  template<class Domain>
+  struct View
+  {
+    typedef FusedAssign<typename Prev::template View<Domain>::Type_t,
+      typename View1<LHS, Domain>::Type_t,
+      typename View1<RHS, Domain>::Type_t, Op> Type_t;
+  };
+
+  //---------------------------------------------------------------------------
+  // Constructors.
+
+  FusedAssign(const Prev &prev, const LHS &lhs, const RHS &rhs, const Op &op)
+    : prev_m(prev), lhs_m(lhs), rhs_m(rhs), op_m(op)
+  { }
+
+  //---------------------------------------------------------------------------
+  // Append a statement to the block.  The right hand side can be an array
+  // or a scalar and the operator defaults to OpAssign.
+
+  template<int D1, class T1, class E1, int D2, class T2, class E2>
+  FusedAssign<This_t, Array<D1, T1, E1>, Array<D2, T2, E2>, OpAssign>
+  operator()(const Array<D1, T1, E1> &lhs,
+	     const Array<D2, T2, E2> &rhs) const
+  {
+    return (*this)(lhs, rhs, OpAssign());
+  }
+
+  template<int D1, class T1, class E1, int D2, class T2, class E2, class Op1>
+  FusedAssign<This_t, Array<D1, T1, E1>, Array<D2, T2, E2>, Op1>
+  operator()(const Array<D1, T1, E1> &lhs,
+	     const Array<D2, T2, E2> &rhs, const Op1 &op) const
+  {
+    CTAssert(D1 == dimensions);
+    return FusedAssign<This_t, Array<D1, T1, E1>, Array<D2, T2, E2>, Op1>
+      (*this, lhs, rhs, op);
+  }
+
+  template<int D1, class T1, class E1, class T2>
+  FusedAssign<This_t, Array<D1, T1, E1>, Array<D1, T2, ConstantFunction>,
+    OpAssign>
+  operator()(const Array<D1, T1, E1> &lhs, const T2 &rhs) const
+  {
+    return (*this)(lhs, rhs, OpAssign());
+  }
+
+  template<int D1, class T1, class E1, class T2, class Op1>
+  FusedAssign<This_t, Array<D1, T1, E1>, Array<D1, T2, ConstantFunction>,
+    Op1>
+  operator()(const Array<D1, T1, E1> &lhs, const T2 &rhs,
+	     const Op1 &op) const
+  {
+    Array<D1, T2, ConstantFunction> rhsExpr(lhs.domain());
+    rhsExpr.engine().setConstant(rhs);
+    return (*this)(lhs, rhsExpr, op);
+  }
+
+  //---------------------------------------------------------------------------
+  // Evaluate the block.  Returns true if the statements were evaluated in
+  // a single loop nest per patch and false if they had to be assigned one
+  // after the other.
+
+  bool evaluate() const
+  {
+    bool fused = false;
+
+    Pooma::beginExpression();
+    if (conforms(ConformTag<dimensions>(lhs_m.domain())))
+      fused = FusedEvaluator<Evaluator_t>::evaluate(zeroBased());
+    if (fused)
+      notifyWrites();
+    Pooma::endExpression();
+
+    if (fused)
+      {
+	POOMA_INCREMENT_STATISTIC(NumFusedAssigns)
+      }
+    else
+      {
+	assignEach();
+      }
+
+    return fused;
+  }
+
+  //---------------------------------------------------------------------------
+  // Accessors.
+
+  const Prev &prev() const { return prev_m; }
+  const LHS &lhs() const { return lhs_m; }
+  const RHS &rhs() const { return rhs_m; }
+  const Op &op() const { return op_m; }
+
+  //---------------------------------------------------------------------------
+  // The operations below are applied to each statement in turn, starting
+  // with the first one.  They are used by the fused evaluators and kernels.
+
+  ZeroBased_t zeroBased() const
+  {
+    return ZeroBased_t(prev_m.zeroBased(), lhs_m(), rhs_m(), op_m);
+  }
+
+  template<class Domain>
+  typename View<Domain>::Type_t view(const Domain &d) const
+  {
+    return typename View<Domain>::Type_t(prev_m.view(d), lhs_m(d), rhs_m(d),
+					 op_m);
+  }
+
+  template<class Inter>
+  void intersect(Inter &inter) const
+  {
+    prev_m.intersect(inter);
+    expressionApply(lhs_m, IntersectorTag<Inter>(inter));
+    expressionApply(rhs_m, IntersectorTag<Inter>(inter));
+  }
+
+  bool conforms(const ConformTag<dimensions> &tag) const
+  {
+    return prev_m.conforms(tag) && forEach(lhs_m, tag, AndCombine()) &&
+      forEach(rhs_m, tag, AndCombine());
+  }
+
+  void writes(std::vector<Footprint> &footprints) const
+  {
+    prev_m.writes(footprints);
+    std::vector<Footprint>::size_type n = footprints.size();
+    expressionApply(lhs_m, FootprintTag(footprints));
+    for (; n < footprints.size(); ++n)
+      footprints[n].source_m = Prev::statements;
+  }
+
+  void reads(std::vector<Footprint> &footprints) const
+  {
+    prev_m.reads(footprints);
+    expressionApply(rhs_m, FootprintTag(footprints));
+  }
+
+  template<class Request>
+  void applyLHS(const Request &request) const
+  {
+    prev_m.applyLHS(request);
+    engineFunctor(lhs_m, request);
+  }
+
+  template<class Request>
+  void applyRHS(const Request &request) const
+  {
+    prev_m.applyRHS(request);
+    engineFunctor(rhs_m, request);
+  }
+
+  void notifyWrites() const
+  {
+    prev_m.notifyWrites();
+    notifyEngineWrite(lhs_m.engine());
+  }
+
+  void assignEach() const
+  {
+    prev_m.assignEach();
+    assign(lhs_m, rhs_m, op_m);
+  }
+
+  inline void apply(int i0) const
+  {
+    prev_m.apply(i0);
+    op_m(lhs_m(i0), rhs_m.read(i0));
+  }
+
+  inline void apply(int i0, int i1) const
+  {
+    prev_m.apply(i0, i1);
+    op_m(lhs_m(i0, i1), rhs_m.read(i0, i1));
+  }
+
+  inline void apply(int i0, int i1, int i2) const
+  {
+    prev_m.apply(i0, i1, i2);
+    op_m(lhs_m(i0, i1, i2), rhs_m.read(i0, i1, i2));
+  }
+
+  inline void apply(int i0, int i1, int i2, int i3) const
+  {
+    prev_m.apply(i0, i1, i2, i3);
+    op_m(lhs_m(i0, i1, i2, i3), rhs_m.read(i0, i1, i2, i3));
+  }
+
+  inline void apply(int i0, int i1, int i2, int i3, int i4) const
+  {
+    prev_m.apply(i0, i1, i2, i3, i4);
+    op_m(lhs_m(i0, i1, i2, i3, i4), rhs_m.read(i0, i1, i2, i3, i4));
+  }
+
+  inline void apply(int i0, int i1, int i2, int i3, int i4, int i5) const
+  {
+    prev_m.apply(i0, i1, i2, i3, i4, i5);
+    op_m(lhs_m(i0, i1, i2, i3, i4, i5),
+	 rhs_m.read(i0, i1, i2, i3, i4, i5));
+  }
+
+  inline void apply(int i0, int i1, int i2, int i3, int i4, int i5,
+		    int i6) const
+  {
+    prev_m.apply(i0, i1, i2, i3, i4, i5, i6);
+    op_m(lhs_m(i0, i1, i2, i3, i4, i5, i6),
+	 rhs_m.read(i0, i1, i2, i3, i4, i5, i6));
+  }
+
+private:
+
+  Prev prev_m;
+  LHS lhs_m;
+  RHS rhs_m;
+  Op op_m;
+};
+
+// The cost of one element of a fused block is the sum of the costs of
+// its statements.
+
+template<>
+struct ElementCost<FusedEnd>
+{
+  enum { cost = 0 };
+};
+
+template<class Prev, class LHS, class RHS, class Op>
+struct ElementCost<FusedAssign<Prev, LHS, RHS, Op> >
+{
+  enum { cost = ElementCost<Prev>::cost + AssignCost<LHS, RHS>::cost };
+};
+
+
+/// @name fuse()
+/// Start a fused block with the statement "op(lhs, rhs)".  Further
+/// statements are appended with operator().
+//@{
+
+template<int D1, class T1, class E1, int D2, class T2, class E2, class Op>
+inline FusedAssign<FusedEnd, Array<D1, T1, E1>, Array<D2, T2, E2>, Op>
+fuse(const Array<D1, T1, E1> &lhs, const Array<D2, T2, E2> &rhs,
+     const Op &op)
+{
+  return FusedAssign<FusedEnd, Array<D1, T1, E1>, Array<D2, T2, E2>, Op>
+    (FusedEnd(), lhs, rhs, op);
+}
+
+template<int D1, class T1, class E1, int D2, class T2, class E2>
+inline FusedAssign<FusedEnd, Array<D1, T1, E1>, Array<D2, T2, E2>, OpAssign>
+fuse(const Array<D1, T1, E1> &lhs, const Array<D2, T2, E2> &rhs)
+{
+  return fuse(lhs, rhs, OpAssign());
+}
+
+template<int D1, class T1, class E1, class T2, class Op>
+inline FusedAssign<FusedEnd, Array<D1, T1, E1>,
+  Array<D1, T2, ConstantFunction>, Op>
+fuse(const Array<D1, T1, E1> &lhs, const T2 &rhs, const Op &op)
+{
+  Array<D1, T2, ConstantFunction> rhsExpr(lhs.domain());
+  rhsExpr.engine().setConstant(rhs);
+  return fuse(lhs, rhsExpr, op);
+}
+
+template<int D1, class T1, class E1, class T2>
+inline FusedAssign<FusedEnd, Array<D1, T1, E1>,
+  Array<D1, T2, ConstantFunction>, OpAssign>
+fuse(const Array<D1, T1, E1> &lhs, const T2 &rhs)
+{
+  return fuse(lhs, rhs, OpAssign());
+}
+
+//@}
+
+
+/**
+ * A FusedKernel is an iterate that runs a block of zero-based statements
+ * on one patch.  Like an ExpressionKernel it requests the locks in the
+ * constructor and releases them in the destructor: a write lock on every
+ * left hand side and a read lock on every right hand side object that is
+ * not also written.
+ */
+
+template<class Statements>
+class FusedKernel : public Pooma::Iterate_t
+{
+public:
+
+  FusedKernel(const Statements &statements)
+    : Pooma::Iterate_t(Pooma::scheduler()), statements_m(statements)
+  {
+    hintAffinity(engineFunctor(statements_m.lhs(),
+			       DataObjectRequest<BlockAffinity>()));
+
+    std::vector<Pooma::DataObject_t*> written;
+    statements_m.applyLHS(DataObjectRequest<WriteManyRequest>(*this,
+							       written));
+    statements_m.applyRHS(DataObjectRequest<ReadManyRequest>(*this,
+							      written));
+  }
+
+  virtual ~FusedKernel()
+  {
+    std::vector<Pooma::DataObject_t*> written;
+    statements_m.applyLHS(DataObjectRequest<WriteManyRelease>(written));
+    statements_m.applyRHS(DataObjectRequest<ReadManyRelease>(written));
+  }
+
+  virtual void run()
+  {
+    evaluate(statements_m.lhs().domain(),
+	     WrappedInt<Statements::dimensions>());
+  }
+
+private:
+
+  // Whether the loop nest over domain is worth running with OpenMP.
+
+  template<class Domain>
+  static bool parallel(const Domain &domain)
+  {
+    return Pooma::parallelWork(domain.size(), ElementCost<Statements>::cost);
+  }
+
+  // One loop nest per dimension, as in KernelEvaluator<InlineKernelTag>.
+  // The domain is zero-based and has unit stride.
+
+  template<class Domain>
+  void evaluate(const Domain &domain, WrappedInt<1>) const
+  {
+    Statements local(statements_m);
+    int e0 = domain[0].length();
+#pragma omp parallel for if (parallel(domain))
+    for (int i0=0; i0<e0; ++i0)
+      local.apply(i0);
+  }
+
+  template<class Domain>
+  void evaluate(const Domain &domain, WrappedInt<2>) const
+  {
+    Statements local(statements_m);
+    int e0 = domain[0].length();
+    int e1 = domain[1].length();
+#pragma omp parallel for if (parallel(domain))
+    for (int i1=0; i1<e1; ++i1)
+      for (int i0=0; i0<e0; ++i0)
+	local.apply(i0,i1);
+  }
+
+  template<class Domain>
+  void evaluate(const Domain &domain, WrappedInt<3>) const
+  {
+    Statements local(statements_m);
+    int e0 = domain[0].length();
+    int e1 = domain[1].length();
+    int e2 = domain[2].length();
+#pragma omp parallel for if (parallel(domain))
+    for (int i2=0; i2<e2; ++i2)
+      for (int i1=0; i1<e1; ++i1)
+	for (int i0=0; i0<e0; ++i0)
+	  local.apply(i0,i1,i2);
+  }
+
+  template<class Domain>
+  void evaluate(const Domain &domain, WrappedInt<4>) const
+  {
+    Statements local(statements_m);
+    int e0 = domain[0].length();
+    int e1 = domain[1].length();
+    int e2 = domain[2].length();
+    int e3 = domain[3].length();
+#pragma omp parallel for if (parallel(domain))
+    for (int i3=0; i3<e3; ++i3)
+      for (int i2=0; i2<e2; ++i2)
+	for (int i1=0; i1<e1; ++i1)
+	  for (int i0=0; i0<e0; ++i0)
+	    local.apply(i0,i1,i2,i3);
+  }
+
+  template<class Domain>
+  void evaluate(const Domain &domain, WrappedInt<5>) const
+  {
+    Statements local(statements_m);
+    int e0 = domain[0].length();
+    int e1 = domain[1].length();
+    int e2 = domain[2].length();
+    int e3 = domain[3].length();
+    int e4 = domain[4].length();
+#pragma omp parallel for if (parallel(domain))
+    for (int i4=0; i4<e4; ++i4)
+      for (int i3=0; i3<e3; ++i3)
+	for (int i2=0; i2<e2; ++i2)
+	  for (int i1=0; i1<e1; ++i1)
+	    for (int i0=0; i0<e0; ++i0)
+	      local.apply(i0,i1,i2,i3,i4);
+  }
+
+  template<class Domain>
+  void evaluate(const Domain &domain, WrappedInt<6>) const
+  {
+    Statements local(statements_m);
+    int e0 = domain[0].length();
+    int e1 = domain[1].length();
+    int e2 = domain[2].length();
+    int e3 = domain[3].length();
+    int e4 = domain[4].length();
+    int e5 = domain[5].length();
+#pragma omp parallel for if (parallel(domain))
+    for (int i5=0; i5<e5; ++i5)
+      for (int i4=0; i4<e4; ++i4)
+	for (int i3=0; i3<e3; ++i3)
+	  for (int i2=0; i2<e2; ++i2)
+	    for (int i1=0; i1<e1; ++i1)
+	      for (int i0=0; i0<e0; ++i0)
+		local.apply(i0,i1,i2,i3,i4,i5);
+  }
+
+  template<class Domain>
+  void evaluate(const Domain &domain, WrappedInt<7>) const
+  {
+    Statements local(statements_m);
+    int e0 = domain[0].length();
+    int e1 = domain[1].length();
+    int e2 = domain[2].length();
+    int e3 = domain[3].length();
+    int e4 = domain[4].length();
+    int e5 = domain[5].length();
+    int e6 = domain[6].length();
+#pragma omp parallel for if (parallel(domain))
+    for (int i6=0; i6<e6; ++i6)
+      for (int i5=0; i5<e5; ++i5)
+	for (int i4=0; i4<e4; ++i4)
+	  for (int i3=0; i3<e3; ++i3)
+	    for (int i2=0; i2<e2; ++i2)
+	      for (int i1=0; i1<e1; ++i1)
+		for (int i0=0; i0<e0; ++i0)
+		  local.apply(i0,i1,i2,i3,i4,i5,i6);
+  }
+
+  Statements statements_m;
+};
+
+
+/**
+ * FusedEvaluator<EvalTag>::evaluate(statements) hands off the kernels for
+ * a zero-based block and returns true, or returns false without doing
+ * anything if the block can not be fused.  Blocks involving remote
+ * engines are never fused.
+ */
+
+template<class EvalTag>
+struct FusedEvaluator
+{
+  template<class Statements>
+  static bool evaluate(const Statements &)
+  {
+    return false;
+  }
+};
+
+template<>
+struct FusedEvaluator<SinglePatchEvaluatorTag>
+{
+  template<class Statements>
+  static bool evaluate(const Statements &statements)
+  {
+    std::vector<std::vector<Footprint> > writes(1), reads(1);
+    statements.writes(writes[0]);
+    statements.reads(reads[0]);
+    if (!fusedElementWise(writes, reads))
+      return false;
+
+    Pooma::scheduler().handOff(new FusedKernel<Statements>(statements));
+    return true;
+  }
+};
+
+template<>
+struct FusedEvaluator<MultiPatchEvaluatorTag>
+{
+  template<class Statements>
+  static bool evaluate(const Statements &statements)
+  {
+    enum { dimensions = Statements::dimensions };
+    typedef Intersector<dimensions> Inter_t;
+    typedef typename Statements::template View<INode<dimensions> >::Type_t
+      View_t;
+
+    Inter_t inter;
+    statements.intersect(inter);
+
+    // Take the views of all the patches first, since the dependencies
+    // of one patch depend on what is written in the others.
+
+    int n, size = inter.size();
+    std::vector<View_t> views;
+    std::vector<std::vector<Footprint> > writes(size), reads(size);
+    views.reserve(size);
+    typename Inter_t::const_iterator i = inter.begin();
+    for (n = 0; n < size; ++n, ++i)
+    {
+      views.push_back(statements.view(*i));
+      views[n].writes(writes[n]);
+      views[n].reads(reads[n]);
+    }
+    if (!fusedElementWise(writes, reads))
+      return false;
+
+    for (n = 0; n < size; ++n)
+      Pooma::scheduler().handOff(new FusedKernel<View_t>(views[n]));
+
+    POOMA_INCREMENT_STATISTIC(NumMultiPatchExpressions)
+    POOMA_INCREMENT_STATISTIC_BY(NumLocalPatchesEvaluated, inter.size())
+    return true;
+  }
+};
+
+
+#endif     // POOMA_EVALUATOR_FUSEDASSIGN_H
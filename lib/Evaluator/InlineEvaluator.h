@@ -41,8 +41,11 @@
 //-----------------------------------------------------------------------------
 
 #include "Evaluator/KernelTags.h"
+#include "Evaluator/ElementCost.h"
+#include "Pooma/Pooma.h"
 #include "Utilities/WrappedInt.h"
 #include "Utilities/PAssert.h"
+#include <algorithm>
 
 //-----------------------------------------------------------------------------
 // Forward Declarations:
@@ -68,6 +71,12 @@ struct KernelEvaluator;
  * -# The expression passed in can handle random access to all of its
  *    elements efficiently.  That basically means that it can only be
  *    used with BrickEngine or its equivalent.
+ *
+ * For domains of dimension 3 and higher the loop nest can optionally be
+ * cache-blocked (see Pooma::tiledEvaluation()).  Loop nests are only run
+ * with OpenMP if their estimated work exceeds Pooma::ompThreshold().
+ * Loop nests that are not tiled split the outermost loop with a static
+ * schedule, which Pooma::firstTouch() initialization of Bricks matches.
  */
 
 template<>
@@ -93,6 +102,15 @@ struct KernelEvaluator<InlineKernelTag>
     POOMA_INCREMENT_STATISTIC(NumInlineEvaluations)
   }
 
+  /// Return whether evaluating the expression on the domain is enough
+  /// work to be worth an OpenMP parallel region.
+
+  template<class LHS,class RHS,class Domain>
+  inline static bool parallel(const LHS&,const RHS&,const Domain& domain)
+  {
+    return Pooma::parallelWork(domain.size(),AssignCost<LHS,RHS>::cost);
+  }
+
   /// Input an expression and cause it to be evaluated.
   /// All this template function does is extract the domain
   /// from the expression and call evaluate on that.
@@ -143,7 +161,7 @@ struct KernelEvaluator<InlineKernelTag>
     LHS localLHS(lhs);
     RHS localRHS(rhs);
     int e0 = domain[0].length();
-#pragma omp parallel for if (e0 > 512)
+#pragma omp parallel for schedule(static) if (parallel(lhs,rhs,domain))
     for (int i0=0; i0<e0; ++i0)
       op(localLHS(i0),localRHS.read(i0));
   }
@@ -156,7 +174,7 @@ struct KernelEvaluator<InlineKernelTag>
     RHS localRHS(rhs);
     int e0 = domain[0].length();
     int e1 = domain[1].length();
-#pragma omp parallel for
+#pragma omp parallel for schedule(static) if (parallel(lhs,rhs,domain))
     for (int i1=0; i1<e1; ++i1)
       for (int i0=0; i0<e0; ++i0)
 	op(localLHS(i0,i1),localRHS.read(i0,i1));
@@ -166,12 +184,18 @@ struct KernelEvaluator<InlineKernelTag>
   inline static void evaluate(const LHS& lhs,const Op& op,const RHS& rhs,
 			      const Domain& domain,WrappedInt<3>)
   {
+    if (Pooma::tiledEvaluation())
+      {
+	evaluateTiled(lhs,op,rhs,domain,WrappedInt<3>());
+	return;
+      }
+
     LHS localLHS(lhs);
     RHS localRHS(rhs);
     int e0 = domain[0].length();
     int e1 = domain[1].length();
     int e2 = domain[2].length();
-#pragma omp parallel for
+#pragma omp parallel for schedule(static) if (parallel(lhs,rhs,domain))
     for (int i2=0; i2<e2; ++i2)
       for (int i1=0; i1<e1; ++i1)
 	for (int i0=0; i0<e0; ++i0)
@@ -182,13 +206,19 @@ struct KernelEvaluator<InlineKernelTag>
   inline static void evaluate(const LHS& lhs,const Op& op,const RHS& rhs,
 			      const Domain& domain,WrappedInt<4>)
   {
+    if (Pooma::tiledEvaluation())
+      {
+	evaluateTiled(lhs,op,rhs,domain,WrappedInt<4>());
+	return;
+      }
+
     LHS localLHS(lhs);
     RHS localRHS(rhs);
     int e0 = domain[0].length();
     int e1 = domain[1].length();
     int e2 = domain[2].length();
     int e3 = domain[3].length();
-#pragma omp parallel for
+#pragma omp parallel for schedule(static) if (parallel(lhs,rhs,domain))
     for (int i3=0; i3<e3; ++i3)
       for (int i2=0; i2<e2; ++i2)
 	for (int i1=0; i1<e1; ++i1)
@@ -200,6 +230,12 @@ struct KernelEvaluator<InlineKernelTag>
   inline static void evaluate(const LHS& lhs,const Op& op,const RHS& rhs,
 			      const Domain& domain,WrappedInt<5>)
   {
+    if (Pooma::tiledEvaluation())
+      {
+	evaluateTiled(lhs,op,rhs,domain,WrappedInt<5>());
+	return;
+      }
+
     LHS localLHS(lhs);
     RHS localRHS(rhs);
     int e0 = domain[0].length();
@@ -207,7 +243,7 @@ struct KernelEvaluator<InlineKernelTag>
     int e2 = domain[2].length();
     int e3 = domain[3].length();
     int e4 = domain[4].length();
-#pragma omp parallel for
+#pragma omp parallel for schedule(static) if (parallel(lhs,rhs,domain))
     for (int i4=0; i4<e4; ++i4)
       for (int i3=0; i3<e3; ++i3)
 	for (int i2=0; i2<e2; ++i2)
@@ -220,6 +256,12 @@ struct KernelEvaluator<InlineKernelTag>
   inline static void evaluate(const LHS& lhs,const Op& op,const RHS& rhs,
 			      const Domain& domain,WrappedInt<6>)
   {
+    if (Pooma::tiledEvaluation())
+      {
+	evaluateTiled(lhs,op,rhs,domain,WrappedInt<6>());
+	return;
+      }
+
     LHS localLHS(lhs);
     RHS localRHS(rhs);
     int e0 = domain[0].length();
@@ -228,7 +270,7 @@ struct KernelEvaluator<InlineKernelTag>
     int e3 = domain[3].length();
     int e4 = domain[4].length();
     int e5 = domain[5].length();
-#pragma omp parallel for
+#pragma omp parallel for schedule(static) if (parallel(lhs,rhs,domain))
     for (int i5=0; i5<e5; ++i5)
       for (int i4=0; i4<e4; ++i4)
 	for (int i3=0; i3<e3; ++i3)
@@ -243,6 +285,12 @@ struct KernelEvaluator<InlineKernelTag>
   inline static void evaluate(const LHS& lhs,const Op& op,const RHS& rhs,
 			      const Domain& domain,WrappedInt<7>)
   {
+    if (Pooma::tiledEvaluation())
+      {
+	evaluateTiled(lhs,op,rhs,domain,WrappedInt<7>());
+	return;
+      }
+
     LHS localLHS(lhs);
     RHS localRHS(rhs);
     int e0 = domain[0].length();
@@ -252,7 +300,7 @@ struct KernelEvaluator<InlineKernelTag>
     int e4 = domain[4].length();
     int e5 = domain[5].length();
     int e6 = domain[6].length();
-#pragma omp parallel for
+#pragma omp parallel for schedule(static) if (parallel(lhs,rhs,domain))
     for (int i6=0; i6<e6; ++i6)
       for (int i5=0; i5<e5; ++i5)
 	for (int i4=0; i4<e4; ++i4)
@@ -266,6 +314,175 @@ struct KernelEvaluator<InlineKernelTag>
 
   //@}
 
+  ///@name evaluateTiled(expression,domain,domain_dimension)
+  //@{
+  /// Cache-blocked versions of the loops above for dimensions 3 through 7,
+  /// used when Pooma::tiledEvaluation() is true.
+  ///
+  /// The two innermost dimensions are cut into tiles of
+  /// Pooma::tileExtent(0) by Pooma::tileExtent(1) elements and dimension 2
+  /// is streamed through each tile.  This way the neighboring planes read
+  /// by offset (stencil-like) right hand sides are still in cache when
+  /// they are reused, instead of whole planes being pushed through the
+  /// cache.  Dimensions beyond the third are looped over outside of the
+  /// tiles, and the OpenMP work sharing is over tiles in 3D and over the
+  /// outermost dimension otherwise.
+
+  template<class LHS,class Op,class RHS,class Domain>
+  inline static void evaluateTiled(const LHS& lhs,const Op& op,
+				   const RHS& rhs,const Domain& domain,
+				   WrappedInt<3>)
+  {
+    LHS localLHS(lhs);
+    RHS localRHS(rhs);
+    int e0 = domain[0].length();
+    int e1 = domain[1].length();
+    int e2 = domain[2].length();
+    int t0 = Pooma::tileExtent(0);
+    int t1 = Pooma::tileExtent(1);
+    int n0 = (e0 + t0 - 1) / t0;
+    int nt = n0 * ((e1 + t1 - 1) / t1);
+#pragma omp parallel for if (parallel(lhs,rhs,domain))
+    for (int it=0; it<nt; ++it)
+      {
+	int f0 = (it % n0) * t0, l0 = std::min(f0 + t0, e0);
+	int f1 = (it / n0) * t1, l1 = std::min(f1 + t1, e1);
+	for (int i2=0; i2<e2; ++i2)
+	  for (int i1=f1; i1<l1; ++i1)
+	    for (int i0=f0; i0<l0; ++i0)
+	      op(localLHS(i0,i1,i2),localRHS.read(i0,i1,i2));
+      }
+  }
+
+  template<class LHS,class Op,class RHS,class Domain>
+  inline static void evaluateTiled(const LHS& lhs,const Op& op,
+				   const RHS& rhs,const Domain& domain,
+				   WrappedInt<4>)
+  {
+    LHS localLHS(lhs);
+    RHS localRHS(rhs);
+    int e0 = domain[0].length();
+    int e1 = domain[1].length();
+    int e2 = domain[2].length();
+    int e3 = domain[3].length();
+    int t0 = Pooma::tileExtent(0);
+    int t1 = Pooma::tileExtent(1);
+    int n0 = (e0 + t0 - 1) / t0;
+    int nt = n0 * ((e1 + t1 - 1) / t1);
+#pragma omp parallel for if (parallel(lhs,rhs,domain))
+    for (int i3=0; i3<e3; ++i3)
+      for (int it=0; it<nt; ++it)
+	{
+	  int f0 = (it % n0) * t0, l0 = std::min(f0 + t0, e0);
+	  int f1 = (it / n0) * t1, l1 = std::min(f1 + t1, e1);
+	  for (int i2=0; i2<e2; ++i2)
+	    for (int i1=f1; i1<l1; ++i1)
+	      for (int i0=f0; i0<l0; ++i0)
+		op(localLHS(i0,i1,i2,i3),localRHS.read(i0,i1,i2,i3));
+	}
+  }
+
+  template<class LHS,class Op,class RHS,class Domain>
+  inline static void evaluateTiled(const LHS& lhs,const Op& op,
+				   const RHS& rhs,const Domain& domain,
+				   WrappedInt<5>)
+  {
+    LHS localLHS(lhs);
+    RHS localRHS(rhs);
+    int e0 = domain[0].length();
+    int e1 = domain[1].length();
+    int e2 = domain[2].length();
+    int e3 = domain[3].length();
+    int e4 = domain[4].length();
+    int t0 = Pooma::tileExtent(0);
+    int t1 = Pooma::tileExtent(1);
+    int n0 = (e0 + t0 - 1) / t0;
+    int nt = n0 * ((e1 + t1 - 1) / t1);
+#pragma omp parallel for if (parallel(lhs,rhs,domain))
+    for (int i4=0; i4<e4; ++i4)
+      for (int i3=0; i3<e3; ++i3)
+	for (int it=0; it<nt; ++it)
+	  {
+	    int f0 = (it % n0) * t0, l0 = std::min(f0 + t0, e0);
+	    int f1 = (it / n0) * t1, l1 = std::min(f1 + t1, e1);
+	    for (int i2=0; i2<e2; ++i2)
+	      for (int i1=f1; i1<l1; ++i1)
+		for (int i0=f0; i0<l0; ++i0)
+		  op(localLHS(i0,i1,i2,i3,i4),localRHS.read(i0,i1,i2,i3,i4));
+	  }
+  }
+
+  template<class LHS,class Op,class RHS,class Domain>
+  inline static void evaluateTiled(const LHS& lhs,const Op& op,
+				   const RHS& rhs,const Domain& domain,
+				   WrappedInt<6>)
+  {
+    LHS localLHS(lhs);
+    RHS localRHS(rhs);
+    int e0 = domain[0].length();
+    int e1 = domain[1].length();
+    int e2 = domain[2].length();
+    int e3 = domain[3].length();
+    int e4 = domain[4].length();
+    int e5 = domain[5].length();
+    int t0 = Pooma::tileExtent(0);
+    int t1 = Pooma::tileExtent(1);
+    int n0 = (e0 + t0 - 1) / t0;
+    int nt = n0 * ((e1 + t1 - 1) / t1);
+#pragma omp parallel for if (parallel(lhs,rhs,domain))
+    for (int i5=0; i5<e5; ++i5)
+      for (int i4=0; i4<e4; ++i4)
+	for (int i3=0; i3<e3; ++i3)
+	  for (int it=0; it<nt; ++it)
+	    {
+	      int f0 = (it % n0) * t0, l0 = std::min(f0 + t0, e0);
+	      int f1 = (it / n0) * t1, l1 = std::min(f1 + t1, e1);
+	      for (int i2=0; i2<e2; ++i2)
+		for (int i1=f1; i1<l1; ++i1)
+		  for (int i0=f0; i0<l0; ++i0)
+		    op(localLHS(i0,i1,i2,i3,i4,i5),
+		       localRHS.read(i0,i1,i2,i3,i4,i5));
+	    }
+  }
+
+  template<class LHS,class Op,class RHS,class Domain>
+  inline static void evaluateTiled(const LHS& lhs,const Op& op,
+				   const RHS& rhs,const Domain& domain,
+				   WrappedInt<7>)
+  {
+    LHS localLHS(lhs);
+    RHS localRHS(rhs);
+    int e0 = domain[0].length();
+    int e1 = domain[1].length();
+    int e2 = domain[2].length();
+    int e3 = domain[3].length();
+    int e4 = domain[4].length();
+    int e5 = domain[5].length();
+    int e6 = domain[6].length();
+    int t0 = Pooma::tileExtent(0);
+    int t1 = Pooma::tileExtent(1);
+    int n0 = (e0 + t0 - 1) / t0;
+    int nt = n0 * ((e1 + t1 - 1) / t1);
+#pragma omp parallel for if (parallel(lhs,rhs,domain))
+    for (int i6=0; i6<e6; ++i6)
+      for (int i5=0; i5<e5; ++i5)
+	for (int i4=0; i4<e4; ++i4)
+	  for (int i3=0; i3<e3; ++i3)
+	    for (int it=0; it<nt; ++it)
+	      {
+		int f0 = (it % n0) * t0, l0 = std::min(f0 + t0, e0);
+		int f1 = (it / n0) * t1, l1 = std::min(f1 + t1, e1);
+		for (int i2=0; i2<e2; ++i2)
+		  for (int i1=f1; i1<l1; ++i1)
+		    for (int i0=f0; i0<l0; ++i0)
+		      op(localLHS(i0,i1,i2,i3,i4,i5,i6),
+			 localRHS.read(i0,i1,i2,i3,i4,i5,i6));
+	      }
+  }
+
+
+  //@}
+
 private:
 
 };
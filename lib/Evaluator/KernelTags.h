@@ -22,10 +22,12 @@
 //   KernelTag1<Expr>
 //   KernelTag<LHS,RHS>
 //   CompressibleKernel<bool,bool>
+//   TiledKernel<bool,Kernel>
 // Tags:
 //   InlineKernelTag
 //   CompressibleViewKernelTag
 //   CompressibleKernelTag
+//   TiledCompressibleKernelTag
 //-----------------------------------------------------------------------------
 
 #ifndef POOMA_EVALUATOR_KERNELTAGS_H
@@ -53,25 +55,33 @@
  * struct to determine how to chose a new Kernel given two Kernels.
  *
  * The implementation of this interface will probably change when other
- * kernels are added.  Currently we only have the basic inline kernel plus two
- * that deal with compression, so we pick the kernel tag by querying Compressible
- * about the left and right hand sides.
+ * kernels are added.  Currently we have the basic inline kernel, a SIMD
+ * variant of it and two that deal with compression, so we pick the kernel
+ * tag by querying Compressible about the left and right hand sides and
+ * then SimdUnitStride about the leaves of uncompressible Array expressions.
  *
- * Currently there are only three Kernels:
+ * Currently there are five Kernels:
  * - InlineKernelTag: use the inline Kernel (simple loops, no patches)
+ * - SimdKernelTag: like the inline Kernel, but the innermost loop runs
+ *   over raw pointers; picked if all leaves are Bricks, BrickViews or
+ *   scalars
  * - CompressibleViewKernelTag: for a compressible lhs, 
  *   takes a brickview of lhs then loops
  * - CompressibleKernelTag: checks if both sides are compressed to
  *   do compressed assign otherwise calls CVE
+ * - TiledCompressibleKernelTag: for a TiledCompressibleBrick lhs, or
+ *   reductions of expressions containing one, runs one of the above
+ *   on each tile
  *
  * The results for expressions with Bricks (B) and CompressibleBricks (C)
  * are:
- * - B = B+B;   InlineKernelTag
+ * - B = B+B;   SimdKernelTag
  * - B = C+B;   InlineKernelTag
  * - B = C+C;   InlineKernelTag
  * - C = B+B;   CompressibleViewKernelTag
  * - C = C+B;   CompressibleViewKernelTag
  * - C = C+C;   CompressibleKernelTag
+ * - T = anything; TiledCompressibleKernelTag
  */
 
 //-----------------------------------------------------------------------------
@@ -83,6 +93,7 @@
 //-----------------------------------------------------------------------------
 
 #include "Evaluator/CompressibleEngines.h"
+#include "Evaluator/SimdEngines.h"
 #include "PETE/PETE.h"
 
 //-----------------------------------------------------------------------------
@@ -108,6 +119,12 @@ struct InlineKernelTag
   ~InlineKernelTag(){}
 };
 
+struct SimdKernelTag 
+{ 
+  SimdKernelTag(){}
+  ~SimdKernelTag(){}
+};
+
 struct CompressibleKernelTag 
 { 
   CompressibleKernelTag(){}
@@ -120,6 +137,12 @@ struct CompressibleViewKernelTag
   ~CompressibleViewKernelTag(){}
 };
 
+struct TiledCompressibleKernelTag 
+{ 
+  TiledCompressibleKernelTag(){}
+  ~TiledCompressibleKernelTag(){}
+};
+
 //-----------------------------------------------------------------------------
 // CompressibleKernel<bool,bool>
 //
@@ -167,6 +190,80 @@ struct CompressibleKernel<true,true>
 };
 
 
+//-----------------------------------------------------------------------------
+// TiledKernel<bool,Kernel>
+//
+// Replace the kernel by the tiled kernel if the left-hand side of an
+// assignment is a TiledCompressibleBrick, or a reduced expression
+// contains one.
+//-----------------------------------------------------------------------------
+
+template<bool tiled,class Kernel>
+struct TiledKernel
+{
+  TiledKernel(){}
+  ~TiledKernel(){}
+  typedef Kernel Kernel_t;
+};
+
+template<class Kernel>
+struct TiledKernel<true,Kernel>
+{
+  TiledKernel(){}
+  ~TiledKernel(){}
+  typedef TiledCompressibleKernelTag Kernel_t;
+};
+
+
+//-----------------------------------------------------------------------------
+// SimdKernel<LHS,RHS,Kernel>
+//
+// Replace the inline kernel by the SIMD kernel if both sides are Arrays
+// whose leaves all have unit stride in the first dimension.  Any other
+// kernel, and anything that is not an Array (such as Fields), is left
+// alone.
+//-----------------------------------------------------------------------------
+
+template<bool unitStride>
+struct UnitStrideKernel
+{
+  UnitStrideKernel(){}
+  ~UnitStrideKernel(){}
+  typedef InlineKernelTag Kernel_t;
+};
+
+template<>
+struct UnitStrideKernel<true>
+{
+  UnitStrideKernel(){}
+  ~UnitStrideKernel(){}
+  typedef SimdKernelTag Kernel_t;
+};
+
+template<class LHS,class RHS,class Kernel>
+struct SimdKernel
+{
+  SimdKernel(){}
+  ~SimdKernel(){}
+  typedef Kernel Kernel_t;
+};
+
+template<int D1,class T1,class E1,int D2,class T2,class E2>
+struct SimdKernel<Array<D1,T1,E1>,Array<D2,T2,E2>,InlineKernelTag>
+{
+  SimdKernel(){}
+  ~SimdKernel(){}
+  typedef typename CreateLeaf<Array<D1,T1,E1> >::Leaf_t LHSLeaf_t;
+  typedef typename CreateLeaf<Array<D2,T2,E2> >::Leaf_t RHSLeaf_t;
+  typedef typename ForEach<LHSLeaf_t,SimdUnitStride,AndCombine>::Type_t
+    LHST_t;
+  typedef typename ForEach<RHSLeaf_t,SimdUnitStride,AndCombine>::Type_t
+    RHST_t;
+  enum { unitStride = LHST_t::val && RHST_t::val };
+  typedef typename UnitStrideKernel<unitStride>::Kernel_t Kernel_t;
+};
+
+
 //-----------------------------------------------------------------------------
 // KernelTag<LHS,RHS>
 //
@@ -182,7 +279,12 @@ struct KernelTag1
   typedef typename Expr::Engine_t ExprEngine_t;
   typedef typename EngineFunctor<ExprEngine_t, Compressible>::Type_t Expr_t;
   enum { exprComp = Expr_t::val };
-  typedef typename CompressibleKernel<exprComp,exprComp>::Kernel_t Kernel_t;
+  typedef typename EngineFunctor<ExprEngine_t, TiledCompressible>::Type_t
+    Tiled_t;
+  enum { exprTiled = Tiled_t::val };
+  typedef typename CompressibleKernel<exprComp,exprComp>::Kernel_t
+    CompKernel_t;
+  typedef typename TiledKernel<exprTiled,CompKernel_t>::Kernel_t Kernel_t;
 };
 
 
@@ -204,7 +306,12 @@ struct KernelTag
   typedef typename EngineFunctor<RHSEngine_t,Compressible>::Type_t RHST_t;
   enum { lhsComp = LHST_t::val };
   enum { rhsComp = RHST_t::val };
-  typedef typename CompressibleKernel<lhsComp,rhsComp>::Kernel_t Kernel_t;
+  typedef typename EngineFunctor<LHSEngine_t,TiledCompressible>::Type_t
+    LHSTiled_t;
+  enum { lhsTiled = LHSTiled_t::val };
+  typedef typename CompressibleKernel<lhsComp,rhsComp>::Kernel_t CompKernel_t;
+  typedef typename SimdKernel<LHS,RHS,CompKernel_t>::Kernel_t SimdKernel_t;
+  typedef typename TiledKernel<lhsTiled,SimdKernel_t>::Kernel_t Kernel_t;
 };
 
 
@@ -63,6 +63,8 @@
 // Includes:
 //-----------------------------------------------------------------------------
 
+#include "Evaluator/ElementCost.h"
+#include "Pooma/Pooma.h"
 #include "Utilities/WrappedInt.h"
 #include "Utilities/PAssert.h"
 
@@ -90,12 +92,22 @@ struct LoopApplyEvaluator
     evaluate(op, domain, WrappedInt<Dom::dimensions>());
   }
 
+  // Loops are only run with OpenMP if they have enough work, estimated by
+  // ElementCost<Op>.  Functors that do a lot of work per element should
+  // specialize ElementCost.
+
+  template<class Op, class Domain>
+  inline static bool parallel(const Op &, const Domain &domain)
+  {
+    return Pooma::parallelWork(domain.size(), ElementCost<Op>::cost);
+  }
+
   template<class Op, class Domain>
   inline static void evaluate(const Op &op, const Domain &domain, WrappedInt<1>)
   {
     int f0 = domain[0].first();
     int e0 = domain[0].last();
-#pragma omp parallel for if (e0-f0 > 512)
+#pragma omp parallel for if (parallel(op, domain))
     for (int i0 = f0; i0 <= e0; ++i0)
       op(i0);
   }
@@ -107,7 +119,7 @@ struct LoopApplyEvaluator
     int f1 = domain[1].first();
     int e0 = domain[0].last();
     int e1 = domain[1].last();
-#pragma omp parallel for
+#pragma omp parallel for if (parallel(op, domain))
     for (int i1 = f1; i1 <= e1; ++i1)
       for (int i0 = f0; i0 <= e0; ++i0)
 	op(i0, i1);
@@ -122,7 +134,7 @@ struct LoopApplyEvaluator
     int e0 = domain[0].last();
     int e1 = domain[1].last();
     int e2 = domain[2].last();
-#pragma omp parallel for
+#pragma omp parallel for if (parallel(op, domain))
     for (int i2 = f2; i2 <= e2; ++i2)
       for (int i1 = f1; i1 <= e1; ++i1)
 	for (int i0 = f0; i0 <= e0; ++i0)
@@ -140,7 +152,7 @@ struct LoopApplyEvaluator
     int e1 = domain[1].last();
     int e2 = domain[2].last();
     int e3 = domain[3].last();
-#pragma omp parallel for
+#pragma omp parallel for if (parallel(op, domain))
     for (int i3 = f3; i3 <= e3; ++i3)
       for (int i2 = f2; i2 <= e2; ++i2)
 	for (int i1 = f1; i1 <= e1; ++i1)
@@ -161,7 +173,7 @@ struct LoopApplyEvaluator
     int e2 = domain[2].last();
     int e3 = domain[3].last();
     int e4 = domain[4].last();
-#pragma omp parallel for
+#pragma omp parallel for if (parallel(op, domain))
     for (int i4 = f4; i4 <= e4; ++i4)
       for (int i3 = f3; i3 <= e3; ++i3)
 	for (int i2 = f2; i2 <= e2; ++i2)
@@ -185,7 +197,7 @@ struct LoopApplyEvaluator
     int e3 = domain[3].last();
     int e4 = domain[4].last();
     int e5 = domain[5].last();
-#pragma omp parallel for
+#pragma omp parallel for if (parallel(op, domain))
     for (int i5 = f5; i5 <= e5; ++i5)
       for (int i4 = f4; i4 <= e4; ++i4)
 	for (int i3 = f3; i3 <= e3; ++i3)
@@ -212,7 +224,7 @@ struct LoopApplyEvaluator
     int e4 = domain[4].last();
     int e5 = domain[5].last();
     int e6 = domain[6].last();
-#pragma omp parallel for
+#pragma omp parallel for if (parallel(op, domain))
     for (int i6 = f6; i6 <= e6; ++i6)
       for (int i5 = f5; i5 <= e5; ++i5)
 	for (int i4 = f4; i4 <= e4; ++i4)
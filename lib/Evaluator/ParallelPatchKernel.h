@@ -0,0 +1,224 @@
+// -*- C++ -*-
+//
+// Copyright (C) 1998, 1999, 2000, 2002  Los Alamos National Laboratory,
+// Copyright (C) 1998, 1999, 2000, 2002  CodeSourcery, LLC
+//
+// This file is part of FreePOOMA.
+//
+// FreePOOMA is free software; you can redistribute it and/or modify it
+// under the terms of the Expat license.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the Expat
+// license for more details.
+//
+// You should have received a copy of the Expat license along with
+// FreePOOMA; see the file LICENSE.
+//
+
+//-----------------------------------------------------------------------------
+// Classes:
+// ParallelPatchKernel<LHS,Op,RHS,EvalTag>
+//
+// Functions:
+// independentPatches()
+//-----------------------------------------------------------------------------
+
+#ifndef POOMA_EVALUATOR_PARALLELPATCHKERNEL_H
+#define POOMA_EVALUATOR_PARALLELPATCHKERNEL_H
+
+/** @file
+ * @ingroup Evaluator
+ * @brief
+ * A ParallelPatchKernel evaluates an expression on several patches at once,
+ * running the patches concurrently with OpenMP.
+ */
+
+//-----------------------------------------------------------------------------
+// Includes:
+//-----------------------------------------------------------------------------
+
+#include "Threads/PoomaSmarts.h"
+#include "Evaluator/ExpressionKernel.h"
+#include "Evaluator/ElementCost.h"
+#include "Evaluator/Footprint.h"
+#include "Evaluator/RequestLocks.h"
+#include "Engine/EngineFunctor.h"
+#include "Pooma/Configuration.h"
+#include <vector>
+#include <utility>
+#include <algorithm>
+
+//-----------------------------------------------------------------------------
+// Forward Declarations:
+//-----------------------------------------------------------------------------
+
+/**
+ * A ParallelPatchKernel is an iterate that holds the patch views of an
+ * expression, one left and one right hand side per patch, and evaluates
+ * them in an OpenMP parallel loop over the patches.  It requests a write
+ * lock for every left hand side patch and a read lock for every right hand
+ * side object that is not written, so it waits for all of the patches at
+ * once.
+ *
+ * The loops over each patch are run by KernelEvaluator<EvalTag> as in an
+ * ExpressionKernel.  Their own parallel loops are nested inside the patch
+ * loop, so they run serially unless nested parallelism is enabled (for
+ * instance with OMP_MAX_ACTIVE_LEVELS).
+ *
+ * The patches must be independent (see independentPatches()).
+ */
+
+template<class LHS, class Op, class RHS, class EvalTag>
+class ParallelPatchKernel : public Pooma::Iterate_t
+{
+public:
+
+  //
+  // Construct from the patch views and request the locks.
+  //
+  ParallelPatchKernel(const std::vector<LHS> &lhs, const Op &op,
+	      const std::vector<RHS> &rhs);
+
+  //
+  // Virtual Destructor.
+  // Release locks on the data referred to by the patches.
+  //
+  virtual ~ParallelPatchKernel();
+
+  //
+  // Do the loops.
+  //
+  virtual void run();
+
+private:
+
+  std::vector<LHS> lhs_m;
+  Op op_m;
+  std::vector<RHS> rhs_m;
+};
+
+//
+// Constructor
+// The affinity is that of the first patch.
+//
+
+template<class LHS, class Op, class RHS, class EvalTag>
+ParallelPatchKernel<LHS,Op,RHS,EvalTag>::
+ParallelPatchKernel(const std::vector<LHS> &lhs, const Op &op,
+	    const std::vector<RHS> &rhs)
+  : Pooma::Iterate_t(Pooma::scheduler()),
+    lhs_m(lhs), op_m(op), rhs_m(rhs)
+{
+  PAssert(lhs_m.size() > 0 && lhs_m.size() == rhs_m.size());
+
+  hintAffinity(engineFunctor(lhs_m[0], DataObjectRequest<BlockAffinity>()));
+
+  std::vector<Pooma::DataObject_t*> written;
+  int n, size = lhs_m.size();
+  for (n = 0; n < size; ++n)
+    engineFunctor(lhs_m[n], DataObjectRequest<WriteManyRequest>(*this,
+								 written));
+  for (n = 0; n < size; ++n)
+    engineFunctor(rhs_m[n], DataObjectRequest<ReadManyRequest>(*this,
+								written));
+}
+
+template<class LHS, class Op, class RHS, class EvalTag>
+ParallelPatchKernel<LHS,Op,RHS,EvalTag>::~ParallelPatchKernel()
+{
+  std::vector<Pooma::DataObject_t*> written;
+  int n, size = lhs_m.size();
+  for (n = 0; n < size; ++n)
+    engineFunctor(lhs_m[n], DataObjectRequest<WriteManyRelease>(written));
+  for (n = 0; n < size; ++n)
+    engineFunctor(rhs_m[n], DataObjectRequest<ReadManyRelease>(written));
+}
+
+//
+// Evaluate the patches.
+// Patches can differ a lot in size, so they are handed out one at a time.
+// As for the loops in the patches, small amounts of work are not worth
+// starting the threads for.  The kernels copy their engines, and patches
+// may read the same data block, so the threads share reference counts;
+// without atomic counts the patches are evaluated serially.
+//
+
+template<class LHS, class Op, class RHS, class EvalTag>
+void
+ParallelPatchKernel<LHS,Op,RHS,EvalTag>::run()
+{
+  int size = lhs_m.size();
+#if defined(_OPENMP) && POOMA_ATOMIC_REFCOUNTS
+  long elements = 0;
+  for (int n = 0; n < size; ++n)
+    elements += lhs_m[n].domain().size();
+  bool parallel =
+    Pooma::parallelWork(elements, AssignCost<LHS,RHS>::cost);
+#elif defined(_OPENMP)
+  bool parallel = false;
+#endif
+#pragma omp parallel for schedule(dynamic, 1) if (parallel)
+  for (int n = 0; n < size; ++n)
+    KernelEvaluator<EvalTag>::evaluate(lhs_m[n], op_m, rhs_m[n]);
+}
+
+/**
+ * independentPatches(lhs, rhs) is true if the patch views can be evaluated
+ * in any order.  A right hand side may read an object written by any of
+ * the patches only at exactly the elements its own patch writes, which
+ * rules out reading other patches of the left hand side.  Patches that
+ * write to the same data object must all know which elements they write.
+ */
+
+template<class LHS, class RHS>
+bool
+independentPatches(const std::vector<LHS> &lhs, const std::vector<RHS> &rhs)
+{
+  std::vector<Footprint> allWrites;
+  std::vector<int> owner;
+  int n, size = lhs.size();
+  for (n = 0; n < size; ++n)
+    {
+      expressionApply(lhs[n], FootprintTag(allWrites));
+      owner.resize(allWrites.size(), n);
+    }
+
+  // Sort the writes by data object, so the writes of one object by
+  // different patches are next to each other.
+
+  typedef std::pair<Pooma::DataObject_t *, int> Write_t;
+  int i, j, writes = allWrites.size();
+  std::vector<Write_t> sorted(writes);
+  for (i = 0; i < writes; ++i)
+    sorted[i] = Write_t(allWrites[i].object_m, i);
+  std::sort(sorted.begin(), sorted.end());
+
+  for (i = 0; i < writes; i = j)
+    {
+      bool shared = false, unknown = false;
+      int patch = owner[sorted[i].second];
+      for (j = i; j < writes && sorted[j].first == sorted[i].first; ++j)
+	{
+	  shared = shared || owner[sorted[j].second] != patch;
+	  unknown = unknown || !allWrites[sorted[j].second].known();
+	}
+      if (shared && unknown)
+	return false;
+    }
+
+  std::vector<Pooma::DataObject_t *> objects = writtenObjects(allWrites);
+  for (n = 0; n < size; ++n)
+    {
+      std::vector<Footprint> patchWrites, reads;
+      expressionApply(lhs[n], FootprintTag(patchWrites));
+      expressionApply(rhs[n], FootprintTag(reads));
+      if (!footprintsCovered(objects, patchWrites, reads))
+	return false;
+    }
+
+  return true;
+}
+
+#endif     // POOMA_EVALUATOR_PARALLELPATCHKERNEL_H
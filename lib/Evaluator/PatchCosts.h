@@ -0,0 +1,180 @@
+// -*- C++ -*-
+//
+// Copyright (C) 1998, 1999, 2000, 2002  Los Alamos National Laboratory,
+// Copyright (C) 1998, 1999, 2000, 2002  CodeSourcery, LLC
+//
+// This file is part of FreePOOMA.
+//
+// FreePOOMA is free software; you can redistribute it and/or modify it
+// under the terms of the Expat license.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the Expat
+// license for more details.
+//
+// You should have received a copy of the Expat license along with
+// FreePOOMA; see the file LICENSE.
+//
+
+//-----------------------------------------------------------------------------
+// Classes:
+// PatchCosts<Dim>
+//-----------------------------------------------------------------------------
+
+/** @file
+ * @ingroup Evaluator
+ * @brief
+ * PatchCosts measures how long the evaluation of each patch of a layout
+ * takes, to balance the patches with a WeightedMapper.
+ */
+
+#ifndef POOMA_EVALUATOR_PATCHCOSTS_H
+#define POOMA_EVALUATOR_PATCHCOSTS_H
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+
+#include "Utilities/PAssert.h"
+#include "Utilities/Unique.h"
+#include <vector>
+#include <algorithm>
+
+
+/**
+ * A PatchCosts<Dim> object adds up the time spent evaluating each patch
+ * of a layout, in the order of the global IDs of the layout's nodes.
+ * While it is started, the MultiPatch evaluator evaluates expressions
+ * whose left hand side is on the layout, or a view of it, one patch at a
+ * time, waiting for each patch to finish, and charges the time to the
+ * left hand side's patch.  This is slower than normal evaluation, so
+ * start it for a few representative time steps only:
+ *
+ *   PatchCosts<2> costs(layout);
+ *   costs.start();
+ *   step();
+ *   costs.stop();
+ *   layout.repartition(partition, WeightedMapper<2>(costs.costs()));
+ *
+ * Reductions and stencils that do not assign to the layout are not
+ * counted.  Each context measures its own patches only.
+ */
+
+template<int Dim>
+class PatchCosts
+{
+public:
+
+  //===========================================================================
+  // Exported typedefs and constants
+  //===========================================================================
+
+  typedef Unique::Value_t                               ID_t;
+
+  //===========================================================================
+  // Constructors and destructor
+  //===========================================================================
+
+  // Measure the patches of the layout.  The costs start out zero.
+
+  template<class Layout>
+  explicit PatchCosts(const Layout &layout)
+    : layoutID_m(layout.ID()), costs_m(layout.sizeGlobal(), 0.0)
+  { }
+
+  ~PatchCosts()
+  {
+    stop();
+  }
+
+  //===========================================================================
+  // Accessors
+  //===========================================================================
+
+  ID_t layoutID() const { return layoutID_m; }
+
+  int size() const { return costs_m.size(); }
+
+  double operator[](int patch) const { return costs_m[patch]; }
+
+  const std::vector<double> &costs() const { return costs_m; }
+
+  bool started() const
+  {
+    return std::find(started_s.begin(), started_s.end(), this)
+      != started_s.end();
+  }
+
+  //===========================================================================
+  // Modifiers
+  //===========================================================================
+
+  // Start and stop measuring.  Only one object per layout measures at a
+  // time.
+
+  void start()
+  {
+    PInsist(find(layoutID_m) == 0 || find(layoutID_m) == this,
+	    "The layout's patches are already being measured.");
+    if (!started())
+      started_s.push_back(this);
+  }
+
+  void stop()
+  {
+    typename std::vector<PatchCosts<Dim> *>::iterator p =
+      std::find(started_s.begin(), started_s.end(), this);
+    if (p != started_s.end())
+      started_s.erase(p);
+  }
+
+  // Set the costs to zero.
+
+  void reset()
+  {
+    std::fill(costs_m.begin(), costs_m.end(), 0.0);
+  }
+
+  // Add time to the cost of a patch.
+
+  void add(int patch, double seconds)
+  {
+    PAssert(patch >= 0 && patch < size());
+    costs_m[patch] += seconds;
+  }
+
+  // Return the started PatchCosts for the layout with the given ID, or 0.
+
+  static PatchCosts<Dim> *find(ID_t layoutID)
+  {
+    int n = started_s.size();
+    for (int i = 0; i < n; ++i)
+      if (started_s[i]->layoutID() == layoutID)
+	return started_s[i];
+    return 0;
+  }
+
+  // Return whether any PatchCosts is started, so the evaluator can
+  // skip looking for one.
+
+  static bool any() { return !started_s.empty(); }
+
+private:
+
+  // Don't copy, so the list of started objects stays valid.
+
+  PatchCosts(const PatchCosts<Dim> &);
+  PatchCosts<Dim> &operator=(const PatchCosts<Dim> &);
+
+  ID_t layoutID_m;
+  std::vector<double> costs_m;
+
+  static std::vector<PatchCosts<Dim> *> started_s;
+};
+
+template<int Dim>
+std::vector<PatchCosts<Dim> *> PatchCosts<Dim>::started_s;
+
+
+#endif // POOMA_EVALUATOR_PATCHCOSTS_H
@@ -365,6 +365,8 @@ public:
   {
     Pooma::Scheduler_t &scheduler = Pooma::scheduler();
 
+    finishPendingWrites();
+
     int n = a1.numPatchesLocal();
     int i;
 
@@ -433,6 +435,9 @@ public:
 		 const PatchParticle2<Write1, Write2> &) const
   {
     Pooma::Scheduler_t &scheduler = Pooma::scheduler();
+
+    finishPendingWrites();
+
     scheduler.beginGeneration();
 
     int n1 = a1.numPatchesLocal();
@@ -477,6 +482,9 @@ public:
 		 const PatchParticle3<Write1, Write2, Write3> &) const
   {
     Pooma::Scheduler_t &scheduler = Pooma::scheduler();
+
+    finishPendingWrites();
+
     Pooma::beginExpression();
 
     int n1 = a1.numPatchesLocal();
@@ -554,6 +562,18 @@ public:
   }
 
 private:
+
+  // The function may write arrays that the scheduler does not know about,
+  // such as the field of a particle scatter.  With threads, statements
+  // handed off before could still be writing them, so they are finished
+  // first.  Without threads they have run by the time the kernels do.
+
+  static void finishPendingWrites()
+  {
+#if POOMA_THREADS || POOMA_SMARTS_SCHEDULER_WORKSTEALING
+    Pooma::blockAndEvaluate();
+#endif
+  }
 };
 
 
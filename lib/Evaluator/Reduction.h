@@ -213,7 +213,8 @@ struct Reduction<MultiPatchEvaluatorTag>
   //      the resulting array. Increment the semaphore and store the result in 
   //      the appropriate slot of the vals vector.
   //   5. Wait for all reductions to finish.
-  //   6. Finish by doing an immediate reduction of the vals array.
+  //   6. Finish by doing an immediate reduction of the vals array, in
+  //      patch order (with Kahan summation for deterministic sums).
 
   template<class T, class Op, class Expr>
   void evaluate(T &ret, const Op &op, const Expr &e) const
@@ -243,9 +244,19 @@ struct Reduction<MultiPatchEvaluatorTag>
 
     csem.wait();
 
-    ret = vals[0];
-    for (j = 1; j < n; j++)
-      op(ret, vals[j]);
+    if (Pooma::deterministicReductions())
+      {
+	ReductionAccumulator<Op, T> answer(vals[0]);
+	for (j = 1; j < n; j++)
+	  answer(op, vals[j]);
+	ret = answer.value();
+      }
+    else
+      {
+	ret = vals[0];
+	for (j = 1; j < n; j++)
+	  op(ret, vals[j]);
+      }
     delete [] vals;
   }
 };
@@ -24,7 +24,10 @@
 // Class: 
 //   ReductionEvaluator<InlineKernelTag>
 //   ReductionEvaluator<CompressibleKernelTag>
+//   ReductionEvaluator<TiledCompressibleKernelTag>
 //   CompressibleReduce<T, Op>
+//   PartialReduction<T>
+//   ReductionAccumulator<Op, T>
 //-----------------------------------------------------------------------------
 
 
@@ -33,21 +36,36 @@
  * @brief
  * ReductionEvaluator<InlineKernelTag> reduces expressions by inlining a 
  * simple loop. ReductionEvaluator<CompressibleKernelTag> can optionally take
- * advantage of compression.
+ * advantage of compression.  ReductionEvaluator<TiledCompressibleKernelTag>
+ * does the same one tile at a time.
+ *
+ * If Pooma::deterministicReductions() is true, the inline reductions cut
+ * the domain into blocks that do not depend on the number of threads and
+ * combine the partial results of the blocks in a fixed order, so the
+ * result is the same for any number of threads.
  */
 
 //-----------------------------------------------------------------------------
 // Includes:
 //-----------------------------------------------------------------------------
 
+#include "Domain/Interval.h"
 #include "Engine/EngineFunctor.h"
+#include "Engine/TiledCompressibleBrick.h"
 #include "Evaluator/CompressibleEngines.h"
+#include "Evaluator/ElementCost.h"
 #include "Evaluator/KernelTags.h"
 #include "PETE/OperatorTags.h"
 #include "Pooma/PoomaOperatorTags.h"
 #include "Utilities/WrappedInt.h"
 #include "Utilities/PAssert.h"
+#include "Pooma/Pooma.h"
+#include "Pooma/View.h"
+#include <algorithm>
 #include <limits>
+#include <vector>
+#include <new>
+#include <stddef.h>
 
 #ifdef _OPENMP
 #include <omp.h>
@@ -105,15 +123,16 @@ struct ReductionTraits<OpBitwiseAndAssign, T> {
 
 
 /**
- * Class to hold static array for partial reduction results
- * and routine for final reduction. Two versions, one dummy
- * for non-OpenMP, one for OpenMP operation.
+ * Class to hold partial reduction results and routine for final
+ * reduction. Two versions, one dummy for non-OpenMP, one for OpenMP
+ * operation.  The OpenMP version gives every reduction its own storage
+ * with the result of each thread in a separate cache line, so threads do
+ * not share cache lines and reductions may run concurrently.
  */
 
 #ifndef _OPENMP
 template<class T>
 struct PartialReduction {
-  static inline void init() {}
   inline void storePartialResult(const T& result)
   {
     answer = result;
@@ -128,34 +147,134 @@ struct PartialReduction {
 #else
 template<class T>
 struct PartialReduction {
-  static inline void init()
+  enum { lineSize = 64 };
+  enum { stride = (sizeof(T) + lineSize - 1) / lineSize * lineSize };
+
+  PartialReduction()
+    : num_threads(0),
+      storage(new char[omp_get_max_threads() * stride + lineSize])
   {
-    if (!answer)
-      answer = new T[omp_get_max_threads()];
+    // Start the first result on a cache line boundary.
+    size_t offset = reinterpret_cast<size_t>(storage) % lineSize;
+    answer = storage + (offset ? lineSize - offset : 0);
+  }
+  ~PartialReduction()
+  {
+    for (int i = 0; i < num_threads; ++i)
+      partialResult(i).~T();
+    delete [] storage;
+  }
+  inline T &partialResult(int n)
+  {
+    return *reinterpret_cast<T *>(answer + n * stride);
   }
   inline void storePartialResult(const T& result)
   {
     int n = omp_get_thread_num();
-    answer[n] = result;
+    new (answer + n * stride) T(result);
     if (n == 0)
       num_threads = omp_get_num_threads();
   }
   template <class Op>
   inline void reduce(T& ret, const Op& op)
   {
-    T res = answer[0];
+    T res = partialResult(0);
     for (int i = 1; i<num_threads; ++i)
-      op(res, answer[i]);
+      op(res, partialResult(i));
     ret = res;
   }
   int num_threads;
-  static T *answer;
+  char *storage;
+  char *answer;
 };
-template <class T>
-T *PartialReduction<T>::answer = NULL;
 #endif
 
 
+/**
+ * ReductionAccumulator<Op, T> collects values for deterministic
+ * reductions.  The general version just applies the operator.  Sums of
+ * floating point values use Kahan summation, which carries the rounding
+ * error along in a correction term.
+ */
+
+template<class Op, class T>
+struct ReductionAccumulator {
+  ReductionAccumulator()
+    : value_m(ReductionTraits<Op, T>::identity())
+  { }
+  ReductionAccumulator(const T &value)
+    : value_m(value)
+  { }
+  template<class T1>
+  inline void operator()(const Op &op, const T1 &value)
+  {
+    op(value_m, value);
+  }
+  inline void combine(const Op &op, const ReductionAccumulator &a)
+  {
+    op(value_m, a.value_m);
+  }
+  inline const T &value() const { return value_m; }
+  T value_m;
+};
+
+template<class T>
+struct KahanAccumulator {
+  KahanAccumulator()
+    : sum_m(0), correction_m(0)
+  { }
+  KahanAccumulator(const T &value)
+    : sum_m(value), correction_m(0)
+  { }
+  inline void add(const T &value)
+  {
+    T y = value - correction_m;
+    T t = sum_m + y;
+    correction_m = (t - sum_m) - y;
+    sum_m = t;
+  }
+  template<class T1>
+  inline void operator()(const OpAddAssign &, const T1 &value)
+  {
+    add(value);
+  }
+  inline void combine(const OpAddAssign &, const KahanAccumulator &a)
+  {
+    add(a.sum_m);
+    add(-a.correction_m);
+  }
+  inline const T &value() const { return sum_m; }
+  T sum_m, correction_m;
+};
+
+template<>
+struct ReductionAccumulator<OpAddAssign, float>
+  : public KahanAccumulator<float> {
+  ReductionAccumulator() { }
+  ReductionAccumulator(const float &value)
+    : KahanAccumulator<float>(value)
+  { }
+};
+
+template<>
+struct ReductionAccumulator<OpAddAssign, double>
+  : public KahanAccumulator<double> {
+  ReductionAccumulator() { }
+  ReductionAccumulator(const double &value)
+    : KahanAccumulator<double>(value)
+  { }
+};
+
+template<>
+struct ReductionAccumulator<OpAddAssign, long double>
+  : public KahanAccumulator<long double> {
+  ReductionAccumulator() { }
+  ReductionAccumulator(const long double &value)
+    : KahanAccumulator<long double>(value)
+  { }
+};
+
+
 //-----------------------------------------------------------------------------
 // Forward Declarations:
 //-----------------------------------------------------------------------------
@@ -192,9 +311,22 @@ struct ReductionEvaluator<InlineKernelTag>
     for (int i=0; i<Domain_t::dimensions; ++i)
       PAssert(e.domain()[i].first() == 0);
 
-    PartialReduction<T>::init();
-    evaluate(ret, op, e, e.domain(),
-      WrappedInt<Domain_t::dimensions>());
+    if (Pooma::deterministicReductions())
+      evaluateDeterministic(ret, op, e, e.domain(),
+        WrappedInt<Domain_t::dimensions>());
+    else
+      evaluate(ret, op, e, e.domain(),
+        WrappedInt<Domain_t::dimensions>());
+  }
+
+  //---------------------------------------------------------------------------
+  // Return whether reducing the expression over the domain is enough work
+  // to be worth an OpenMP parallel region.
+
+  template<class Expr, class Domain>
+  inline static bool parallel(const Expr &, const Domain &domain)
+  {
+    return Pooma::parallelWork(domain.size(), 1 + ElementCost<Expr>::cost);
   }
 
   //---------------------------------------------------------------------------
@@ -235,7 +367,7 @@ struct ReductionEvaluator<InlineKernelTag>
     int e0 = domain[0].length();
 
     PartialReduction<T> reduction;
-#pragma omp parallel if (e0 > 512)
+#pragma omp parallel if (parallel(e, domain))
     {
       T answer = ReductionTraits<Op, T>::identity();
 #pragma omp for nowait
@@ -255,7 +387,7 @@ struct ReductionEvaluator<InlineKernelTag>
     int e1 = domain[1].length();
 
     PartialReduction<T> reduction;
-#pragma omp parallel
+#pragma omp parallel if (parallel(e, domain))
     {
       T answer = ReductionTraits<Op, T>::identity();
 #pragma omp for nowait
@@ -271,13 +403,19 @@ struct ReductionEvaluator<InlineKernelTag>
   inline static void evaluate(T &ret, const Op &op, const Expr &e,
     const Domain &domain, WrappedInt<3>)
   {
+    if (Pooma::tiledEvaluation())
+      {
+	evaluateTiled(ret, op, e, domain, WrappedInt<3>());
+	return;
+      }
+
     Expr localExpr(e);
     int e0 = domain[0].length();
     int e1 = domain[1].length();
     int e2 = domain[2].length();
     
     PartialReduction<T> reduction;
-#pragma omp parallel
+#pragma omp parallel if (parallel(e, domain))
     {
       T answer = ReductionTraits<Op, T>::identity();
 #pragma omp for nowait
@@ -294,6 +432,12 @@ struct ReductionEvaluator<InlineKernelTag>
   inline static void evaluate(T &ret, const Op &op, const Expr &e,
     const Domain &domain, WrappedInt<4>)
   {
+    if (Pooma::tiledEvaluation())
+      {
+	evaluateTiled(ret, op, e, domain, WrappedInt<4>());
+	return;
+      }
+
     Expr localExpr(e);
     int e0 = domain[0].length();
     int e1 = domain[1].length();
@@ -301,7 +445,7 @@ struct ReductionEvaluator<InlineKernelTag>
     int e3 = domain[3].length();
     
     PartialReduction<T> reduction;
-#pragma omp parallel
+#pragma omp parallel if (parallel(e, domain))
     {
       T answer = ReductionTraits<Op, T>::identity();
 #pragma omp for nowait
@@ -319,6 +463,12 @@ struct ReductionEvaluator<InlineKernelTag>
   inline static void evaluate(T &ret, const Op &op, const Expr &e,
     const Domain &domain, WrappedInt<5>)
   {
+    if (Pooma::tiledEvaluation())
+      {
+	evaluateTiled(ret, op, e, domain, WrappedInt<5>());
+	return;
+      }
+
     Expr localExpr(e);
     int e0 = domain[0].length();
     int e1 = domain[1].length();
@@ -327,7 +477,7 @@ struct ReductionEvaluator<InlineKernelTag>
     int e4 = domain[4].length();
     
     PartialReduction<T> reduction;
-#pragma omp parallel
+#pragma omp parallel if (parallel(e, domain))
     {
       T answer = ReductionTraits<Op, T>::identity();
 #pragma omp for nowait
@@ -346,6 +496,12 @@ struct ReductionEvaluator<InlineKernelTag>
   inline static void evaluate(T &ret, const Op &op, const Expr &e,
     const Domain &domain, WrappedInt<6>)
   {
+    if (Pooma::tiledEvaluation())
+      {
+	evaluateTiled(ret, op, e, domain, WrappedInt<6>());
+	return;
+      }
+
     Expr localExpr(e);
     int e0 = domain[0].length();
     int e1 = domain[1].length();
@@ -355,7 +511,7 @@ struct ReductionEvaluator<InlineKernelTag>
     int e5 = domain[5].length();
     
     PartialReduction<T> reduction;
-#pragma omp parallel
+#pragma omp parallel if (parallel(e, domain))
     {
       T answer = ReductionTraits<Op, T>::identity();
 #pragma omp for nowait
@@ -375,6 +531,12 @@ struct ReductionEvaluator<InlineKernelTag>
   inline static void evaluate(T &ret, const Op &op, const Expr &e,
     const Domain &domain, WrappedInt<7>)
   {
+    if (Pooma::tiledEvaluation())
+      {
+	evaluateTiled(ret, op, e, domain, WrappedInt<7>());
+	return;
+      }
+
     Expr localExpr(e);
     int e0 = domain[0].length();
     int e1 = domain[1].length();
@@ -385,7 +547,7 @@ struct ReductionEvaluator<InlineKernelTag>
     int e6 = domain[6].length();
     
     PartialReduction<T> reduction;
-#pragma omp parallel
+#pragma omp parallel if (parallel(e, domain))
     {
       T answer = ReductionTraits<Op, T>::identity();
 #pragma omp for nowait
@@ -401,6 +563,343 @@ struct ReductionEvaluator<InlineKernelTag>
     }
     reduction.reduce(ret, op);
   }
+  //---------------------------------------------------------------------------
+  // Cache-blocked versions of the reductions above for dimensions 3 through
+  // 7, used when Pooma::tiledEvaluation() is true.  The tiling is the same
+  // as for KernelEvaluator<InlineKernelTag>::evaluateTiled(): dimensions 0
+  // and 1 are cut into tiles and dimension 2 is streamed through each tile.
+
+  template<class T, class Op, class Expr, class Domain>
+  inline static void evaluateTiled(T &ret, const Op &op, const Expr &e,
+    const Domain &domain, WrappedInt<3>)
+  {
+    Expr localExpr(e);
+    int e0 = domain[0].length();
+    int e1 = domain[1].length();
+    int e2 = domain[2].length();
+    int t0 = Pooma::tileExtent(0);
+    int t1 = Pooma::tileExtent(1);
+    int n0 = (e0 + t0 - 1) / t0;
+    int nt = n0 * ((e1 + t1 - 1) / t1);
+
+    PartialReduction<T> reduction;
+#pragma omp parallel if (parallel(e, domain))
+    {
+      T answer = ReductionTraits<Op, T>::identity();
+#pragma omp for nowait
+      for (int it = 0; it < nt; ++it)
+	{
+	  int f0 = (it % n0) * t0, l0 = std::min(f0 + t0, e0);
+	  int f1 = (it / n0) * t1, l1 = std::min(f1 + t1, e1);
+	  for (int i2 = 0; i2 < e2; ++i2)
+	    for (int i1 = f1; i1 < l1; ++i1)
+	      for (int i0 = f0; i0 < l0; ++i0)
+		op(answer, localExpr.read(i0, i1, i2));
+	}
+      reduction.storePartialResult(answer);
+    }
+    reduction.reduce(ret, op);
+  }
+
+  template<class T, class Op, class Expr, class Domain>
+  inline static void evaluateTiled(T &ret, const Op &op, const Expr &e,
+    const Domain &domain, WrappedInt<4>)
+  {
+    Expr localExpr(e);
+    int e0 = domain[0].length();
+    int e1 = domain[1].length();
+    int e2 = domain[2].length();
+    int e3 = domain[3].length();
+    int t0 = Pooma::tileExtent(0);
+    int t1 = Pooma::tileExtent(1);
+    int n0 = (e0 + t0 - 1) / t0;
+    int nt = n0 * ((e1 + t1 - 1) / t1);
+
+    PartialReduction<T> reduction;
+#pragma omp parallel if (parallel(e, domain))
+    {
+      T answer = ReductionTraits<Op, T>::identity();
+#pragma omp for nowait
+      for (int i3 = 0; i3 < e3; ++i3)
+	for (int it = 0; it < nt; ++it)
+	  {
+	    int f0 = (it % n0) * t0, l0 = std::min(f0 + t0, e0);
+	    int f1 = (it / n0) * t1, l1 = std::min(f1 + t1, e1);
+	    for (int i2 = 0; i2 < e2; ++i2)
+	      for (int i1 = f1; i1 < l1; ++i1)
+		for (int i0 = f0; i0 < l0; ++i0)
+		  op(answer, localExpr.read(i0, i1, i2, i3));
+	  }
+      reduction.storePartialResult(answer);
+    }
+    reduction.reduce(ret, op);
+  }
+
+  template<class T, class Op, class Expr, class Domain>
+  inline static void evaluateTiled(T &ret, const Op &op, const Expr &e,
+    const Domain &domain, WrappedInt<5>)
+  {
+    Expr localExpr(e);
+    int e0 = domain[0].length();
+    int e1 = domain[1].length();
+    int e2 = domain[2].length();
+    int e3 = domain[3].length();
+    int e4 = domain[4].length();
+    int t0 = Pooma::tileExtent(0);
+    int t1 = Pooma::tileExtent(1);
+    int n0 = (e0 + t0 - 1) / t0;
+    int nt = n0 * ((e1 + t1 - 1) / t1);
+
+    PartialReduction<T> reduction;
+#pragma omp parallel if (parallel(e, domain))
+    {
+      T answer = ReductionTraits<Op, T>::identity();
+#pragma omp for nowait
+      for (int i4 = 0; i4 < e4; ++i4)
+	for (int i3 = 0; i3 < e3; ++i3)
+	  for (int it = 0; it < nt; ++it)
+	    {
+	      int f0 = (it % n0) * t0, l0 = std::min(f0 + t0, e0);
+	      int f1 = (it / n0) * t1, l1 = std::min(f1 + t1, e1);
+	      for (int i2 = 0; i2 < e2; ++i2)
+		for (int i1 = f1; i1 < l1; ++i1)
+		  for (int i0 = f0; i0 < l0; ++i0)
+		    op(answer, localExpr.read(i0, i1, i2, i3, i4));
+	    }
+      reduction.storePartialResult(answer);
+    }
+    reduction.reduce(ret, op);
+  }
+
+  template<class T, class Op, class Expr, class Domain>
+  inline static void evaluateTiled(T &ret, const Op &op, const Expr &e,
+    const Domain &domain, WrappedInt<6>)
+  {
+    Expr localExpr(e);
+    int e0 = domain[0].length();
+    int e1 = domain[1].length();
+    int e2 = domain[2].length();
+    int e3 = domain[3].length();
+    int e4 = domain[4].length();
+    int e5 = domain[5].length();
+    int t0 = Pooma::tileExtent(0);
+    int t1 = Pooma::tileExtent(1);
+    int n0 = (e0 + t0 - 1) / t0;
+    int nt = n0 * ((e1 + t1 - 1) / t1);
+
+    PartialReduction<T> reduction;
+#pragma omp parallel if (parallel(e, domain))
+    {
+      T answer = ReductionTraits<Op, T>::identity();
+#pragma omp for nowait
+      for (int i5 = 0; i5 < e5; ++i5)
+	for (int i4 = 0; i4 < e4; ++i4)
+	  for (int i3 = 0; i3 < e3; ++i3)
+	    for (int it = 0; it < nt; ++it)
+	      {
+		int f0 = (it % n0) * t0, l0 = std::min(f0 + t0, e0);
+		int f1 = (it / n0) * t1, l1 = std::min(f1 + t1, e1);
+		for (int i2 = 0; i2 < e2; ++i2)
+		  for (int i1 = f1; i1 < l1; ++i1)
+		    for (int i0 = f0; i0 < l0; ++i0)
+		      op(answer, localExpr.read(i0, i1, i2, i3, i4, i5));
+	      }
+      reduction.storePartialResult(answer);
+    }
+    reduction.reduce(ret, op);
+  }
+
+  template<class T, class Op, class Expr, class Domain>
+  inline static void evaluateTiled(T &ret, const Op &op, const Expr &e,
+    const Domain &domain, WrappedInt<7>)
+  {
+    Expr localExpr(e);
+    int e0 = domain[0].length();
+    int e1 = domain[1].length();
+    int e2 = domain[2].length();
+    int e3 = domain[3].length();
+    int e4 = domain[4].length();
+    int e5 = domain[5].length();
+    int e6 = domain[6].length();
+    int t0 = Pooma::tileExtent(0);
+    int t1 = Pooma::tileExtent(1);
+    int n0 = (e0 + t0 - 1) / t0;
+    int nt = n0 * ((e1 + t1 - 1) / t1);
+
+    PartialReduction<T> reduction;
+#pragma omp parallel if (parallel(e, domain))
+    {
+      T answer = ReductionTraits<Op, T>::identity();
+#pragma omp for nowait
+      for (int i6 = 0; i6 < e6; ++i6)
+	for (int i5 = 0; i5 < e5; ++i5)
+	  for (int i4 = 0; i4 < e4; ++i4)
+	    for (int i3 = 0; i3 < e3; ++i3)
+	      for (int it = 0; it < nt; ++it)
+		{
+		  int f0 = (it % n0) * t0, l0 = std::min(f0 + t0, e0);
+		  int f1 = (it / n0) * t1, l1 = std::min(f1 + t1, e1);
+		  for (int i2 = 0; i2 < e2; ++i2)
+		    for (int i1 = f1; i1 < l1; ++i1)
+		      for (int i0 = f0; i0 < l0; ++i0)
+			op(answer, localExpr.read(i0, i1, i2, i3, i4, i5, i6));
+		}
+      reduction.storePartialResult(answer);
+    }
+    reduction.reduce(ret, op);
+  }
+
+
+  //---------------------------------------------------------------------------
+  // Deterministic reductions, used when Pooma::deterministicReductions() is
+  // true.  The last dimension is cut into blocks of about blockSize
+  // elements.  Each block is reduced in order by one thread and the results
+  // of the blocks are combined pairwise in a fixed order, so neither the
+  // grouping nor the order of the operations depends on the number of
+  // threads.  Sums of floating point values use Kahan summation.
+
+  enum { blockSize = 4096 };
+
+  template<class T, class Op, class Expr, class Domain, int Dim>
+  inline static void evaluateDeterministic(T &ret, const Op &op,
+    const Expr &e, const Domain &domain, WrappedInt<Dim>)
+  {
+    typedef ReductionAccumulator<Op, T> Accumulator_t;
+
+    Expr localExpr(e);
+    int outer = domain[Dim - 1].length();
+    if (outer == 0)
+      {
+	ret = ReductionTraits<Op, T>::identity();
+	return;
+      }
+    int inner = domain.size() / outer;
+    int slabs = std::max(1, blockSize / std::max(inner, 1));
+    int nb = (outer + slabs - 1) / slabs;
+
+    std::vector<Accumulator_t> partial(nb);
+#pragma omp parallel for if (nb > 1 && parallel(e, domain))
+    for (int b = 0; b < nb; ++b)
+      {
+	Accumulator_t answer;
+	reduceBlock(answer, op, localExpr, domain,
+		    b * slabs, std::min((b + 1) * slabs, outer),
+		    WrappedInt<Dim>());
+	partial[b] = answer;
+      }
+
+    for (int step = 1; step < nb; step *= 2)
+      for (int b = 0; b + step < nb; b += 2 * step)
+	partial[b].combine(op, partial[b + step]);
+    ret = partial[0].value();
+  }
+
+  // reduceBlock() reduces the elements whose index in the last dimension
+  // is in [first, last).
+
+  template<class Acc, class Op, class Expr, class Domain>
+  inline static void reduceBlock(Acc &answer, const Op &op, const Expr &e,
+    const Domain &, int first, int last, WrappedInt<1>)
+  {
+    for (int i0 = first; i0 < last; ++i0)
+      answer(op, e.read(i0));
+  }
+
+  template<class Acc, class Op, class Expr, class Domain>
+  inline static void reduceBlock(Acc &answer, const Op &op, const Expr &e,
+    const Domain &domain, int first, int last, WrappedInt<2>)
+  {
+    int e0 = domain[0].length();
+
+    for (int i1 = first; i1 < last; ++i1)
+      for (int i0 = 0; i0 < e0; ++i0)
+	answer(op, e.read(i0, i1));
+  }
+
+  template<class Acc, class Op, class Expr, class Domain>
+  inline static void reduceBlock(Acc &answer, const Op &op, const Expr &e,
+    const Domain &domain, int first, int last, WrappedInt<3>)
+  {
+    int e0 = domain[0].length();
+    int e1 = domain[1].length();
+
+    for (int i2 = first; i2 < last; ++i2)
+      for (int i1 = 0; i1 < e1; ++i1)
+	for (int i0 = 0; i0 < e0; ++i0)
+	  answer(op, e.read(i0, i1, i2));
+  }
+
+  template<class Acc, class Op, class Expr, class Domain>
+  inline static void reduceBlock(Acc &answer, const Op &op, const Expr &e,
+    const Domain &domain, int first, int last, WrappedInt<4>)
+  {
+    int e0 = domain[0].length();
+    int e1 = domain[1].length();
+    int e2 = domain[2].length();
+
+    for (int i3 = first; i3 < last; ++i3)
+      for (int i2 = 0; i2 < e2; ++i2)
+	for (int i1 = 0; i1 < e1; ++i1)
+	  for (int i0 = 0; i0 < e0; ++i0)
+	    answer(op, e.read(i0, i1, i2, i3));
+  }
+
+  template<class Acc, class Op, class Expr, class Domain>
+  inline static void reduceBlock(Acc &answer, const Op &op, const Expr &e,
+    const Domain &domain, int first, int last, WrappedInt<5>)
+  {
+    int e0 = domain[0].length();
+    int e1 = domain[1].length();
+    int e2 = domain[2].length();
+    int e3 = domain[3].length();
+
+    for (int i4 = first; i4 < last; ++i4)
+      for (int i3 = 0; i3 < e3; ++i3)
+	for (int i2 = 0; i2 < e2; ++i2)
+	  for (int i1 = 0; i1 < e1; ++i1)
+	    for (int i0 = 0; i0 < e0; ++i0)
+	      answer(op, e.read(i0, i1, i2, i3, i4));
+  }
+
+  template<class Acc, class Op, class Expr, class Domain>
+  inline static void reduceBlock(Acc &answer, const Op &op, const Expr &e,
+    const Domain &domain, int first, int last, WrappedInt<6>)
+  {
+    int e0 = domain[0].length();
+    int e1 = domain[1].length();
+    int e2 = domain[2].length();
+    int e3 = domain[3].length();
+    int e4 = domain[4].length();
+
+    for (int i5 = first; i5 < last; ++i5)
+      for (int i4 = 0; i4 < e4; ++i4)
+	for (int i3 = 0; i3 < e3; ++i3)
+	  for (int i2 = 0; i2 < e2; ++i2)
+	    for (int i1 = 0; i1 < e1; ++i1)
+	      for (int i0 = 0; i0 < e0; ++i0)
+		answer(op, e.read(i0, i1, i2, i3, i4, i5));
+  }
+
+  template<class Acc, class Op, class Expr, class Domain>
+  inline static void reduceBlock(Acc &answer, const Op &op, const Expr &e,
+    const Domain &domain, int first, int last, WrappedInt<7>)
+  {
+    int e0 = domain[0].length();
+    int e1 = domain[1].length();
+    int e2 = domain[2].length();
+    int e3 = domain[3].length();
+    int e4 = domain[4].length();
+    int e5 = domain[5].length();
+
+    for (int i6 = first; i6 < last; ++i6)
+      for (int i5 = 0; i5 < e5; ++i5)
+	for (int i4 = 0; i4 < e4; ++i4)
+	  for (int i3 = 0; i3 < e3; ++i3)
+	    for (int i2 = 0; i2 < e2; ++i2)
+	      for (int i1 = 0; i1 < e1; ++i1)
+		for (int i0 = 0; i0 < e0; ++i0)
+		  answer(op, e.read(i0, i1, i2, i3, i4, i5, i6));
+  }
 };
 
 
@@ -484,6 +983,63 @@ struct ReductionEvaluator<CompressibleKernelTag>
   }
 };
 
+
+//-----------------------------------------------------------------------------
+// This class reduces expressions containing TiledCompressibleBricks. The
+// domain is cut into blocks the size of the tiles, and each block is
+// reduced as with ReductionEvaluator<CompressibleKernelTag>, so blocks on
+// which the expression is compressed take one step. The partial results
+// are combined in a fixed order.
+//-----------------------------------------------------------------------------
+
+template<>
+struct ReductionEvaluator<TiledCompressibleKernelTag>
+{
+  template<class T, class Op, class Expr>
+  static void evaluate(T &ret, const Op &op, const Expr &e)
+  {
+    typedef typename Expr::Domain_t Domain_t;
+    enum { dim = Domain_t::dimensions };
+    enum { extent = CompressibleTile<dim>::extent };
+    typedef Interval<dim> Block_t;
+    typedef typename View1<Expr, Block_t>::Type_t View_t;
+    typedef typename View_t::Engine_t ViewEngine_t;
+    typedef typename EngineFunctor<ViewEngine_t, Compressible>::Type_t Comp_t;
+    typedef typename CompressibleKernel<Comp_t::val, Comp_t::val>::Kernel_t
+      Kernel_t;
+
+    CTAssert(Domain_t::unitStride);
+
+    Block_t blocks;
+    for (int d = 0; d < dim; ++d)
+      {
+	PAssert(e.domain()[d].first() == 0);
+	blocks[d] = Interval<1>((e.domain()[d].length() + extent - 1) / extent);
+      }
+
+    bool first = true;
+    typename Block_t::const_iterator b = blocks.begin(), end = blocks.end();
+    for (; b != end; ++b)
+      {
+	Block_t block;
+	for (int d = 0; d < dim; ++d)
+	  {
+	    int lo = (*b)[d].first() * extent;
+	    block[d] = Interval<1>(lo, std::min(lo + extent,
+						int(e.domain()[d].length())) - 1);
+	  }
+
+	T part;
+	ReductionEvaluator<Kernel_t>::evaluate(part, op, View_t(e(block)));
+	if (first)
+	  ret = part;
+	else
+	  op(ret, part);
+	first = false;
+      }
+  }
+};
+
 #endif // POOMA_EVALUATOR_REDUCTIONEVALUATOR_H
 
 // ACL:rcsinfo
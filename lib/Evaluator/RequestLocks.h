@@ -29,6 +29,14 @@
 // DataObjectRequest<ReadRelease>
 // CountBlocks
 // DataObjectRequest<CountBlocks>
+// WriteManyRequest
+// DataObjectRequest<WriteManyRequest>
+// ReadManyRequest
+// DataObjectRequest<ReadManyRequest>
+// WriteManyRelease
+// DataObjectRequest<WriteManyRelease>
+// ReadManyRelease
+// DataObjectRequest<ReadManyRelease>
 //-----------------------------------------------------------------------------
 
 #ifndef POOMA_EVALUATOR_REQUESTLOCKS_H
@@ -48,6 +56,10 @@
  * - ReadRelease: release a read lock
  * - CountBlocks: count the number of data objects in an array
  *
+ * The ...Many... variants do the same for iterates that write to any
+ * number of data objects; they keep the written objects in a vector
+ * instead of the two pointers used by the plain requests.
+ *
  * DataObjectRequest is defined in Engine/DataObject.h.  It acts as a PETE
  * functor tag and as a tag that can be used by array's message function.
  */
@@ -64,6 +76,8 @@
 #include "Threads/PoomaSmarts.h"
 #include "Engine/DataObject.h"
 #include "Engine/EngineFunctor.h"
+#include <vector>
+#include <algorithm>
 
 //-----------------------------------------------------------------------------
 // Forward Declarations:
@@ -78,6 +92,10 @@ struct ReadRequest {};
 struct WriteRelease {};
 struct ReadRelease {};
 struct CountBlocks {};
+struct WriteManyRequest {};
+struct ReadManyRequest {};
+struct WriteManyRelease {};
+struct ReadManyRelease {};
 
 //-----------------------------------------------------------------------------
 // DataObjectRequest<WriteRequest>
@@ -332,6 +350,140 @@ public:
 };
 
 
+//-----------------------------------------------------------------------------
+// DataObjectRequest<WriteManyRequest>
+// DataObjectRequest<ReadManyRequest>
+// DataObjectRequest<WriteManyRelease>
+// DataObjectRequest<ReadManyRelease>
+// Like the requests above, but for iterates that write to more than two
+// data objects.  The written objects are collected in a vector owned by
+// the caller, so that the read requests can skip them.
+//-----------------------------------------------------------------------------
+
+template<>
+class DataObjectRequest<WriteManyRequest>
+{
+public:
+  typedef int Type_t;
+  typedef NullCombine Combine_t;
+
+  DataObjectRequest(Pooma::Iterate_t& iterate,
+		    std::vector<Pooma::DataObject_t*>& written)
+    : iterate_m(iterate), written_m(written)
+  { }
+
+  // Request each written object once.
+  inline Type_t operator()(Pooma::DataObject_t* obj) const
+  {
+    if (std::find(written_m.begin(), written_m.end(), obj) == written_m.end())
+    {
+      written_m.push_back(obj);
+      obj->request(iterate_m, Pooma::SmartsTag_t::Write);
+    }
+    return 0;
+  }
+
+  inline Type_t defaultValue() const
+  {
+    return 0;
+  }
+
+private:
+  Pooma::Iterate_t& iterate_m;
+  std::vector<Pooma::DataObject_t*>& written_m;
+};
+
+template<>
+class DataObjectRequest<ReadManyRequest>
+{
+public:
+  typedef int Type_t;
+  typedef NullCombine Combine_t;
+
+  DataObjectRequest(Pooma::Iterate_t& iterate,
+		    const std::vector<Pooma::DataObject_t*>& written)
+    : iterate_m(iterate), written_m(written)
+  { }
+
+  inline Type_t operator()(Pooma::DataObject_t* obj) const
+  {
+    if (std::find(written_m.begin(), written_m.end(), obj) == written_m.end())
+    {
+      obj->request(iterate_m, Pooma::SmartsTag_t::Read);
+    }
+    return 0;
+  }
+
+  inline Type_t defaultValue() const
+  {
+    return 0;
+  }
+
+private:
+  Pooma::Iterate_t& iterate_m;
+  const std::vector<Pooma::DataObject_t*>& written_m;
+};
+
+template<>
+class DataObjectRequest<WriteManyRelease>
+{
+public:
+  typedef int Type_t;
+  typedef NullCombine Combine_t;
+
+  DataObjectRequest(std::vector<Pooma::DataObject_t*>& written)
+    : written_m(written)
+  { }
+
+  inline Type_t operator()(Pooma::DataObject_t* obj) const
+  {
+    if (std::find(written_m.begin(), written_m.end(), obj) == written_m.end())
+    {
+      written_m.push_back(obj);
+      obj->release(Pooma::SmartsTag_t::Write);
+    }
+    return 0;
+  }
+
+  inline Type_t defaultValue() const
+  {
+    return 0;
+  }
+
+private:
+  std::vector<Pooma::DataObject_t*>& written_m;
+};
+
+template<>
+class DataObjectRequest<ReadManyRelease>
+{
+public:
+  typedef int Type_t;
+  typedef NullCombine Combine_t;
+
+  DataObjectRequest(const std::vector<Pooma::DataObject_t*>& written)
+    : written_m(written)
+  { }
+
+  inline Type_t operator()(Pooma::DataObject_t* obj) const
+  {
+    if (std::find(written_m.begin(), written_m.end(), obj) == written_m.end())
+    {
+      obj->release(Pooma::SmartsTag_t::Read);
+    }
+    return 0;
+  }
+
+  inline Type_t defaultValue() const
+  {
+    return 0;
+  }
+
+private:
+  const std::vector<Pooma::DataObject_t*>& written_m;
+};
+
+
 //-----------------------------------------------------------------------------
 // Code for ExpressionApply is provided here, since the lock requests can
 // be implemented using expressionApply (the affinity access still needs to
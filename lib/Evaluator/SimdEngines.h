@@ -0,0 +1,326 @@
+// -*- C++ -*-
+//
+// Copyright (C) 1998, 1999, 2000, 2002  Los Alamos National Laboratory,
+// Copyright (C) 1998, 1999, 2000, 2002  CodeSourcery, LLC
+//
+// This file is part of FreePOOMA.
+//
+// FreePOOMA is free software; you can redistribute it and/or modify it
+// under the terms of the Expat license.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the Expat
+// license for more details.
+//
+// You should have received a copy of the Expat license along with
+// FreePOOMA; see the file LICENSE.
+//
+
+//-----------------------------------------------------------------------------
+// Tags:
+// SimdUnitStride
+// SimdContiguous
+// SimdReadsBlock
+// SimdRowTag<Dim>
+//
+// Classes:
+// SimdRow<T>
+// LeafFunctor<Leaf,Tag>  for above tags.
+//-----------------------------------------------------------------------------
+
+#ifndef POOMA_EVALUATOR_SIMDENGINES_H
+#define POOMA_EVALUATOR_SIMDENGINES_H
+
+/** @file
+ * @ingroup Evaluator
+ * @brief
+ * Leaf functors used to select and run the SIMD kernel
+ * (see Evaluator/SimdEvaluator.h).
+ *
+ * The SIMD kernel replaces each Brick or BrickView leaf of an expression
+ * by a raw pointer to the current row of its data, so the innermost loop
+ * is a plain unit-stride loop over pointers that the compiler can
+ * vectorize.  This is only possible if every leaf is a Brick, a BrickView
+ * or a scalar.
+ */
+
+//-----------------------------------------------------------------------------
+// Includes:
+//-----------------------------------------------------------------------------
+
+#include "Domain/Loc.h"
+#include "Engine/ExpressionEngine.h"
+#include "PETE/PETE.h"
+#include "Utilities/WrappedInt.h"
+
+// The row pointers are declared restrict when the right hand side does
+// not read the left hand side.
+
+#if POOMA_NO_RESTRICT
+# define POOMA_SIMD_RESTRICT
+#elif defined(__GNUC__)
+# define POOMA_SIMD_RESTRICT __restrict__
+#else
+# define POOMA_SIMD_RESTRICT restrict
+#endif
+
+//-----------------------------------------------------------------------------
+// Forward Declarations:
+//-----------------------------------------------------------------------------
+
+template<int Dim, class T, class EngineTag> class Array;
+struct Brick;
+struct BrickView;
+
+
+/**
+ * SimdUnitStride is a compile time query: ForEach<Expr,SimdUnitStride,
+ * AndCombine>::Type_t is WrappedInt<true> if all the leaves of Expr are
+ * scalars or Arrays with Brick or BrickView engines.
+ *
+ * SimdContiguous is the corresponding run time query: a BrickView leaf
+ * only has unit stride in the first dimension if it was not taken with
+ * a strided domain.
+ *
+ * SimdReadsBlock asks whether an expression reads from the data block
+ * starting at block_m.  If the left hand side is read on the right hand
+ * side we can not promise the compiler that iterations are independent.
+ */
+
+struct SimdUnitStride
+{
+  SimdUnitStride() { }
+  ~SimdUnitStride() { }
+};
+
+struct SimdContiguous
+{
+  SimdContiguous() { }
+  ~SimdContiguous() { }
+};
+
+struct SimdReadsBlock
+{
+  SimdReadsBlock(const void *block)
+    : block_m(block)
+  { }
+  ~SimdReadsBlock() { }
+
+  const void *block_m;
+};
+
+/**
+ * SimdRowTag<Dim,Restrict> turns a leaf into a SimdRow pointing at the
+ * element with the given location; the first component of the location
+ * is the start of the row.  SimdRow<T> is evaluated with EvalLeaf<1>, so
+ * the expression built with ForEach<Expr,SimdRowTag<Dim>,TreeCombine> is
+ * evaluated like a one-dimensional expression.  With Restrict the row
+ * pointers are restrict-qualified, which is only allowed if nothing the
+ * expression reads is written through another pointer in the loop.
+ */
+
+template<int Dim, bool Restrict = false>
+struct SimdRowTag
+{
+  SimdRowTag(const Loc<Dim> &loc)
+    : loc_m(loc)
+  { }
+  ~SimdRowTag() { }
+
+  Loc<Dim> loc_m;
+};
+
+template<class T, bool Restrict = false>
+struct SimdRow
+{
+  SimdRow(const T *data)
+    : data_m(data)
+  { }
+
+  const T *data_m;
+};
+
+template<class T>
+struct SimdRow<T, true>
+{
+  SimdRow(const T *data)
+    : data_m(data)
+  { }
+
+  const T *POOMA_SIMD_RESTRICT data_m;
+};
+
+
+//-----------------------------------------------------------------------------
+// Scalars are fine for the SIMD kernel and are left untouched.
+//-----------------------------------------------------------------------------
+
+template<class T>
+struct LeafFunctor<Scalar<T>, SimdUnitStride>
+{
+  typedef WrappedInt<true> Type_t;
+  inline static
+  Type_t apply(const Scalar<T> &, const SimdUnitStride &)
+  {
+    return Type_t();
+  }
+};
+
+template<class T>
+struct LeafFunctor<Scalar<T>, SimdContiguous>
+{
+  typedef bool Type_t;
+  inline static
+  Type_t apply(const Scalar<T> &, const SimdContiguous &)
+  {
+    return true;
+  }
+};
+
+template<class T>
+struct LeafFunctor<Scalar<T>, SimdReadsBlock>
+{
+  typedef bool Type_t;
+  inline static
+  Type_t apply(const Scalar<T> &, const SimdReadsBlock &)
+  {
+    return false;
+  }
+};
+
+template<class T, int Dim, bool Restrict>
+struct LeafFunctor<Scalar<T>, SimdRowTag<Dim, Restrict> >
+{
+  typedef Scalar<T> Type_t;
+  inline static
+  Type_t apply(const Scalar<T> &s, const SimdRowTag<Dim, Restrict> &)
+  {
+    return s;
+  }
+};
+
+
+//-----------------------------------------------------------------------------
+// Arrays are only fine if they sit on top of a Brick or a BrickView.
+//-----------------------------------------------------------------------------
+
+template<int Dim, class T, class EngineTag>
+struct LeafFunctor<Array<Dim, T, EngineTag>, SimdUnitStride>
+{
+  typedef WrappedInt<false> Type_t;
+  inline static
+  Type_t apply(const Array<Dim, T, EngineTag> &, const SimdUnitStride &)
+  {
+    return Type_t();
+  }
+};
+
+template<int Dim, class T>
+struct LeafFunctor<Array<Dim, T, Brick>, SimdUnitStride>
+{
+  typedef WrappedInt<true> Type_t;
+  inline static
+  Type_t apply(const Array<Dim, T, Brick> &, const SimdUnitStride &)
+  {
+    return Type_t();
+  }
+};
+
+template<int Dim, class T>
+struct LeafFunctor<Array<Dim, T, BrickView>, SimdUnitStride>
+{
+  typedef WrappedInt<true> Type_t;
+  inline static
+  Type_t apply(const Array<Dim, T, BrickView> &, const SimdUnitStride &)
+  {
+    return Type_t();
+  }
+};
+
+template<int Dim, class T>
+struct LeafFunctor<Array<Dim, T, Brick>, SimdContiguous>
+{
+  typedef bool Type_t;
+  inline static
+  Type_t apply(const Array<Dim, T, Brick> &, const SimdContiguous &)
+  {
+    return true;
+  }
+};
+
+template<int Dim, class T>
+struct LeafFunctor<Array<Dim, T, BrickView>, SimdContiguous>
+{
+  typedef bool Type_t;
+  inline static
+  Type_t apply(const Array<Dim, T, BrickView> &a, const SimdContiguous &)
+  {
+    return a.engine().strides()[0] == 1;
+  }
+};
+
+template<int Dim, class T>
+struct LeafFunctor<Array<Dim, T, Brick>, SimdReadsBlock>
+{
+  typedef bool Type_t;
+  inline static
+  Type_t apply(const Array<Dim, T, Brick> &a, const SimdReadsBlock &tag)
+  {
+    return a.engine().dataBlock().beginPointer() == tag.block_m;
+  }
+};
+
+template<int Dim, class T>
+struct LeafFunctor<Array<Dim, T, BrickView>, SimdReadsBlock>
+{
+  typedef bool Type_t;
+  inline static
+  Type_t apply(const Array<Dim, T, BrickView> &a, const SimdReadsBlock &tag)
+  {
+    return a.engine().dataBlock().beginPointer() == tag.block_m;
+  }
+};
+
+template<int Dim, class T, bool Restrict>
+struct LeafFunctor<Array<Dim, T, Brick>, SimdRowTag<Dim, Restrict> >
+{
+  typedef SimdRow<T, Restrict> Type_t;
+  inline static
+  Type_t apply(const Array<Dim, T, Brick> &a,
+	       const SimdRowTag<Dim, Restrict> &tag)
+  {
+    return Type_t(&a.engine()(tag.loc_m));
+  }
+};
+
+template<int Dim, class T, bool Restrict>
+struct LeafFunctor<Array<Dim, T, BrickView>, SimdRowTag<Dim, Restrict> >
+{
+  typedef SimdRow<T, Restrict> Type_t;
+  inline static
+  Type_t apply(const Array<Dim, T, BrickView> &a,
+	       const SimdRowTag<Dim, Restrict> &tag)
+  {
+    return Type_t(&a.engine()(tag.loc_m));
+  }
+};
+
+
+//-----------------------------------------------------------------------------
+// Evaluating a row just indexes the pointer.
+//-----------------------------------------------------------------------------
+
+template<class T, bool Restrict>
+struct LeafFunctor<SimdRow<T, Restrict>, EvalLeaf<1> >
+{
+  typedef T Type_t;
+  inline static
+  const Type_t &apply(const SimdRow<T, Restrict> &row, const EvalLeaf<1> &f)
+  {
+    return row.data_m[f.val1()];
+  }
+};
+
+
+#endif     // POOMA_EVALUATOR_SIMDENGINES_H
@@ -0,0 +1,483 @@
+// -*- C++ -*-
+//
+// Copyright (C) 1998, 1999, 2000, 2002  Los Alamos National Laboratory,
+// Copyright (C) 1998, 1999, 2000, 2002  CodeSourcery, LLC
+//
+// This file is part of FreePOOMA.
+//
+// FreePOOMA is free software; you can redistribute it and/or modify it
+// under the terms of the Expat license.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the Expat
+// license for more details.
+//
+// You should have received a copy of the Expat license along with
+// FreePOOMA; see the file LICENSE.
+//
+
+//-----------------------------------------------------------------------------
+// Classes:
+// KernelEvaluator<SimdKernelTag>
+//-----------------------------------------------------------------------------
+
+#ifndef POOMA_EVALUATOR_SIMDEVALUATOR_H
+#define POOMA_EVALUATOR_SIMDEVALUATOR_H
+
+/** @file
+ * @ingroup Evaluator
+ * @brief
+ * SimdEvaluator evaluates expressions whose leaves are all Bricks,
+ * BrickViews or scalars with an innermost loop over raw pointers.
+ */
+
+//-----------------------------------------------------------------------------
+// Typedefs:
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// Includes:
+//-----------------------------------------------------------------------------
+
+#include "Evaluator/InlineEvaluator.h"
+#include "Evaluator/KernelTags.h"
+#include "Evaluator/SimdEngines.h"
+#include "Domain/Loc.h"
+#include "Engine/ExpressionEngine.h"
+#include "Pooma/Pooma.h"
+#include "Utilities/WrappedInt.h"
+#include "Utilities/PAssert.h"
+#include <algorithm>
+
+//-----------------------------------------------------------------------------
+// Forward Declarations:
+//-----------------------------------------------------------------------------
+
+template<class KernelTag>
+struct KernelEvaluator;
+
+/**
+ * KernelEvaluator<SimdKernelTag> is a variant of the inline evaluator
+ * for expressions where every leaf is a Brick, a BrickView or a scalar
+ * (see KernelTag<LHS,RHS>).
+ *
+ * The inline evaluator goes through Engine::operator() for every element,
+ * and for BrickViews that means a multiplication by the run time stride
+ * of the first dimension, which keeps compilers from vectorizing the
+ * innermost loop.  Here the expression is instead rebuilt for every row
+ * with each leaf replaced by a pointer to the start of that row
+ * (SimdRow<T>), and the innermost loop just indexes these pointers.
+ *
+ * The decision is finished at run time:
+ * -# If a BrickView leaf was taken with a non-unit stride in the first
+ *    dimension we fall back to KernelEvaluator<InlineKernelTag>.
+ * -# If the right hand side reads the data block of the left hand side
+ *    the loop is still run over pointers, but without the "omp simd"
+ *    promise that the iterations are independent.  Otherwise the left
+ *    hand side and the right hand side rows are restrict-qualified
+ *    (SimdRow<T,true>).
+ *
+ * The loop nests outside of the innermost loop, the OpenMP work sharing
+ * and the cache-blocking (see Pooma::tiledEvaluation()) are the same as
+ * for the inline evaluator.
+ */
+
+template<>
+struct KernelEvaluator<SimdKernelTag>
+{
+  /// Evaluate an expression on a given domain.  This checks the strides
+  /// and the aliasing of the leaves and either passes the expression on
+  /// to the inline evaluator or loops over the rows of the domain.
+
+  template<class LHS,class Op,class RHS,class Domain>
+  inline static void evaluate(const LHS& lhs,const Op& op,const RHS& rhs,
+			      const Domain& domain)
+  {
+    // All the evaluators assume unit-stride, zero-based domains.
+    CTAssert(Domain::unitStride);
+    for (int i=0; i<Domain::dimensions; ++i)
+      PAssert(domain[i].first() == 0);
+
+    typename CreateLeaf<LHS>::Return_t lhsExpr = CreateLeaf<LHS>::make(lhs);
+    typename CreateLeaf<RHS>::Return_t rhsExpr = CreateLeaf<RHS>::make(rhs);
+
+    if (!forEach(lhsExpr, SimdContiguous(), AndCombine()) ||
+	!forEach(rhsExpr, SimdContiguous(), AndCombine()))
+      {
+	KernelEvaluator<InlineKernelTag>::evaluate(lhs,op,rhs,domain);
+	return;
+      }
+
+    bool simd = !forEach(rhsExpr,
+      SimdReadsBlock(lhs.engine().dataBlock().beginPointer()), OrCombine());
+
+    evaluate(lhs,op,rhsExpr,domain,simd,
+	     WrappedInt<Domain::dimensions>());
+
+    POOMA_INCREMENT_STATISTIC(NumSimdEvaluations)
+  }
+
+  /// Input an expression and cause it to be evaluated.
+  /// All this template function does is extract the domain
+  /// from the expression and call evaluate on that.
+
+  template<class LHS,class Op,class RHS>
+  inline static void evaluate(const LHS& lhs,const Op& op,const RHS& rhs)
+  {
+    evaluate(lhs,op,rhs,lhs.domain());
+  }
+
+  /// Return whether the loops over domain are worth running with OpenMP,
+  /// as for the inline evaluator.
+
+  template<class LHS,class Expr,class Domain>
+  inline static bool parallel(const LHS& lhs,const Expr& expr,
+			      const Domain& domain)
+  {
+    return KernelEvaluator<InlineKernelTag>::parallel(lhs,expr,domain);
+  }
+
+  /// Evaluate the elements [f0,l0) of the row starting at loc.  The
+  /// expression is rebuilt with SimdRow leaves and evaluated with
+  /// EvalLeaf<1>.
+
+  template<class LHS,class Op,class Expr,int Dim>
+  inline static void evaluateRow(const LHS& lhs,const Op& op,
+				 const Expr& expr,const Loc<Dim>& loc,
+				 int f0,int l0,bool simd)
+  {
+    typedef typename LHS::Element_t T_t;
+    typedef typename ForEach<Expr,SimdRowTag<Dim>,TreeCombine>::Type_t Row_t;
+    typedef typename ForEach<Expr,SimdRowTag<Dim,true>,TreeCombine>::Type_t
+      RestrictRow_t;
+
+    T_t *lp = &lhs.engine()(loc);
+
+    if (simd)
+      {
+	T_t *POOMA_SIMD_RESTRICT rp = lp;
+	RestrictRow_t row =
+	  forEach(expr,SimdRowTag<Dim,true>(loc),TreeCombine());
+#pragma omp simd
+	for (int i0=f0; i0<l0; ++i0)
+	  op(rp[i0],forEach(row,EvalLeaf<1>(i0),OpCombine()));
+      }
+    else
+      {
+	Row_t row = forEach(expr,SimdRowTag<Dim>(loc),TreeCombine());
+	for (int i0=f0; i0<l0; ++i0)
+	  op(lp[i0],forEach(row,EvalLeaf<1>(i0),OpCombine()));
+      }
+  }
+
+  ///@name evaluate(expression,domain,simd,domain_dimension)
+  //@{
+  /// The loop nests over the rows of the domain, enumerated for
+  /// dimension 1 through 7 like KernelEvaluator<InlineKernelTag>.
+  /// In one dimension there is only one row, so the OpenMP work sharing
+  /// is over its elements.
+
+  template<class LHS,class Op,class Expr,class Domain>
+  inline static void evaluate(const LHS& lhs,const Op& op,const Expr& expr,
+			      const Domain& domain,bool simd,WrappedInt<1>)
+  {
+    typedef typename LHS::Element_t T_t;
+    typedef typename ForEach<Expr,SimdRowTag<1>,TreeCombine>::Type_t Row_t;
+    typedef typename ForEach<Expr,SimdRowTag<1,true>,TreeCombine>::Type_t
+      RestrictRow_t;
+
+    int e0 = domain[0].length();
+    T_t *lp = &lhs.engine()(Loc<1>(0));
+
+    if (simd)
+      {
+	T_t *POOMA_SIMD_RESTRICT rp = lp;
+	RestrictRow_t row =
+	  forEach(expr,SimdRowTag<1,true>(Loc<1>(0)),TreeCombine());
+#pragma omp parallel for simd if (parallel(lhs,expr,domain))
+	for (int i0=0; i0<e0; ++i0)
+	  op(rp[i0],forEach(row,EvalLeaf<1>(i0),OpCombine()));
+      }
+    else
+      {
+	Row_t row = forEach(expr,SimdRowTag<1>(Loc<1>(0)),TreeCombine());
+#pragma omp parallel for if (parallel(lhs,expr,domain))
+	for (int i0=0; i0<e0; ++i0)
+	  op(lp[i0],forEach(row,EvalLeaf<1>(i0),OpCombine()));
+      }
+  }
+
+  template<class LHS,class Op,class Expr,class Domain>
+  inline static void evaluate(const LHS& lhs,const Op& op,const Expr& expr,
+			      const Domain& domain,bool simd,WrappedInt<2>)
+  {
+    int e0 = domain[0].length();
+    int e1 = domain[1].length();
+#pragma omp parallel for if (parallel(lhs,expr,domain))
+    for (int i1=0; i1<e1; ++i1)
+      evaluateRow(lhs,op,expr,Loc<2>(0,i1),0,e0,simd);
+  }
+
+  template<class LHS,class Op,class Expr,class Domain>
+  inline static void evaluate(const LHS& lhs,const Op& op,const Expr& expr,
+			      const Domain& domain,bool simd,WrappedInt<3>)
+  {
+    if (Pooma::tiledEvaluation())
+      {
+	evaluateTiled(lhs,op,expr,domain,simd,WrappedInt<3>());
+	return;
+      }
+
+    int e0 = domain[0].length();
+    int e1 = domain[1].length();
+    int e2 = domain[2].length();
+#pragma omp parallel for if (parallel(lhs,expr,domain))
+    for (int i2=0; i2<e2; ++i2)
+      for (int i1=0; i1<e1; ++i1)
+	evaluateRow(lhs,op,expr,Loc<3>(0,i1,i2),0,e0,simd);
+  }
+
+  template<class LHS,class Op,class Expr,class Domain>
+  inline static void evaluate(const LHS& lhs,const Op& op,const Expr& expr,
+			      const Domain& domain,bool simd,WrappedInt<4>)
+  {
+    if (Pooma::tiledEvaluation())
+      {
+	evaluateTiled(lhs,op,expr,domain,simd,WrappedInt<4>());
+	return;
+      }
+
+    int e0 = domain[0].length();
+    int e1 = domain[1].length();
+    int e2 = domain[2].length();
+    int e3 = domain[3].length();
+#pragma omp parallel for if (parallel(lhs,expr,domain))
+    for (int i3=0; i3<e3; ++i3)
+      for (int i2=0; i2<e2; ++i2)
+	for (int i1=0; i1<e1; ++i1)
+	  evaluateRow(lhs,op,expr,Loc<4>(0,i1,i2,i3),0,e0,simd);
+  }
+
+  template<class LHS,class Op,class Expr,class Domain>
+  inline static void evaluate(const LHS& lhs,const Op& op,const Expr& expr,
+			      const Domain& domain,bool simd,WrappedInt<5>)
+  {
+    if (Pooma::tiledEvaluation())
+      {
+	evaluateTiled(lhs,op,expr,domain,simd,WrappedInt<5>());
+	return;
+      }
+
+    int e0 = domain[0].length();
+    int e1 = domain[1].length();
+    int e2 = domain[2].length();
+    int e3 = domain[3].length();
+    int e4 = domain[4].length();
+#pragma omp parallel for if (parallel(lhs,expr,domain))
+    for (int i4=0; i4<e4; ++i4)
+      for (int i3=0; i3<e3; ++i3)
+	for (int i2=0; i2<e2; ++i2)
+	  for (int i1=0; i1<e1; ++i1)
+	    evaluateRow(lhs,op,expr,Loc<5>(0,i1,i2,i3,i4),0,e0,simd);
+  }
+
+  template<class LHS,class Op,class Expr,class Domain>
+  inline static void evaluate(const LHS& lhs,const Op& op,const Expr& expr,
+			      const Domain& domain,bool simd,WrappedInt<6>)
+  {
+    if (Pooma::tiledEvaluation())
+      {
+	evaluateTiled(lhs,op,expr,domain,simd,WrappedInt<6>());
+	return;
+      }
+
+    int e0 = domain[0].length();
+    int e1 = domain[1].length();
+    int e2 = domain[2].length();
+    int e3 = domain[3].length();
+    int e4 = domain[4].length();
+    int e5 = domain[5].length();
+#pragma omp parallel for if (parallel(lhs,expr,domain))
+    for (int i5=0; i5<e5; ++i5)
+      for (int i4=0; i4<e4; ++i4)
+	for (int i3=0; i3<e3; ++i3)
+	  for (int i2=0; i2<e2; ++i2)
+	    for (int i1=0; i1<e1; ++i1)
+	      evaluateRow(lhs,op,expr,Loc<6>(0,i1,i2,i3,i4,i5),0,e0,simd);
+  }
+
+  template<class LHS,class Op,class Expr,class Domain>
+  inline static void evaluate(const LHS& lhs,const Op& op,const Expr& expr,
+			      const Domain& domain,bool simd,WrappedInt<7>)
+  {
+    if (Pooma::tiledEvaluation())
+      {
+	evaluateTiled(lhs,op,expr,domain,simd,WrappedInt<7>());
+	return;
+      }
+
+    int e0 = domain[0].length();
+    int e1 = domain[1].length();
+    int e2 = domain[2].length();
+    int e3 = domain[3].length();
+    int e4 = domain[4].length();
+    int e5 = domain[5].length();
+    int e6 = domain[6].length();
+#pragma omp parallel for if (parallel(lhs,expr,domain))
+    for (int i6=0; i6<e6; ++i6)
+      for (int i5=0; i5<e5; ++i5)
+	for (int i4=0; i4<e4; ++i4)
+	  for (int i3=0; i3<e3; ++i3)
+	    for (int i2=0; i2<e2; ++i2)
+	      for (int i1=0; i1<e1; ++i1)
+		evaluateRow(lhs,op,expr,Loc<7>(0,i1,i2,i3,i4,i5,i6),0,e0,simd);
+  }
+
+  //@}
+
+  ///@name evaluateTiled(expression,domain,simd,domain_dimension)
+  //@{
+  /// Cache-blocked versions of the loops above for dimensions 3 through 7,
+  /// with the same tiles as KernelEvaluator<InlineKernelTag>::evaluateTiled().
+  /// The rows are cut at the tile boundaries of dimension 0.
+
+  template<class LHS,class Op,class Expr,class Domain>
+  inline static void evaluateTiled(const LHS& lhs,const Op& op,
+				   const Expr& expr,const Domain& domain,bool simd,
+				   WrappedInt<3>)
+  {
+    int e0 = domain[0].length();
+    int e1 = domain[1].length();
+    int e2 = domain[2].length();
+    int t0 = Pooma::tileExtent(0);
+    int t1 = Pooma::tileExtent(1);
+    int n0 = (e0 + t0 - 1) / t0;
+    int nt = n0 * ((e1 + t1 - 1) / t1);
+#pragma omp parallel for if (parallel(lhs,expr,domain))
+    for (int it=0; it<nt; ++it)
+      {
+	int f0 = (it % n0) * t0, l0 = std::min(f0 + t0, e0);
+	int f1 = (it / n0) * t1, l1 = std::min(f1 + t1, e1);
+	for (int i2=0; i2<e2; ++i2)
+	  for (int i1=f1; i1<l1; ++i1)
+	    evaluateRow(lhs,op,expr,Loc<3>(0,i1,i2),f0,l0,simd);
+      }
+  }
+
+  template<class LHS,class Op,class Expr,class Domain>
+  inline static void evaluateTiled(const LHS& lhs,const Op& op,
+				   const Expr& expr,const Domain& domain,bool simd,
+				   WrappedInt<4>)
+  {
+    int e0 = domain[0].length();
+    int e1 = domain[1].length();
+    int e2 = domain[2].length();
+    int e3 = domain[3].length();
+    int t0 = Pooma::tileExtent(0);
+    int t1 = Pooma::tileExtent(1);
+    int n0 = (e0 + t0 - 1) / t0;
+    int nt = n0 * ((e1 + t1 - 1) / t1);
+#pragma omp parallel for if (parallel(lhs,expr,domain))
+    for (int i3=0; i3<e3; ++i3)
+      for (int it=0; it<nt; ++it)
+	{
+	  int f0 = (it % n0) * t0, l0 = std::min(f0 + t0, e0);
+	  int f1 = (it / n0) * t1, l1 = std::min(f1 + t1, e1);
+	  for (int i2=0; i2<e2; ++i2)
+	    for (int i1=f1; i1<l1; ++i1)
+	      evaluateRow(lhs,op,expr,Loc<4>(0,i1,i2,i3),f0,l0,simd);
+	}
+  }
+
+  template<class LHS,class Op,class Expr,class Domain>
+  inline static void evaluateTiled(const LHS& lhs,const Op& op,
+				   const Expr& expr,const Domain& domain,bool simd,
+				   WrappedInt<5>)
+  {
+    int e0 = domain[0].length();
+    int e1 = domain[1].length();
+    int e2 = domain[2].length();
+    int e3 = domain[3].length();
+    int e4 = domain[4].length();
+    int t0 = Pooma::tileExtent(0);
+    int t1 = Pooma::tileExtent(1);
+    int n0 = (e0 + t0 - 1) / t0;
+    int nt = n0 * ((e1 + t1 - 1) / t1);
+#pragma omp parallel for if (parallel(lhs,expr,domain))
+    for (int i4=0; i4<e4; ++i4)
+      for (int i3=0; i3<e3; ++i3)
+	for (int it=0; it<nt; ++it)
+	  {
+	    int f0 = (it % n0) * t0, l0 = std::min(f0 + t0, e0);
+	    int f1 = (it / n0) * t1, l1 = std::min(f1 + t1, e1);
+	    for (int i2=0; i2<e2; ++i2)
+	      for (int i1=f1; i1<l1; ++i1)
+		evaluateRow(lhs,op,expr,Loc<5>(0,i1,i2,i3,i4),f0,l0,simd);
+	  }
+  }
+
+  template<class LHS,class Op,class Expr,class Domain>
+  inline static void evaluateTiled(const LHS& lhs,const Op& op,
+				   const Expr& expr,const Domain& domain,bool simd,
+				   WrappedInt<6>)
+  {
+    int e0 = domain[0].length();
+    int e1 = domain[1].length();
+    int e2 = domain[2].length();
+    int e3 = domain[3].length();
+    int e4 = domain[4].length();
+    int e5 = domain[5].length();
+    int t0 = Pooma::tileExtent(0);
+    int t1 = Pooma::tileExtent(1);
+    int n0 = (e0 + t0 - 1) / t0;
+    int nt = n0 * ((e1 + t1 - 1) / t1);
+#pragma omp parallel for if (parallel(lhs,expr,domain))
+    for (int i5=0; i5<e5; ++i5)
+      for (int i4=0; i4<e4; ++i4)
+	for (int i3=0; i3<e3; ++i3)
+	  for (int it=0; it<nt; ++it)
+	    {
+	      int f0 = (it % n0) * t0, l0 = std::min(f0 + t0, e0);
+	      int f1 = (it / n0) * t1, l1 = std::min(f1 + t1, e1);
+	      for (int i2=0; i2<e2; ++i2)
+		for (int i1=f1; i1<l1; ++i1)
+		  evaluateRow(lhs,op,expr,Loc<6>(0,i1,i2,i3,i4,i5),f0,l0,simd);
+	    }
+  }
+
+  template<class LHS,class Op,class Expr,class Domain>
+  inline static void evaluateTiled(const LHS& lhs,const Op& op,
+				   const Expr& expr,const Domain& domain,bool simd,
+				   WrappedInt<7>)
+  {
+    int e0 = domain[0].length();
+    int e1 = domain[1].length();
+    int e2 = domain[2].length();
+    int e3 = domain[3].length();
+    int e4 = domain[4].length();
+    int e5 = domain[5].length();
+    int e6 = domain[6].length();
+    int t0 = Pooma::tileExtent(0);
+    int t1 = Pooma::tileExtent(1);
+    int n0 = (e0 + t0 - 1) / t0;
+    int nt = n0 * ((e1 + t1 - 1) / t1);
+#pragma omp parallel for if (parallel(lhs,expr,domain))
+    for (int i6=0; i6<e6; ++i6)
+      for (int i5=0; i5<e5; ++i5)
+	for (int i4=0; i4<e4; ++i4)
+	  for (int i3=0; i3<e3; ++i3)
+	    for (int it=0; it<nt; ++it)
+	      {
+		int f0 = (it % n0) * t0, l0 = std::min(f0 + t0, e0);
+		int f1 = (it / n0) * t1, l1 = std::min(f1 + t1, e1);
+		for (int i2=0; i2<e2; ++i2)
+		  for (int i1=f1; i1<l1; ++i1)
+		    evaluateRow(lhs,op,expr,Loc<7>(0,i1,i2,i3,i4,i5,i6),f0,l0,simd);
+	      }
+  }
+
+  //@}
+};
+
+#endif // POOMA_EVALUATOR_SIMDEVALUATOR_H
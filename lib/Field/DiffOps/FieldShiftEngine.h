@@ -546,8 +546,8 @@ public:
 
   // STL iterator support.
   
-  inline const_iterator begin() const { return data()->inodes_m.begin(); }
-  inline const_iterator end() const { return data()->inodes_m.end(); }
+  inline const_iterator begin() const { return data()->begin(); }
+  inline const_iterator end() const { return data()->end(); }
 
   //---------------------------------------------------------------------------
   // Intersect routines
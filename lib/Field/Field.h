@@ -1005,6 +1005,14 @@ public:
   : fieldEngine_m(model.fieldEngine())
   { }
 
+  /// Move constructor.  There is no move assignment, as assignment
+  /// copies the values of the elements.
+  
+  Field(This_t &&model)
+    noexcept(std::is_nothrow_move_constructible<FieldEngine_t>::value)
+  : fieldEngine_m(std::move(model.fieldEngine_m))
+  { }
+
   /// Copy initializer.
   
   void initialize(const This_t &model)
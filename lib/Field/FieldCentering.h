@@ -252,10 +252,16 @@ public:
 
 
   //---------------------------------------------------------------------------
-  /// Empty destructor is fine for us.
+  /// Empty destructor is fine for us.  As it is declared, the copy and
+  /// move operations have to be asked for explicitly.
   
   ~Centering() { }
 
+  Centering(const Centering<Dim> &) = default;
+  Centering(Centering<Dim> &&) = default;
+  Centering<Dim> &operator=(const Centering<Dim> &) = default;
+  Centering<Dim> &operator=(Centering<Dim> &&) = default;
+
   //---------------------------------------------------------------------------
   //@name Accessors.
   //@{
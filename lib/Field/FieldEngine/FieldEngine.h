@@ -53,6 +53,9 @@
 #include "Field/FieldCentering.h"
 #include "Field/FieldEngine/FieldEnginePatch.h"
 
+#include <type_traits>
+#include <utility>
+
 //-----------------------------------------------------------------------------
 // Forward declarations:
 //-----------------------------------------------------------------------------
@@ -193,6 +196,44 @@ public:
   {
   }
 
+  /// Move constructor takes the data, centering and mesh over without
+  /// touching reference counts.
+  
+  FieldEngine(This_t &&model)
+    noexcept(std::is_nothrow_move_constructible<Mesh>::value)
+    : num_materials_m(model.num_materials_m),
+      centering_m(std::move(model.centering_m)),
+      stride_m(model.stride_m),
+      data_m(std::move(model.data_m)),
+      physicalCellDomain_m(model.physicalCellDomain_m),
+      guards_m(model.guards_m),
+      mesh_m(std::move(model.mesh_m))
+  {
+  }
+
+  /// Copy and move assignment are shallow, like the constructors.
+
+  This_t &operator=(const This_t &model)
+  {
+    initialize(model);
+    return *this;
+  }
+
+  This_t &operator=(This_t &&model)
+  {
+    if (this != &model)
+      {
+	num_materials_m = model.num_materials_m;
+	stride_m = model.stride_m;
+	centering_m = std::move(model.centering_m);
+	data_m = std::move(model.data_m);
+	physicalCellDomain_m = model.physicalCellDomain_m;
+	guards_m = model.guards_m;
+	mesh_m = std::move(model.mesh_m);
+      }
+    return *this;
+  }
+
   ///@name Sub-field view constructors
   //@{
 
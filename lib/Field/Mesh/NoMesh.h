@@ -226,6 +226,13 @@ public:
   : data_m(model.data_m)
     {
     }
+
+  /// Move constructor.
+
+  inline NoMesh(NoMesh<Dim> &&model) noexcept
+  : data_m(std::move(model.data_m))
+    {
+    }
     
   /** @name View constructors.
    */
@@ -293,6 +300,16 @@ public:
       
       return *this;
     }
+
+  //---------------------------------------------------------------------------
+  /// Move assignment operator.
+  
+  NoMesh<Dim> &
+  operator=(NoMesh<Dim> &&rhs)
+    {
+      data_m = std::move(rhs.data_m);
+      return *this;
+    }
   
   //---------------------------------------------------------------------------
   /// @name Domain functions.
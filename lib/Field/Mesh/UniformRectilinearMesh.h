@@ -246,6 +246,13 @@ public:
   : data_m(model.data_m)
     {
     }
+
+  /// Move constructor.
+
+  inline UniformRectilinearMesh(UniformRectilinearMesh<Dim, T> &&model) noexcept
+  : data_m(std::move(model.data_m))
+    {
+    }
     
   /// @name View constructors
   /// These are the only possible views of this
@@ -298,6 +305,16 @@ public:
       return *this;
     }
 
+  //---------------------------------------------------------------------------
+  /// Move assignment operator.
+  
+  inline UniformRectilinearMesh<Dim, T> &
+  operator=(UniformRectilinearMesh<Dim, T> &&rhs)
+    {
+      data_m = std::move(rhs.data_m);
+      return *this;
+    }
+
   //---------------------------------------------------------------------------
   /// Empty destructor is fine. The pointer to the data is ref-counted so its
   /// lifetime is correctly managed.
@@ -71,6 +71,7 @@
 
 #include <vector>
 #include <iosfwd>
+#include <utility>
 
 ///////////////////////////////////////////////////////////////////////////////
 // namespace Pooma {
@@ -824,6 +825,15 @@ public:
   DynamicLayout(const This_t &);
 
   This_t &operator=(const This_t &);
+
+  // Move constructor & assignment operator
+  // Take the data over without touching its reference count.  The
+  // moved-from layout is left without data and may only be destroyed
+  // or assigned to; its Observers are not carried over.
+
+  DynamicLayout(This_t &&) noexcept;
+
+  This_t &operator=(This_t &&);
   
 
   //============================================================
@@ -835,7 +845,11 @@ public:
   // If any Observers remain, they will be notified by the Observable 
   // destructor. 
   
-  inline ~DynamicLayout() { pdata_m->detach(*this); }
+  inline ~DynamicLayout()
+  {
+    if (pdata_m.isValid())
+      pdata_m->detach(*this);
+  }
 
   //============================================================
   // Initialize methods
@@ -905,11 +919,19 @@ public:
     return pdata_m->ID();
   }
 
+  // The shared layout data, which notifies its observers when it changes
+  // and when the last layout using it goes away.
+
+  inline LayoutData_t &layoutData() const
+  {
+    return *pdata_m;
+  }
+
   // Return whether or not this layout has been initialized.
   
   inline bool initialized() const
   {
-    return (sizeGlobal() > 0);
+    return (pdata_m.isValid() && sizeGlobal() > 0);
   }
 
   // Return starting point of domain along given dimension.
@@ -80,6 +80,10 @@
  * gidStore.shared(layoutID1,layoutID2);
  *  - tells the database that we didn't intersect layout layoutID1 because it
  *    is the same as layoutID2 (they're identical views).
+ *
+ * gidStore.copyNodes(model,oldIDs,newIDs);
+ *  - replaces the nodes with those of model, changing the layout ID
+ *    oldIDs[i] to newIDs[i].
  */
 
 class GlobalIDDataBase
@@ -131,6 +135,15 @@ public:
 
   void shared(LayoutID_t idNew, LayoutID_t idOld);
 
+  //----------------------------------------------------------------------
+  // Replace our nodes with the nodes of another database, which were
+  // pushed for layouts with IDs oldIDs.  The same keys then refer to
+  // nodes of the layouts with IDs newIDs.
+
+  void copyNodes(const GlobalIDDataBase &model,
+		 const std::vector<LayoutID_t> &oldIDs,
+		 const std::vector<LayoutID_t> &newIDs);
+
   //----------------------------------------------------------------------
   // Access the globalID for a given layoutID and nodeKey.  We search
   // through a node and all its parents for the right layout id.
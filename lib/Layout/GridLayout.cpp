@@ -597,6 +597,8 @@ void GridLayoutData<Dim>::calcMaps() const
 				      this->domain_m[i].last() +
 				      this->externalGuards_m.upper(i)));
 
+      std::vector<DomainMap<Interval<1>,int>::Value_t> vals;
+
       int b = this->blocks_m[i].first();
       for (j=0; j < b; ++j)
 	{
@@ -620,13 +622,13 @@ void GridLayoutData<Dim>::calcMaps() const
 	      Interval<1> mval(blockDom.first() - lo, blockDom.last() + hi);
 	      typename DomainMap<Interval<1>,int>::Value_t val(mval, j);
 
-	      map_m[i].insert(val);
+	      vals.push_back(val);
 	    }
 	}
 
-      // update the DomainMap's
+      // Bulk-load the DomainMap's, which also updates them.
 
-      map_m[i].update();
+      map_m[i].insert(vals.begin(), vals.end());
     }
 }
 
@@ -677,6 +679,8 @@ void GridLayoutData<Dim>::calcAllocMaps() const
 					  this->domain_m[i].last() +
 					  this->externalGuards_m.upper(i)));
 
+      std::vector<DomainMap<Interval<1>,int>::Value_t> vals;
+
       int b = this->blocks_m[i].first();
       for (j=0; j < b; ++j)
 	{
@@ -703,13 +707,13 @@ void GridLayoutData<Dim>::calcAllocMaps() const
 	      Interval<1> ival(blockDom.first() - lo, blockDom.last() + hi);
 	      typename DomainMap<Interval<1>,int>::Value_t valAl(ival, j);
 
-	      mapAloc_m[i].insert(valAl);
+	      vals.push_back(valAl);
 	    }
 	}
 
-      // update the DomainMap's
+      // Bulk-load the DomainMap's, which also updates them.
 
-      mapAloc_m[i].update();
+      mapAloc_m[i].insert(vals.begin(), vals.end());
     }
 }
 
@@ -1472,6 +1476,15 @@ GridLayout<Dim>::GridLayout(const This_t &model)
 { 
    this->pdata_m->attach(*this);
 }
+
+template <int Dim>
+GridLayout<Dim>::GridLayout(This_t &&model) noexcept
+  : LayoutBase<Dim,GridLayoutData<Dim> >(std::move(model.pdata_m)),
+    Observable<This_t>(*this)
+{ 
+  if (this->pdata_m.isValid())
+    this->pdata_m->replace(&model, this);
+}
   
 
 //-----------------------------------------------------------------------------
@@ -1485,7 +1498,8 @@ GridLayout<Dim> &GridLayout<Dim>::operator=(const This_t &model)
 {
   if (this != &model)
     {
-      this->pdata_m->detach(*this);
+      if (this->pdata_m.isValid())
+	this->pdata_m->detach(*this);
       this->pdata_m = model.pdata_m;
       this->pdata_m->attach(*this);
     }
@@ -1493,6 +1507,21 @@ GridLayout<Dim> &GridLayout<Dim>::operator=(const This_t &model)
   return *this;
 }
 
+template <int Dim>
+GridLayout<Dim> &GridLayout<Dim>::operator=(This_t &&model)
+{
+  if (this != &model)
+    {
+      if (this->pdata_m.isValid())
+	this->pdata_m->detach(*this);
+      this->pdata_m = std::move(model.pdata_m);
+      if (this->pdata_m.isValid())
+	this->pdata_m->replace(&model, this);
+    }
+
+  return *this;
+}
+
 
 //-----------------------------------------------------------------------------
 //
@@ -554,6 +554,15 @@ public:
   GridLayout(const This_t &);
 
   This_t &operator=(const This_t &);
+
+  /// Move constructor & assignment operator
+  /// Take the data over without touching its reference count.  The
+  /// moved-from layout is left without data and may only be destroyed
+  /// or assigned to; its Observers are not carried over.
+
+  GridLayout(This_t &&) noexcept;
+
+  This_t &operator=(This_t &&);
   
 
   //============================================================
@@ -567,7 +576,8 @@ public:
   
   inline ~GridLayout() 
     { 
-      this->pdata_m->detach(*this);
+      if (this->pdata_m.isValid())
+	this->pdata_m->detach(*this);
     }
 
 
@@ -132,6 +132,15 @@ public:
       key_m(model.key())
   { }
   
+  // This version copies an INode into another global id database
+  // holding the same keys.
+
+  inline INode(const INode<Dim> &model, GlobalIDDataBase *globalIDDataBase)
+    : domain_m(model.domain_m),
+      globalIDDataBase_m(globalIDDataBase),
+      key_m(model.key_m)
+  { }
+  
   // Constructors that take a domain, layout id, global id,
   // global id database, and optionally a parent key.
   // These versions store the global id information in the
@@ -66,6 +66,7 @@
 
 #include <vector>
 #include <iosfwd>
+#include <utility>
 
 
 /**
@@ -364,7 +365,7 @@ public:
   }
 
    LayoutBase(RefCountedPtr<LBD> pdata)
-    : pdata_m(pdata)
+    : pdata_m(std::move(pdata))
   {
   }
 
@@ -391,11 +392,20 @@ public:
     return pdata_m->ID_m;
   }
 
+  /// The shared layout data.  Unlike the layout objects, which are
+  /// copied freely, it notifies its observers when it is repartitioned
+  /// and when the last layout using it goes away.
+
+  inline LBD &layoutData() const
+  {
+    return *pdata_m;
+  }
+
   /// Return whether or not this layout has been initialized.
   
   inline bool initialized() const
   {
-    return (sizeGlobal() > 0);
+    return (pdata_m.isValid() && sizeGlobal() > 0);
   }
  
   /// Domain translation utility. 
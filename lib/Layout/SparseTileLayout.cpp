@@ -193,6 +193,11 @@ void SparseTileLayoutData<Dim>::calcMaps()
 
   map_m.initialize(this->domain_m);
 
+  // Bulk-load the map, which balances the tree.
+
+  std::vector<typename DomainMap<Domain_t,pidx_t>::Value_t> vals;
+  vals.reserve(this->all_m.size());
+
   typename List_t::const_iterator start = this->all_m.begin();
   typename List_t::const_iterator end   = this->all_m.end();
   int i=0;
@@ -203,9 +208,9 @@ void SparseTileLayoutData<Dim>::calcMaps()
       // for Node, domain() returns the owned domain.
       typename DomainMap<Domain_t,pidx_t>::Value_t val((*start)->domain(),tmp);
       
-      map_m.insert(val);
+      vals.push_back(val);
     }
-  map_m.update();
+  map_m.insert(vals.begin(), vals.end());
 }
 
 template<int Dim>
@@ -219,6 +224,9 @@ void SparseTileLayoutData<Dim>::calcAllocMaps()
   mapAloc_m.zap();
 
   mapAloc_m.initialize(this->domain_m);
+
+  std::vector<typename DomainMap<Domain_t,pidx_t>::Value_t> vals;
+  vals.reserve(this->all_m.size());
  
   typename List_t::const_iterator start = this->all_m.begin();
   typename List_t::const_iterator end   = this->all_m.end();
@@ -230,9 +238,9 @@ void SparseTileLayoutData<Dim>::calcAllocMaps()
       pidx_t tmp((*start)->globalID(),i);
       typename DomainMap<Domain_t,pidx_t>::Value_t val((*start)->allocated(),tmp);
 						   
-      mapAloc_m.insert(val);
+      vals.push_back(val);
     }
-  mapAloc_m.update();
+  mapAloc_m.insert(vals.begin(), vals.end());
 
 }
 
@@ -407,44 +415,42 @@ void SparseTileLayoutData<Dim>::calcGCFillList()
   this->gcFillList_m.clear();
   gcBorderFillList_m.clear();
 
-  typedef Node<Domain_t,AllocatedDomain_t> NNode_t;
-  typedef std::vector<NNode_t>             TouchList_t;
-  TouchList_t tlist;
+  typedef typename DomainMap<Domain_t,pidx_t>::BatchValue_t Batch_t;
 
-  // first we do the internal overlap regions
+  // first we do the internal overlap regions.  The patches touching the
+  // allocated domains of all the patches are found in one pass over the
+  // map, then sorted by patch.
   typename List_t::iterator start = this->all_m.begin();
   typename List_t::iterator end = this->all_m.end();
 
+  std::vector<Domain_t> alloc;
   for ( ; start!=end; ++start)
+    alloc.push_back(intersect(this->domain_m, (*start)->allocated()));
+
+  std::vector<Batch_t> found;
+  map_m.touch(alloc, std::back_inserter(found));
+
+  int nalloc = alloc.size(), nfound = found.size();
+  std::vector<std::vector<int> > touching(nalloc);
+  for (int k = 0; k < nfound; ++k)
+    touching[found[k].first].push_back(k);
+
+  for (int j = 0; j < nalloc; ++j)
     {
-      touches((*start)->allocated(),
-	      std::back_inserter(tlist),
-	      TouchesConstructNodeObj());
-
-      // now pack the tlist into the GCFillInfo object
-      // The if test is to remove the self-touch entry
-      typename TouchList_t::iterator GCLstart = tlist.begin();
-      typename TouchList_t::iterator GCLend = tlist.end();
-      
-      for( ; GCLstart != GCLend ;++GCLstart)
+      int guardID = this->all_m[j]->globalID();
+      int ntouching = touching[j].size();
+      for (int k = 0; k < ntouching; ++k)
 	{
-	  if(GCLstart->globalID() == (*start)->globalID()) 
-	    {
-	      tlist.erase(GCLstart);
-	      break;
-	    }
-	}
+	  // The if test is to remove the self-touch entry
+	  const Batch_t &b = found[touching[j][k]];
+	  if (b.second.second.first == guardID)
+	    continue;
 
-      GCLstart = tlist.begin();
-      GCLend = tlist.end();
-      for ( ; GCLstart!=GCLend ; ++GCLstart )
-	{
 	  //  removed the external guard layer area. 
-	  this->gcFillList_m.push_back(GCFillInfo_t((*GCLstart).domain(),
-						    (*GCLstart).globalID(),
-						    (*start)->globalID()));
+	  this->gcFillList_m.push_back(
+	    GCFillInfo_t(intersect(b.second.first, alloc[j]),
+			 b.second.second.first, guardID));
 	}
-      tlist.clear();
     }
 
   // Next, generate the list of all the internalGuardLayer
@@ -994,3 +1000,12 @@ SparseTileLayout<Dim>::SparseTileLayout(const This_t &model)
 { 
    this->pdata_m->attach(*this);
 }
+
+template<int Dim>
+SparseTileLayout<Dim>::SparseTileLayout(This_t &&model) noexcept
+  : LayoutBase<Dim,SparseTileLayoutData<Dim> >(std::move(model.pdata_m)),
+  Observable<This_t>(*this)
+{ 
+  if (this->pdata_m.isValid())
+    this->pdata_m->replace(&model, this);
+}
@@ -515,13 +515,36 @@ public:
   {
     if (this != &model)
       {
-	this->pdata_m->detach(*this);
+	if (this->pdata_m.isValid())
+	  this->pdata_m->detach(*this);
 	this->pdata_m = model.pdata_m;
 	this->pdata_m->attach(*this);
       }
     
     return *this;
   }
+
+  // Move constructor & assignment operator
+  // Take the data over without touching its reference count.  The
+  // moved-from layout is left without data and may only be destroyed
+  // or assigned to; its Observers are not carried over.
+
+  SparseTileLayout(This_t &&) noexcept;
+
+  This_t & 
+  operator=(This_t &&model)
+  {
+    if (this != &model)
+      {
+	if (this->pdata_m.isValid())
+	  this->pdata_m->detach(*this);
+	this->pdata_m = std::move(model.pdata_m);
+	if (this->pdata_m.isValid())
+	  this->pdata_m->replace(&model, this);
+      }
+    
+    return *this;
+  }
   
 
   //============================================================
@@ -534,7 +557,8 @@ public:
 
   ~SparseTileLayout()
   {
-    this->pdata_m->detach(*this);
+    if (this->pdata_m.isValid())
+      this->pdata_m->detach(*this);
   }
   
 
@@ -451,6 +451,16 @@ public:
   
   This_t &operator=(const This_t &);
 
+  // Move constructor & assignment operator
+  // Take the data over without touching its reference count.  The new
+  // layout observes the data in place of the old one, which is left
+  // with no data and may only be destroyed or assigned to.  Observers
+  // of the old layout are not carried over.
+
+  UniformGridLayout(This_t &&) noexcept;
+
+  This_t &operator=(This_t &&);
+
   // I think we need a version of this here ... just forward to
   // the RefCountedPtr.
   
@@ -467,7 +477,8 @@ public:
   
   inline ~UniformGridLayout() 
   { 
-    this->pdata_m->detach(*this);
+    if (this->pdata_m.isValid())
+      this->pdata_m->detach(*this);
   }
 
 
@@ -1138,13 +1149,39 @@ operator=(const This_t &model)
 {
   if (this != &model)
     {
-      this->pdata_m->detach(*this);
+      if (this->pdata_m.isValid())
+	this->pdata_m->detach(*this);
       this->pdata_m = model.pdata_m;
       this->pdata_m->attach(*this);
     }
   return *this;
 }
 
+template <int Dim>
+inline UniformGridLayout<Dim>::
+UniformGridLayout(This_t &&model) noexcept
+: LayoutBase<Dim,UniformGridLayoutData<Dim> >(std::move(model.pdata_m)),
+  Observable<This_t>(*this)
+{ 
+  if (this->pdata_m.isValid())
+    this->pdata_m->replace(&model, this);
+}
+  
+template <int Dim>
+inline UniformGridLayout<Dim> & UniformGridLayout<Dim>::
+operator=(This_t &&model) 
+{
+  if (this != &model)
+    {
+      if (this->pdata_m.isValid())
+	this->pdata_m->detach(*this);
+      this->pdata_m = std::move(model.pdata_m);
+      if (this->pdata_m.isValid())
+	this->pdata_m->replace(&model, this);
+    }
+  return *this;
+}
+
 // Initialize methods...
 
 template <int Dim>
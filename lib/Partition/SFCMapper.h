@@ -0,0 +1,250 @@
+// -*- C++ -*-
+//
+// Copyright (C) 1998, 1999, 2000, 2002  Los Alamos National Laboratory,
+// Copyright (C) 1998, 1999, 2000, 2002  CodeSourcery, LLC
+//
+// This file is part of FreePOOMA.
+//
+// FreePOOMA is free software; you can redistribute it and/or modify it
+// under the terms of the Expat license.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the Expat
+// license for more details.
+//
+// You should have received a copy of the Expat license along with
+// FreePOOMA; see the file LICENSE.
+//
+
+//-----------------------------------------------------------------------------
+// Class:
+// SFCMapper
+//-----------------------------------------------------------------------------
+
+/** @file
+ * @ingroup Partition
+ * @brief
+ * SFCMapper is a ContextMapper implementation that orders the patches
+ * along a space-filling curve.
+ */
+
+#ifndef POOMA_SFCMAPPER_H
+#define POOMA_SFCMAPPER_H
+
+#include "Partition/ContextMapper.h"
+#include "Utilities/PAssert.h"
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+
+
+/**
+ * SFCMapper is a ContextMapper implementation.
+ *
+ * It orders the blocks of a grid partition along a Hilbert curve (or,
+ * if asked to, a Morton curve) and assigns contiguous runs of the curve
+ * to the contexts, then the local patches of each context, again in
+ * runs along the curve, to the threads.  Blocks that are close on the
+ * curve are close in space, so most of the guard layers are filled from
+ * patches on the same context and thread.  The Hilbert curve steps from
+ * a block to a face neighbor when the number of blocks in every
+ * direction is the same power of two; otherwise the curve of the
+ * enclosing power of two is used and the blocks outside the grid are
+ * skipped.
+ *
+ * The blocks are numbered as the grid partitions number their nodes,
+ * with the first dimension varying fastest.
+ */
+
+template <int Dim>
+class SFCMapper
+  : public ContextMapper<Dim>
+{
+public:
+  //============================================================
+  // Typedefs and enumerations
+  //============================================================
+  typedef Interval<Dim>                       Domain_t;
+  typedef Node<Domain_t>                      Value_t;
+  typedef std::vector<Value_t *>              List_t;
+  typedef unsigned long                       Key_t;
+
+  enum Curve { hilbert, morton };
+
+  template<class Partitioner>
+  SFCMapper(const Partitioner & gp,
+	    const Loc<Dim> &nblocks)
+    : blocks_m(gp.blocks()), curve_m(hilbert)
+  {
+  }
+
+  template<class Partitioner>
+  SFCMapper(const Partitioner & gp, Curve curve = hilbert)
+     : blocks_m(gp.blocks()), curve_m(curve)
+  {
+  }
+
+  SFCMapper(const Loc<Dim>& blocks, Curve curve = hilbert)
+     : blocks_m(blocks), curve_m(curve)
+  {
+  }
+
+  void map(const List_t & templist) const;
+
+  /// Fill order with the block numbers in the order of the curve.
+
+  void order(std::vector<int> &order) const;
+
+  /// Return the position on the curve of the block with the given
+  /// index in each dimension.
+
+  Key_t key(const int *idx) const;
+
+private:
+
+  /// Return the number of bits needed for the block indices.
+
+  int bits() const
+  {
+    int b = 1;
+    for (int i = 0; i < Dim; ++i)
+      while ((1 << b) < blocks_m[i].first())
+	++b;
+    return b;
+  }
+
+  // Member Data
+  Loc<Dim> blocks_m;
+  Curve curve_m;
+};
+
+//-----------------------------------------------------------------------------
+//
+// The Hilbert key is computed with J. Skilling's algorithm ("Programming
+// the Hilbert curve", AIP Conf. Proc. 707, 2004), which turns the
+// coordinates into the "transposed" Hilbert index in place; interleaving
+// the bits of the result gives the key.  The Morton key interleaves the
+// bits of the coordinates themselves.
+//
+//-----------------------------------------------------------------------------
+
+template <int Dim>
+typename SFCMapper<Dim>::Key_t SFCMapper<Dim>::key(const int *idx) const
+{
+  int b = bits();
+  PInsist(Dim * b <= int(8 * sizeof(Key_t)),
+	  "SFCMapper: too many blocks for the curve's key.");
+
+  Key_t x[Dim];
+  for (int i = 0; i < Dim; ++i)
+    x[i] = idx[Dim - 1 - i];
+
+  if (curve_m == hilbert)
+    {
+      Key_t m = Key_t(1) << (b - 1);
+      for (Key_t q = m; q > 1; q >>= 1)
+	{
+	  Key_t p = q - 1;
+	  for (int i = 0; i < Dim; ++i)
+	    {
+	      if (x[i] & q)
+		x[0] ^= p;
+	      else
+		{
+		  Key_t t = (x[0] ^ x[i]) & p;
+		  x[0] ^= t;
+		  x[i] ^= t;
+		}
+	    }
+	}
+      for (int i = 1; i < Dim; ++i)
+	x[i] ^= x[i - 1];
+      Key_t t = 0;
+      for (Key_t q = m; q > 1; q >>= 1)
+	if (x[Dim - 1] & q)
+	  t ^= q - 1;
+      for (int i = 0; i < Dim; ++i)
+	x[i] ^= t;
+    }
+
+  Key_t k = 0;
+  for (int bit = b - 1; bit >= 0; --bit)
+    for (int i = 0; i < Dim; ++i)
+      k = (k << 1) | ((x[i] >> bit) & 1);
+  return k;
+}
+
+template <int Dim>
+void SFCMapper<Dim>::order(std::vector<int> &order) const
+{
+  int npatch = 1;
+  for (int i = 0; i < Dim; ++i)
+    npatch *= blocks_m[i].first();
+
+  std::vector<std::pair<Key_t, int> > keys(npatch);
+  int idx[Dim];
+  for (int i = 0; i < Dim; ++i)
+    idx[i] = 0;
+  for (int n = 0; n < npatch; ++n)
+    {
+      keys[n] = std::make_pair(key(idx), n);
+      for (int i = 0; i < Dim; ++i)
+	{
+	  if (++idx[i] < blocks_m[i].first())
+	    break;
+	  idx[i] = 0;
+	}
+    }
+  std::sort(keys.begin(), keys.end());
+
+  order.resize(npatch);
+  for (int n = 0; n < npatch; ++n)
+    order[n] = keys[n].second;
+}
+
+template <int Dim>
+void SFCMapper<Dim>::map(const List_t & templist) const
+{
+  std::vector<int> curve;
+  order(curve);
+  int npatch = curve.size();
+  PAssert(npatch == int(templist.size()));
+
+  // Cut the curve into one run per context.  The first contexts get
+  // one patch more if the patches do not divide evenly.
+
+  int ncontexts = Pooma::contexts();
+  int npc = npatch / ncontexts;
+  int remainder = npatch - npc * ncontexts;
+  int n = 0;
+  for (int c = 0; c < ncontexts; ++c)
+    {
+      int run = npc + (c < remainder ? 1 : 0);
+      for (int i = 0; i < run; ++i, ++n)
+	templist[curve[n]]->context() = c;
+    }
+
+  // Number the local patches in order, then cut their part of the
+  // curve into one run per thread.
+
+  int idMax = 0;
+  for (n = 0; n < npatch; ++n)
+    if (templist[n]->context() == Pooma::context())
+      templist[n]->localID() = idMax++;
+
+  int affinityMax = Smarts::concurrency();
+  int rank = 0;
+  for (n = 0; n < npatch; ++n)
+    {
+      Value_t *node = templist[curve[n]];
+      if (node->context() == Pooma::context())
+	node->affinity() = static_cast<int>
+	  ( affinityMax * ( rank++ / static_cast<double>(idMax) ) );
+    }
+}
+
+
+#endif   // POOMA_SFCMAPPER_H
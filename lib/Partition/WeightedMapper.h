@@ -0,0 +1,201 @@
+// -*- C++ -*-
+//
+// Copyright (C) 1998, 1999, 2000, 2002  Los Alamos National Laboratory,
+// Copyright (C) 1998, 1999, 2000, 2002  CodeSourcery, LLC
+//
+// This file is part of FreePOOMA.
+//
+// FreePOOMA is free software; you can redistribute it and/or modify it
+// under the terms of the Expat license.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the Expat
+// license for more details.
+//
+// You should have received a copy of the Expat license along with
+// FreePOOMA; see the file LICENSE.
+//
+
+#ifndef POOMA_WEIGHTEDMAPPER_H
+#define POOMA_WEIGHTEDMAPPER_H
+
+/** @file
+ * @ingroup Partition
+ * @brief
+ * WeightedMapper is a ContextMapper implementation that balances the
+ * cost of the patches rather than their number.
+ *
+ * patchWeights() turns an array of per-element weights into the costs of
+ * the patches of a layout.
+ */
+
+#include "Partition/ContextMapper.h"
+#include "Utilities/PAssert.h"
+
+#include <algorithm>
+#include <vector>
+
+struct ReplicatedTag;
+struct DistributedTag;
+
+
+/**
+ * WeightedMapper is a ContextMapper implementation.
+ *
+ * It is given a cost for each patch, in the order of the global IDs of
+ * the layout's nodes, for instance the times measured by a PatchCosts
+ * object, and assigns the patches to contexts so the contexts get about
+ * the same total cost: the patches are taken from the most to the least
+ * expensive, and each goes to the context with the smallest cost so far.
+ * The local patches are assigned to threads (affinities) the same way.
+ *
+ * Made with a ReplicatedTag, every context keeps every patch, as with
+ * LocalMapper, and only the threads are balanced.  All contexts must be
+ * given the same costs.
+ *
+ * The mapper does not try to keep neighboring patches together.  Use it
+ * with layout.repartition(partitioner, mapper); the arrays on the layout
+ * move their data to the new patches.
+ */
+
+template<int Dim>
+class WeightedMapper
+  : public ContextMapper<Dim>
+{
+public:
+  //============================================================
+  // Typedefs and enumerations
+  //============================================================
+  typedef Interval<Dim>                       Domain_t;
+  typedef Node<Domain_t>                      Value_t;
+  typedef std::vector<Value_t *>              List_t;
+
+  explicit WeightedMapper(const std::vector<double> &weights)
+    : weights_m(weights), replicated_m(false)
+  {
+  }
+
+  WeightedMapper(const std::vector<double> &weights, const DistributedTag &)
+    : weights_m(weights), replicated_m(false)
+  {
+  }
+
+  WeightedMapper(const std::vector<double> &weights, const ReplicatedTag &)
+    : weights_m(weights), replicated_m(true)
+  {
+  }
+
+  void map(const List_t & templist) const;
+
+  /// Return the costs.
+
+  const std::vector<double> &weights() const { return weights_m; }
+
+private:
+
+  /// Order the patches by decreasing cost.  Patches with equal costs
+  /// keep their order, so every context computes the same mapping.
+
+  struct MoreExpensive
+  {
+    MoreExpensive(const std::vector<double> &w) : w_m(w) { }
+    bool operator()(int a, int b) const { return w_m[a] > w_m[b]; }
+    const std::vector<double> &w_m;
+  };
+
+  /// Return the bin with the smallest load.
+
+  static int lightest(const std::vector<double> &load)
+  {
+    return std::min_element(load.begin(), load.end()) - load.begin();
+  }
+
+  // Member Data
+  std::vector<double> weights_m;
+  bool replicated_m;
+};
+
+template<int Dim>
+void WeightedMapper<Dim>::map(const List_t & templist) const
+{
+  int n = templist.size();
+  PInsist(int(weights_m.size()) == n,
+	  "WeightedMapper needs one weight for each patch.");
+
+  std::vector<int> order(n);
+  for (int i = 0; i < n; ++i)
+    {
+      PAssert(weights_m[i] >= 0.0);
+      order[i] = i;
+    }
+  std::stable_sort(order.begin(), order.end(), MoreExpensive(weights_m));
+
+  // Assign the contexts.
+
+  if (replicated_m)
+    {
+      for (int i = 0; i < n; ++i)
+	templist[i]->context() = -1;
+    }
+  else
+    {
+      std::vector<double> load(Pooma::contexts(), 0.0);
+      for (int i = 0; i < n; ++i)
+	{
+	  int c = lightest(load);
+	  templist[order[i]]->context() = c;
+	  load[c] += weights_m[order[i]];
+	}
+    }
+
+  // Number the local patches in order, then assign their affinities.
+
+  int idMax = 0;
+  for (int i = 0; i < n; ++i)
+    if (templist[i]->context() == Pooma::context()
+	|| templist[i]->context() == -1)
+      templist[i]->localID() = idMax++;
+
+  std::vector<double> load(Smarts::concurrency(), 0.0);
+  for (int i = 0; i < n; ++i)
+    {
+      Value_t *node = templist[order[i]];
+      if (node->context() == Pooma::context() || node->context() == -1)
+	{
+	  int a = lightest(load);
+	  node->affinity() = a;
+	  load[a] += weights_m[order[i]];
+	}
+    }
+}
+
+
+/**
+ * patchWeights(layout, weights) returns the cost of each patch of the
+ * layout, in the order of the global IDs of its nodes, as the sum of the
+ * weights over the patch's owned domain.  The weights can be any array
+ * over the layout's domain, with or without the external guards, such
+ * as the number of particles in each cell or a flag for cells that need
+ * more work.
+ */
+
+template<class Layout, class Weights>
+std::vector<double> patchWeights(const Layout &layout, const Weights &weights)
+{
+  std::vector<double> ret;
+  ret.reserve(layout.sizeGlobal());
+  typename Layout::const_iterator p = layout.beginGlobal();
+  for (; p != layout.endGlobal(); ++p)
+    {
+      // The patches on the boundary own the external guards too.
+
+      Interval<Layout::dimensions> d = intersect((*p).domain(),
+						 weights.domain());
+      ret.push_back(d.empty() ? 0.0 : double(sum(weights(d))));
+    }
+  return ret;
+}
+
+
+#endif     // POOMA_WEIGHTEDMAPPER_H
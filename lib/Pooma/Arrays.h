@@ -42,6 +42,7 @@
 #include "Pooma/Tiny.h"
 
 #include "Evaluator/ScalarCode.h"
+#include "Evaluator/FusedAssign.h"
 
 #include "Functions/PackUnpack.h"
 
@@ -53,6 +53,18 @@
 //   Pooma::hardRun
 //   Pooma::lockThreads
 //   Pooma::blockingExpressions
+//   Pooma::tiledEvaluation
+//   Pooma::tileExtent
+//   Pooma::parallelPatches
+//   Pooma::intersectionCache
+//   Pooma::overlapGuards
+//   Pooma::deterministicReductions
+//   Pooma::ompThreshold
+//   Pooma::parallelWork
+//   Pooma::hugePageThreshold
+//   Pooma::blockCacheSize
+//   Pooma::firstTouch
+//   Pooma::mappedDirectory
 //   Pooma::controller
 //   Pooma::poll
 //
@@ -240,12 +252,21 @@ namespace Pooma {
   POOMA_DECLARE_STATISTIC(NumCompressedAssigns)
   POOMA_DECLARE_STATISTIC(NumAssignsRequiringUnCompression)
   POOMA_DECLARE_STATISTIC(NumInlineEvaluations)
+  POOMA_DECLARE_STATISTIC(NumSimdEvaluations)
+  POOMA_DECLARE_STATISTIC(NumFusedAssigns)
   POOMA_DECLARE_STATISTIC(NumLocalPatchesEvaluated)
+  POOMA_DECLARE_STATISTIC(NumOverlappedInteriors)
+  POOMA_DECLARE_STATISTIC(NumIntersectionCacheHits)
+  POOMA_DECLARE_STATISTIC(NumIntersectionCacheMisses)
   POOMA_DECLARE_STATISTIC(NumReductions)
   POOMA_DECLARE_STATISTIC(NumUnCompresses)
   POOMA_DECLARE_STATISTIC(NumUnsuccessfulTryCompresses)
   POOMA_DECLARE_STATISTIC(NumSuccessfulTryCompresses)
   POOMA_DECLARE_STATISTIC(NumPolls)
+  POOMA_DECLARE_STATISTIC(NumBlockCacheHits)
+  POOMA_DECLARE_STATISTIC(NumBlockCacheMisses)
+  POOMA_DECLARE_STATISTIC(BlockCacheBytesCached)
+  POOMA_DECLARE_STATISTIC(BlockCacheBytesReleased)
 
 
   //------------------------------------------------------
@@ -422,6 +443,7 @@ namespace Pooma {
   extern Context_t myContext_g;
   extern int numContexts_g;
   extern int expression_g;
+  extern long ompThreshold_g;
 
   // Return the context number for this context (0 ... # contexts - 1).
   
@@ -466,6 +488,96 @@ namespace Pooma {
   bool blockingExpressions();
 
   void blockingExpressions(bool on);
+
+  // Return or set whether the inline evaluators use cache-blocked (tiled)
+  // loop nests for domains of dimension 3 and higher.
+
+  bool tiledEvaluation();
+
+  void tiledEvaluation(bool on);
+
+  // Return the tile extent used along dimension 0 or 1, or set both.
+  // An extent of zero picks a value based on the size of the L2 cache.
+
+  int tileExtent(int dim);
+
+  void tileExtents(int t0, int t1);
+
+  // Return or set whether multi-patch expressions evaluate their patches
+  // concurrently, with serial loops inside each patch.
+
+  bool parallelPatches();
+
+  void parallelPatches(bool on);
+
+  // Return or set whether the patch intersections of multi-patch
+  // expressions are remembered and reused.
+
+  bool intersectionCache();
+
+  void intersectionCache(bool on);
+
+  // Return or set whether multi-patch expressions compute the interiors
+  // of their patches while the guard layers are filled.  The right hand
+  // side must not read the left hand side through guard layers.  With
+  // parallelPatches() the interiors, and then the shells, are evaluated
+  // concurrently.
+
+  bool overlapGuards();
+
+  void overlapGuards(bool on);
+
+  // Return or set whether reductions give the same result for any number
+  // of threads.
+
+  bool deterministicReductions();
+
+  void deterministicReductions(bool on);
+
+  // Return or set the work (elements times the estimated cost of one
+  // element) a loop nest must exceed before the evaluators run it with
+  // OpenMP.  Setting it to zero measures it again.
+
+  long ompThreshold();
+
+  void ompThreshold(long t);
+
+  // Return whether a loop over the given number of elements, each of the
+  // given cost, should open an OpenMP parallel region.
+
+  inline bool parallelWork(long elements, int cost)
+  {
+    return elements * cost > ompThreshold_g;
+  }
+
+  // Return or set the size in bytes from which new data blocks are put on
+  // huge pages, or zero to never use them.
+
+  long hugePageThreshold();
+
+  void hugePageThreshold(long bytes);
+
+  // Return or set the most bytes of freed data blocks that are kept for
+  // reuse, or zero to keep none.
+
+  long blockCacheSize();
+
+  void blockCacheSize(long bytes);
+
+  // Return or set whether the elements of new Bricks are initialized by
+  // the OpenMP threads that will compute on them, so their pages are
+  // placed on the memory nodes of those threads.
+
+  bool firstTouch();
+
+  void firstTouch(bool on);
+
+  // Return or set the directory memory-mapped engines make their scratch
+  // files in.  It is $TMPDIR, or /tmp, unless one has been set.
+
+  std::string mappedDirectory();
+
+  void mappedDirectory(const std::string &dir);
   
   // begin a new expression
 
@@ -519,7 +631,7 @@ inline void poll()
 #if POOMA_CHEETAH
   controller()->poll();
 #endif
-#if POOMA_SMARTS_SCHEDULER_SERIALASYNC
+#if POOMA_SMARTS_SCHEDULER_SERIALASYNC || POOMA_SMARTS_SCHEDULER_WORKSTEALING
   Smarts::SystemContext::runSomething();
 #endif
 
@@ -34,8 +34,22 @@
 #define POOMA_CHEETAH                      POOMA_NO
 #define POOMA_MPI                          POOMA_NO
 #define POOMA_THREADS                      POOMA_NO
-#define POOMA_SCHEDULER_NAME               "stub scheduler"
 #define POOMA_SMARTS_SCHEDULER_SERIALASYNC POOMA_NO
+#ifndef POOMA_SMARTS_SCHEDULER_WORKSTEALING
+#define POOMA_SMARTS_SCHEDULER_WORKSTEALING POOMA_NO
+#endif
+#if POOMA_SMARTS_SCHEDULER_WORKSTEALING
+#define POOMA_SCHEDULER_NAME               "work-stealing scheduler"
+#else
+#define POOMA_SCHEDULER_NAME               "stub scheduler"
+#endif
+#ifndef POOMA_ATOMIC_REFCOUNTS
+#if POOMA_THREADS || POOMA_SMARTS_SCHEDULER_WORKSTEALING || defined(_OPENMP)
+#define POOMA_ATOMIC_REFCOUNTS             POOMA_YES
+#else
+#define POOMA_ATOMIC_REFCOUNTS             POOMA_NO
+#endif
+#endif
 #define PETE_MAKE_EMPTY_CONSTRUCTORS       POOMA_NO
 #define POOMA_PURIFY                       POOMA_NO
 #define POOMA_INSURE                       POOMA_NO
@@ -107,6 +121,15 @@
 #define POOMA_HAS_LONG_LONG                POOMA_YES
 #define POOMA_INT64                        long
 #define POOMA_ATTRIBUTE_NORETURN           __attribute__((noreturn))
+#ifndef POOMA_BLOCK_ALIGNMENT
+#define POOMA_BLOCK_ALIGNMENT              64
+#endif
+#ifndef POOMA_HUGE_PAGE_THRESHOLD
+#define POOMA_HUGE_PAGE_THRESHOLD          4194304
+#endif
+#ifndef POOMA_BLOCK_CACHE_SIZE
+#define POOMA_BLOCK_CACHE_SIZE             268435456
+#endif
 
 #endif
 
@@ -0,0 +1,176 @@
+// -*- C++ -*-
+//
+// Copyright (C) 1998, 1999, 2000, 2002  Los Alamos National Laboratory,
+// Copyright (C) 1998, 1999, 2000, 2002  CodeSourcery, LLC
+//
+// This file is part of FreePOOMA.
+//
+// FreePOOMA is free software; you can redistribute it and/or modify it
+// under the terms of the Expat license.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the Expat
+// license for more details.
+//
+// You should have received a copy of the Expat license along with
+// FreePOOMA; see the file LICENSE.
+//
+
+//-----------------------------------------------------------------------------
+// Classes:
+// DataflowTrace
+//-----------------------------------------------------------------------------
+
+#ifndef POOMA_THREADS_ITERATESCHEDULERS_DATAFLOWTRACE_H
+#define POOMA_THREADS_ITERATESCHEDULERS_DATAFLOWTRACE_H
+
+/** @file
+ * @ingroup IterateSchedulers
+ * @brief
+ * DataflowTrace records what the iterate schedulers do with each iterate
+ * and writes it as a Chrome trace (JSON) that chrome://tracing and
+ * Perfetto can display.
+ *
+ * For every iterate the trace holds the time it was created, handed off,
+ * became ready (all its data object requests granted), started and
+ * finished, the thread it ran on, its affinity and its generation.  The
+ * grants are drawn as arrows from the iterate that released a data object
+ * to the iterate that got it, so the critical path of a time step and the
+ * time iterates spend waiting for data or for a thread can be read off
+ * the timeline.
+ *
+ * Tracing is off unless it is enabled with --pooma-trace <file>; the
+ * trace is written to the file by Pooma::finalize().  When tracing is off
+ * every hook is a test of one static flag.
+ */
+
+//-----------------------------------------------------------------------------
+// Includes:
+//-----------------------------------------------------------------------------
+
+#include "Threads/IterateSchedulers/Runnable.h"
+#include <atomic>
+#include <string>
+
+namespace Smarts {
+
+/**
+ * The schedulers call the static hooks of DataflowTrace as iterates move
+ * through them.  Iterates are identified by their address until they
+ * start; the thread numbers are the ones of the scheduler, 0 being the
+ * thread that runs the program.
+ */
+
+class DataflowTrace
+{
+public:
+
+  /// Start recording; the trace will be written to the given file.
+
+  static void enable(const std::string &filename);
+
+  /// Is a trace being recorded?
+
+  static bool enabled()
+  {
+    return enabled_s.load(std::memory_order_relaxed);
+  }
+
+  /// The file the trace will be written to.
+
+  static const std::string &filename();
+
+  /// Write the trace and stop recording.  Returns false if the file
+  /// could not be written.  Does nothing if tracing is off.
+
+  static bool write();
+
+  /// Microseconds since tracing was enabled.
+
+  static double now();
+
+  //@name Scheduler hooks
+  //@{
+
+  /// An iterate was constructed.
+
+  static void created(const void *it, int affinity)
+  {
+    if (enabled())
+      recordCreated(it, affinity);
+  }
+
+  /// An iterate was handed off in the given generation.
+
+  static void handedOff(const void *it, int generation)
+  {
+    if (enabled())
+      recordHandedOff(it, generation);
+  }
+
+  /// A data object granted a request of an iterate.  The grant is
+  /// charged to the runnable the thread is running, if any.
+
+  static void granted(const void *it, const void *data, bool write,
+		      int thread)
+  {
+    if (enabled())
+      recordGranted(it, data, write, thread);
+  }
+
+  /// All the requests of an iterate have been granted.
+
+  static void ready(const void *it)
+  {
+    if (enabled())
+      recordReady(it);
+  }
+
+  /// A thread starts to run a runnable.
+
+  static void started(Runnable *p, int thread)
+  {
+    if (enabled())
+      recordStarted(p, thread);
+  }
+
+  /// The thread has run and deleted the runnable it started last.
+
+  static void stopped(int thread)
+  {
+    if (enabled())
+      recordStopped(thread);
+  }
+
+  /// A thread spent the time since start in the scheduler, for instance
+  /// waiting in blockingEvaluate().
+
+  static void span(const char *name, int thread, double start)
+  {
+    if (enabled())
+      recordSpan(name, thread, start);
+  }
+
+  //@}
+
+private:
+
+  static void recordCreated(const void *it, int affinity);
+  static void recordHandedOff(const void *it, int generation);
+  static void recordGranted(const void *it, const void *data, bool write,
+			    int thread);
+  static void recordReady(const void *it);
+  static void recordStarted(Runnable *p, int thread);
+  static void recordStopped(int thread);
+  static void recordSpan(const char *name, int thread, double start);
+
+  // Read by every thread in the hooks, so it is atomic; the records
+  // themselves are guarded by a mutex.
+
+  static std::atomic<bool> enabled_s;
+};
+
+} // namespace Smarts
+
+#endif // POOMA_THREADS_ITERATESCHEDULERS_DATAFLOWTRACE_H
@@ -67,6 +67,7 @@
 #endif
 #include "Threads/IterateSchedulers/IterateScheduler.h"
 #include "Threads/IterateSchedulers/Runnable.h"
+#include "Threads/IterateSchedulers/DataflowTrace.h"
 #include "Utilities/PAssert.h"
 
 //-----------------------------------------------------------------------------
@@ -120,7 +121,9 @@ public:
 
   inline Iterate(IterateScheduler<SerialAsync> & s, int affinity=-1)
     : scheduler_m(s), notifications_m(1), generation_m(-1), togo_m(1)
-  {}
+  {
+    DataflowTrace::created(this, affinity);
+  }
 
   /// The dtor is virtual because the subclasses will need to add to it.
 
@@ -153,7 +156,10 @@ public:
   void notify()
   {
     if (--notifications_m == 0)
-      add(this);
+      {
+	DataflowTrace::ready(this);
+	add(this);
+      }
   }
 
   /// How many notifications remain?
@@ -318,6 +324,7 @@ struct SystemContext
     }
 
     if (p) {
+      DataflowTrace::started(p, 0);
       p->execute();
       Iterate<SerialAsync> *it = dynamic_cast<IteratePtr_t>(p);
       if (it) {
@@ -325,6 +332,7 @@ struct SystemContext
 	  delete it;
       } else
 	delete p;
+      DataflowTrace::stopped(0);
       return true;
 
     } else
@@ -440,6 +448,8 @@ public:
 
   void blockingEvaluate()
   {
+    double start = DataflowTrace::enabled() ? DataflowTrace::now() : 0.0;
+
     if (inGeneration()) {
       // It's not safe to block inside a generation, so
       // just do as much as we can without blocking.
@@ -451,6 +461,8 @@ public:
       while (SystemContext::workReady())
         SystemContext::runSomething(true);
     }
+
+    DataflowTrace::span("blockingEvaluate", 0, start);
   }
 
   /// The parser thread calls this method to ask the scheduler to run
@@ -462,6 +474,7 @@ public:
     // No action needs to be taken here.  Iterates will make their
     // own way into the execution queue.
     it->generation() = generation();
+    DataflowTrace::handedOff(it, it->generation());
     it->notify();
   }
 
@@ -608,6 +621,8 @@ DataObject<SerialAsync>::releaseIterates()
   if ( released_m != end )
     {
       // Release the first one whatever it is.
+      DataflowTrace::granted(&released_m->iterate(), this,
+			     released_m->act() == SerialAsync::Write, 0);
       released_m->iterate().notify();
       ++notifications_m;
 
@@ -627,6 +642,7 @@ DataObject<SerialAsync>::releaseIterates()
                (released_m->act()==SerialAsync::Read))
           {
             // Release it...
+            DataflowTrace::granted(&released_m->iterate(), this, false, 0);
             released_m->iterate().notify();
             ++notifications_m;
 
@@ -670,6 +686,7 @@ DataObject<SerialAsync>::request(Iterate<SerialAsync>& it,
   // If it's releasable, release it and record the release.
   if (releasable)
     {
+      DataflowTrace::granted(&it, this, act == SerialAsync::Write, 0);
       it.notify();
       ++notifications_m;
     }
@@ -0,0 +1,722 @@
+// -*- C++ -*-
+//
+// Copyright (C) 1998, 1999, 2000, 2002  Los Alamos National Laboratory,
+// Copyright (C) 1998, 1999, 2000, 2002  CodeSourcery, LLC
+//
+// This file is part of FreePOOMA.
+//
+// FreePOOMA is free software; you can redistribute it and/or modify it
+// under the terms of the Expat license.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the Expat
+// license for more details.
+//
+// You should have received a copy of the Expat license along with
+// FreePOOMA; see the file LICENSE.
+//
+
+//-----------------------------------------------------------------------------
+// Classes:
+// IterateScheduler<WorkStealing>
+// Iterate<WorkStealing>
+// DataObject<WorkStealing>
+// SystemContext
+// Mutex
+// CSem
+//-----------------------------------------------------------------------------
+
+#ifndef POOMA_THREADS_ITERATESCHEDULERS_WORKSTEALING_H
+#define POOMA_THREADS_ITERATESCHEDULERS_WORKSTEALING_H
+
+/** @file
+ * @ingroup IterateSchedulers
+ * @brief
+ * Smarts classes for dataflow evaluation on a pool of POSIX threads.
+ *
+ * The WorkStealing IterateScheduler builds the same dependence graph as
+ * SerialAsync: iterates request read or write access to DataObjects, the
+ * requests are granted in the order they were made, and consecutive
+ * reads are granted together.  Iterates whose requests have all been
+ * granted are put on the work queue of the thread given by their
+ * affinity.  Each thread runs the newest iterate of its own queue and,
+ * when that is empty, steals the oldest iterate of another queue.
+ *
+ * The scheduler is selected by defining POOMA_SMARTS_SCHEDULER_WORKSTEALING
+ * when POOMA is compiled.  It does not need the external Smarts library,
+ * so it also provides the Mutex and CSem classes that Threads/PoomaMutex.h
+ * and Threads/PoomaCSem.h use with threads.  The number of threads is set
+ * with --pooma-threads; the thread that runs the program counts as one of
+ * them and runs iterates while it waits in blockAndEvaluate().
+ */
+
+//-----------------------------------------------------------------------------
+// Includes:
+//-----------------------------------------------------------------------------
+
+#include "Threads/IterateSchedulers/IterateScheduler.h"
+#include "Threads/IterateSchedulers/Runnable.h"
+#include "Threads/IterateSchedulers/DataflowTrace.h"
+#include "Utilities/PAssert.h"
+#include <pthread.h>
+#include <sys/time.h>
+#include <atomic>
+#include <list>
+#include <deque>
+#include <vector>
+#include <stack>
+
+namespace Smarts {
+
+/**
+ * Tag class for specializing IterateScheduler, Iterate and DataObject.
+ */
+
+struct WorkStealing
+{
+  enum Action { Read, Write };
+};
+
+
+/**
+ * Mutex is a POSIX mutex.  Copies are new, unlocked mutexes, since the
+ * classes that hold a mutex (like RefCounted) do not share it when they
+ * are copied.
+ */
+
+class Mutex
+{
+public:
+
+  Mutex() { pthread_mutex_init(&mutex_m, 0); }
+
+  Mutex(const Mutex &) { pthread_mutex_init(&mutex_m, 0); }
+
+  Mutex &operator=(const Mutex &) { return *this; }
+
+  ~Mutex() { pthread_mutex_destroy(&mutex_m); }
+
+  void lock() { pthread_mutex_lock(&mutex_m); }
+
+  void unlock() { pthread_mutex_unlock(&mutex_m); }
+
+private:
+
+  friend class CSem;
+
+  pthread_mutex_t mutex_m;
+};
+
+
+/**
+ * SystemContext holds one work queue per thread and the worker threads.
+ * Thread 0 is the thread that runs the program; threads 1 to n-1 are
+ * started by start(n).
+ */
+
+struct SystemContext
+{
+  /// A work queue.  Its owner takes runnables from the back, other
+  /// threads steal from the front.
+
+  struct WorkQueue
+  {
+    Mutex mutex_m;
+    std::deque<RunnablePtr_t> queue_m;
+  };
+
+  /// The number of threads, including the main thread.
+
+  static int threads()
+  {
+    return workQueues_m.size();
+  }
+
+  /// The number of the calling thread.
+
+  static int threadID()
+  {
+    if (workQueues_m.empty())
+      return 0;
+    return static_cast<int>(reinterpret_cast<long>
+			    (pthread_getspecific(threadKey_m)));
+  }
+
+  /// Start n-1 worker threads, after stopping the ones that run.
+
+  static void start(int n);
+
+  /// Run all the work there is and stop the worker threads.
+
+  static void stop();
+
+  /// Put a runnable that is ready to run on the queue of the thread
+  /// given by affinity, or on the queue of the calling thread if the
+  /// affinity is negative.
+
+  static void enqueue(RunnablePtr_t p, int affinity)
+  {
+    if (workQueues_m.empty())
+      start(1);
+
+    int n = threads();
+    int q = (affinity >= 0 ? affinity % n : threadID());
+    WorkQueue &wq = *workQueues_m[q];
+    wq.mutex_m.lock();
+    wq.queue_m.push_back(p);
+    wq.mutex_m.unlock();
+
+    ++queued_m;
+    pthread_mutex_lock(&idleMutex_m);
+    pthread_cond_signal(&idleCond_m);
+    pthread_mutex_unlock(&idleMutex_m);
+  }
+
+  /// Count a runnable that will be run before blockAndEvaluate returns.
+
+  static void handedOff()
+  {
+    ++outstanding_m;
+  }
+
+  /// Whether there are runnables waiting to be run.
+
+  static bool workReady()
+  {
+    return queued_m > 0;
+  }
+
+  /// Run a runnable from the queue of the calling thread, or steal one
+  /// from another queue.  Return whether something was run.
+
+  static bool runSomething(bool mayBlock = true);
+
+  /// Run runnables until all that were handed off have finished.  From
+  /// inside a runnable, which is itself one of them, only run what is
+  /// ready.
+
+  static void runAll();
+
+private:
+
+  static RunnablePtr_t take(int id);
+
+  static void *workerMain(void *id);
+
+  static std::vector<WorkQueue *> workQueues_m;
+  static std::vector<pthread_t> workers_m;
+  static pthread_key_t threadKey_m;
+  static pthread_mutex_t idleMutex_m;
+  static pthread_cond_t idleCond_m;
+  static std::atomic<int> queued_m;
+  static std::atomic<int> outstanding_m;
+  static std::atomic<bool> shutdown_m;
+
+  /// How many runnables each thread is running; more than one if a
+  /// runnable calls runSomething().
+  static std::vector<int> running_m;
+
+  friend class CSem;
+};
+
+
+/**
+ * CSem is a counting semaphore: wait() returns when the count has
+ * reached the height.  A waiting thread runs iterates while it waits, so
+ * waiting does not take a thread away from the scheduler.
+ */
+
+class CSem
+{
+public:
+
+  CSem(int height = 0)
+    : count_m(0), height_m(height)
+  {
+    pthread_cond_init(&cond_m, 0);
+  }
+
+  ~CSem()
+  {
+    pthread_cond_destroy(&cond_m);
+  }
+
+  void wait()
+  {
+    while (count() < height())
+      {
+	if (SystemContext::runSomething())
+	  continue;
+
+	// Nothing to do here, so sleep until the count changes.  We wake
+	// up now and then in case new work arrived for this thread.
+
+	struct timeval now;
+	gettimeofday(&now, 0);
+	struct timespec until;
+	until.tv_sec = now.tv_sec;
+	until.tv_nsec = now.tv_usec * 1000 + 1000000;
+	if (until.tv_nsec >= 1000000000)
+	  {
+	    until.tv_sec += 1;
+	    until.tv_nsec -= 1000000000;
+	  }
+
+	mutex_m.lock();
+	if (count_m < height_m)
+	  pthread_cond_timedwait(&cond_m, &mutex_m.mutex_m, &until);
+	mutex_m.unlock();
+      }
+  }
+
+  int count()
+  {
+    mutex_m.lock();
+    int c = count_m;
+    mutex_m.unlock();
+    return c;
+  }
+
+  int height()
+  {
+    mutex_m.lock();
+    int h = height_m;
+    mutex_m.unlock();
+    return h;
+  }
+
+  void height(int d)
+  {
+    mutex_m.lock();
+    height_m = d;
+    mutex_m.unlock();
+  }
+
+  void raise_height(int d)
+  {
+    mutex_m.lock();
+    height_m += d;
+    mutex_m.unlock();
+  }
+
+  void incr()
+  {
+    mutex_m.lock();
+    ++count_m;
+    pthread_cond_broadcast(&cond_m);
+    mutex_m.unlock();
+  }
+
+  int operator+=(int d)
+  {
+    mutex_m.lock();
+    int h = (height_m += d);
+    mutex_m.unlock();
+    return h;
+  }
+
+private:
+
+  CSem(const CSem &);
+  CSem &operator=(const CSem &);
+
+  Mutex mutex_m;
+  pthread_cond_t cond_m;
+  int count_m;
+  int height_m;
+};
+
+
+/**
+ * Iterate<WorkStealing> is the unit of work of the WorkStealing
+ * scheduler.  As for SerialAsync, it counts the requests that have not
+ * been granted yet (plus one for the hand off) and goes to a work queue
+ * when the count drops to zero.  The counts are changed atomically since
+ * requests are granted by whichever thread releases a DataObject.
+ *
+ * The affinity and the hint affinity both pick the work queue of an
+ * iterate; the affinity wins if both are given.  Either way the iterate
+ * may be stolen by an idle thread.
+ */
+
+template<>
+class Iterate<WorkStealing> : public Runnable
+{
+  friend class IterateScheduler<WorkStealing>;
+  friend class DataObject<WorkStealing>;
+
+public:
+
+  typedef DataObject<WorkStealing> DataObject_t;
+  typedef IterateScheduler<WorkStealing> IterateScheduler_t;
+
+  /// The constructor takes the IterateScheduler and a CPU affinity.
+  /// An affinity of -1 means the iterate may run on any thread.
+
+  inline Iterate(IterateScheduler<WorkStealing> &s, int affinity = -1)
+    : scheduler_m(s), notifications_m(1), generation_m(-1),
+      affinity_m(affinity), hintAffinity_m(-1)
+  {
+    DataflowTrace::created(this, affinity);
+  }
+
+  /// The dtor is virtual because the subclasses will need to add to it.
+
+  virtual ~Iterate() { }
+
+  /// The run method does the core work of the Iterate.
+  /// It is supplied by the subclass.
+
+  virtual void run() = 0;
+
+  //@name Affinities
+  //@{
+
+  inline int affinity() const { return affinity_m; }
+
+  inline int hintAffinity() const { return hintAffinity_m; }
+
+  inline void affinity(int a) { affinity_m = a; }
+
+  inline void hintAffinity(int a) { hintAffinity_m = a; }
+
+  //@}
+
+  /// Notify is used to indicate to the Iterate that one of the data
+  /// objects it had requested has been granted.  The last notification
+  /// puts the iterate on a work queue.
+
+  void notify()
+  {
+    if (--notifications_m == 0)
+      {
+	DataflowTrace::ready(this);
+	SystemContext::enqueue(this,
+			       affinity_m >= 0 ? affinity_m : hintAffinity_m);
+      }
+  }
+
+  /// How many notifications remain?
+
+  int notifications() const { return notifications_m; }
+
+  void addNotification() { ++notifications_m; }
+
+  int &generation() { return generation_m; }
+
+protected:
+
+  /// What scheduler are we working with?
+  IterateScheduler<WorkStealing> &scheduler_m;
+
+  /// How many notifications should we receive before we can run?
+  std::atomic<int> notifications_m;
+
+  /// Which generation we were issued in.
+  int generation_m;
+
+  /// The thread we should run on, and the thread we would like to run on.
+  int affinity_m;
+  int hintAffinity_m;
+};
+
+
+/// Adds a runnable to the work queue of the calling thread.  It is
+/// deleted after it has run.
+
+inline void add(RunnablePtr_t rn)
+{
+  SystemContext::handedOff();
+  SystemContext::enqueue(rn, -1);
+}
+
+inline void concurrency(int n)
+{
+  PAssert(n >= 1);
+  SystemContext::start(n);
+}
+
+inline int concurrency()
+{
+  int n = SystemContext::threads();
+  return n > 0 ? n : 1;
+}
+
+inline void wait()
+{
+  SystemContext::stop();
+}
+
+inline void mustRunOn() { }
+
+
+/**
+ * IterateScheduler<WorkStealing> collects iterates from the parser thread
+ * and runs them on the thread pool as their requests are granted.
+ * blockingEvaluate() runs iterates on the calling thread until all the
+ * iterates that were handed off have finished.
+ */
+
+template<>
+class IterateScheduler<WorkStealing>
+{
+  friend class DataObject<WorkStealing>;
+  friend class Iterate<WorkStealing>;
+
+public:
+
+  typedef DataObject<WorkStealing> DataObject_t;
+  typedef Iterate<WorkStealing> Iterate_t;
+
+  IterateScheduler()
+    : generation_m(0)
+  { }
+
+  ~IterateScheduler() { }
+
+  void setConcurrency(int n) { concurrency(n); }
+
+  /// Tells the scheduler that the parser thread is starting a new
+  /// data-parallel statement.  Nested invocations are handled as being
+  /// part of the outermost generation.
+
+  void beginGeneration()
+  {
+    if (++generation_m < 0)
+      generation_m = 0;
+    generationStack_m.push(generation_m);
+  }
+
+  /// Tells the scheduler that no more Iterates will be handed off for
+  /// the data parallel statement that was begun with a
+  /// beginGeneration().
+
+  void endGeneration()
+  {
+    PAssert(inGeneration());
+    generationStack_m.pop();
+  }
+
+  /// Whether we are inside a generation and may not safely block.
+
+  bool inGeneration() const
+  {
+    return !generationStack_m.empty();
+  }
+
+  /// What the current generation is.
+
+  int generation() const
+  {
+    if (!inGeneration())
+      return -1;
+    return generationStack_m.top();
+  }
+
+  /// Run the iterates that have been handed off until they have all
+  /// finished.  Inside a generation some iterates may not have been
+  /// handed off yet, so we only run what is ready.
+
+  void blockingEvaluate()
+  {
+    double start = DataflowTrace::enabled() ? DataflowTrace::now() : 0.0;
+
+    if (inGeneration())
+      {
+	while (SystemContext::runSomething(false))
+	  ;
+      }
+    else
+      {
+	SystemContext::runAll();
+      }
+
+    DataflowTrace::span("blockingEvaluate", SystemContext::threadID(), start);
+  }
+
+  /// The parser thread calls this method to ask the scheduler to run
+  /// the given Iterate when its requests have been granted.
+
+  void handOff(Iterate<WorkStealing> *it)
+  {
+    it->generation() = generation();
+    DataflowTrace::handedOff(it, it->generation());
+    SystemContext::handedOff();
+    it->notify();
+  }
+
+  void releaseIterates() { }
+
+private:
+
+  std::stack<int> generationStack_m;
+  int generation_m;
+};
+
+
+/**
+ * DataObject<WorkStealing> grants read and write requests in the order
+ * they were made, exactly like DataObject<SerialAsync>.  Requests come
+ * from the parser thread and releases from the threads running iterates,
+ * so both are done under a mutex.
+ */
+
+template<>
+class DataObject<WorkStealing>
+{
+  friend class IterateScheduler<WorkStealing>;
+  friend class Iterate<WorkStealing>;
+
+public:
+
+  typedef IterateScheduler<WorkStealing> IterateScheduler_t;
+  typedef Iterate<WorkStealing> Iterate_t;
+
+  /// Construct the data object with an empty set of requests
+  /// and the given affinity.
+
+  DataObject(int affinity = -1)
+    : released_m(queue_m.end()), notifications_m(0), affinity_m(affinity)
+  { }
+
+  /// For compatibility with other SMARTS schedulers, accept
+  /// Scheduler arguments (unused).
+
+  DataObject(int affinity, IterateScheduler<WorkStealing> &)
+    : released_m(queue_m.end()), notifications_m(0), affinity_m(affinity)
+  { }
+
+  int affinity() const { return affinity_m; }
+
+  void affinity(int a) { affinity_m = a; }
+
+  /// An iterate makes a request for a certain action.
+
+  inline void request(Iterate<WorkStealing> &, WorkStealing::Action);
+
+  /// An iterate finishes and tells the DataObject it no longer needs
+  /// it.  If this is the last release for the current set of
+  /// requests, release some more.
+
+  void release(WorkStealing::Action)
+  {
+    mutex_m.lock();
+    if (--notifications_m == 0)
+      releaseIterates();
+    mutex_m.unlock();
+  }
+
+private:
+
+  /// If release needs to let more iterates go, it calls this.
+  inline void releaseIterates();
+
+  /// The type for a request.
+  class Request
+  {
+  public:
+    Request() { }
+    Request(Iterate<WorkStealing> &it, WorkStealing::Action act)
+      : iterate_m(&it), act_m(act) { }
+
+    Iterate<WorkStealing> &iterate() const { return *iterate_m; }
+    WorkStealing::Action act() const { return act_m; }
+  private:
+    Iterate<WorkStealing> *iterate_m;
+    WorkStealing::Action act_m;
+  };
+
+  typedef std::list<Request> Container_t;
+  typedef Container_t::iterator Iterator_t;
+
+  /// The requests, granted in FIFO order.
+  Container_t queue_m;
+
+  /// Pointer to the first request that has not been granted.
+  Iterator_t released_m;
+
+  /// The number of granted requests that have not been released.
+  int notifications_m;
+
+  /// The thread this data prefers.
+  int affinity_m;
+
+  /// Protects the queue.
+  Mutex mutex_m;
+};
+
+/// Remove the finished requests and grant the next write, or the next
+/// run of reads.
+
+inline void
+DataObject<WorkStealing>::releaseIterates()
+{
+  queue_m.erase(queue_m.begin(), released_m);
+
+  released_m = queue_m.begin();
+  Iterator_t end = queue_m.end();
+
+  if (released_m != end)
+    {
+      WorkStealing::Action act = released_m->act();
+      DataflowTrace::granted(&released_m->iterate(), this,
+			     act == WorkStealing::Write,
+			     SystemContext::threadID());
+      released_m->iterate().notify();
+      ++notifications_m;
+      ++released_m;
+
+      if (act == WorkStealing::Read)
+	{
+	  while ((released_m != end) &&
+		 (released_m->act() == WorkStealing::Read))
+	    {
+	      DataflowTrace::granted(&released_m->iterate(), this, false,
+				     SystemContext::threadID());
+	      released_m->iterate().notify();
+	      ++notifications_m;
+	      ++released_m;
+	    }
+	}
+    }
+}
+
+/// An iterate asks for access to this DataObject.  The request is granted
+/// at once if the queue is empty, or if it is a read and every request in
+/// the queue is a granted read.
+
+inline void
+DataObject<WorkStealing>::request(Iterate<WorkStealing> &it,
+				  WorkStealing::Action act)
+{
+  it.addNotification();
+
+  mutex_m.lock();
+
+  bool allReleased = (queue_m.end() == released_m);
+  bool releasable = queue_m.empty() ||
+    ((act == WorkStealing::Read) &&
+     (queue_m.begin()->act() == WorkStealing::Read) &&
+     allReleased);
+
+  queue_m.push_back(Request(it, act));
+
+  if (releasable)
+    {
+      DataflowTrace::granted(&it, this, act == WorkStealing::Write,
+			     SystemContext::threadID());
+      it.notify();
+      ++notifications_m;
+    }
+  else if (allReleased)
+    {
+      --released_m;
+    }
+
+  mutex_m.unlock();
+}
+
+} // namespace Smarts
+
+#endif // POOMA_THREADS_ITERATESCHEDULERS_WORKSTEALING_H
@@ -84,13 +84,18 @@
 //
 //-----------------------------------------------------------------------------
 
-#if POOMA_THREADS 
+#if POOMA_THREADS || POOMA_SMARTS_SCHEDULER_WORKSTEALING
 
 // NOTE: This is probably not correct if real PThreads are being used,
 // unless we've adjusted the path or something to pick up a version of
-// CSem.h that wraps a PThread semaphore.
+// CSem.h that wraps a PThread semaphore.  The work-stealing scheduler
+// provides such a version.
 
+#if POOMA_SMARTS_SCHEDULER_WORKSTEALING
+#include "Threads/IterateSchedulers/WorkStealing.h"
+#else
 #include "CSem.h"
+#endif
 
 namespace Pooma {
 
@@ -55,7 +55,17 @@
 //
 //-----------------------------------------------------------------------------
 
-#if POOMA_THREADS && !POOMA_SMARTS_SCHEDULER_SERIALASYNC
+#if POOMA_SMARTS_SCHEDULER_WORKSTEALING
+
+// The native work-stealing scheduler brings its own POSIX mutex.
+
+#include "Threads/IterateSchedulers/WorkStealing.h"
+
+namespace Pooma {
+  typedef Smarts::Mutex Mutex_t;
+}
+
+#elif POOMA_THREADS && !POOMA_SMARTS_SCHEDULER_SERIALASYNC
 
 // NOTE: This is probably not correct if real PThreads are being used,
 // unless we've adjusted the path or something to pick up a version of
@@ -48,7 +48,18 @@
 // to the particular choice of scheduler.
 //-----------------------------------------------------------------------------
 
-#if POOMA_THREADS
+#if POOMA_SMARTS_SCHEDULER_WORKSTEALING
+
+// The work-stealing scheduler runs iterates on its own pool of POSIX
+// threads and does not need the Smarts library.
+
+# include "Threads/IterateSchedulers/WorkStealing.h"
+
+namespace Pooma {
+  typedef Smarts::WorkStealing SmartsTag_t;
+}
+
+#elif POOMA_THREADS
 
 // Set up to use the proper scheduler.  One of the following blocks will
 // end up being included.
@@ -32,6 +32,7 @@
 
 #include "Threads/IterateSchedulers/IterateScheduler.h"
 #include "Threads/IterateSchedulers/Runnable.h"
+#include "Threads/IterateSchedulers/DataflowTrace.h"
 
 namespace Smarts {
 
@@ -130,8 +131,12 @@ public:
   inline
   void handOff(Iterate<Stub>* it)
   {
+    DataflowTrace::handedOff(it, generation_m);
+    DataflowTrace::ready(it);
+    DataflowTrace::started(it, 0);
     it->run();
     delete it;
+    DataflowTrace::stopped(0);
   }
   
 protected:
@@ -141,10 +146,12 @@ private:
 
 }; // class IterateScheduler<Stub>
 
-inline Iterate<Stub>::Iterate(IterateScheduler<Stub> & scheduler, int)
+inline Iterate<Stub>::Iterate(IterateScheduler<Stub> & scheduler,
+			      int affinity)
   : scheduler_m(scheduler) 
 {
   generation(scheduler.generation());
+  DataflowTrace::created(this, affinity);
 }
 
 
@@ -176,7 +183,10 @@ public:
 
     // An iterate makes a request for a certain action in a certain
     // generation.
-    inline void request(Iterate<Stub>&, Stub::Action) {}
+    inline void request(Iterate<Stub>& it, Stub::Action act)
+    {
+      DataflowTrace::granted(&it, this, act == Stub::Write, 0);
+    }
 
     // An iterate finishes and tells the DataObject it no longer needs
     // it.  If this is the last release for the current set of requests,
@@ -203,8 +213,10 @@ inline void wait()
 
 inline void add(Runnable *runnable)
 {
+  DataflowTrace::started(runnable, 0);
   runnable->execute();
   delete runnable;
+  DataflowTrace::stopped(0);
 }
 
 } // namespace Smarts
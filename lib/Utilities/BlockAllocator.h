@@ -0,0 +1,139 @@
+// -*- C++ -*-
+//
+// Copyright (C) 1998, 1999, 2000, 2002  Los Alamos National Laboratory,
+// Copyright (C) 1998, 1999, 2000, 2002  CodeSourcery, LLC
+//
+// This file is part of FreePOOMA.
+//
+// FreePOOMA is free software; you can redistribute it and/or modify it
+// under the terms of the Expat license.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the Expat
+// license for more details.
+//
+// You should have received a copy of the Expat license along with
+// FreePOOMA; see the file LICENSE.
+//
+
+//-----------------------------------------------------------------------------
+// Functions:
+//   Pooma::allocateBlock
+//   Pooma::deallocateBlock
+//   Pooma::isBlockAligned
+//   Pooma::flushBlockCache
+//   Pooma::trimBlockCache
+//   Pooma::blockCacheBytes
+//   Pooma::pageNodes
+//-----------------------------------------------------------------------------
+
+#ifndef POOMA_UTILITIES_BLOCKALLOCATOR_H
+#define POOMA_UTILITIES_BLOCKALLOCATOR_H
+
+/** @file
+ * @ingroup Utilities
+ * @brief
+ * Raw storage for the data blocks of RefBlockController.
+ *
+ * Blocks are aligned to POOMA_BLOCK_ALIGNMENT bytes (64 unless it is
+ * defined otherwise when POOMA is compiled), so the first element of a
+ * Brick starts on a cache line.  Blocks of at least
+ * Pooma::hugePageThreshold() bytes are aligned to, and rounded up to, the
+ * 2MB huge page size, and the kernel is asked to back them with
+ * transparent huge pages.
+ *
+ * Blocks of at least blockCacheMinimum bytes are not given back to the
+ * system when they are freed, but kept in a block cache, up to
+ * Pooma::blockCacheSize() bytes in all, so the temporaries an expression
+ * makes every timestep can reuse the same pages instead of mapping and
+ * faulting in new ones.  The sizes of these blocks are rounded up to
+ * one of four classes per power of two, so a freed block fits any
+ * request of its class.  When the cache is full the blocks that were
+ * freed first are given back first.
+ *
+ * When Pooma::firstTouch() is on, the elements of large new blocks are
+ * initialized by an OpenMP loop with the same static schedule the
+ * InlineEvaluator uses, so on a NUMA machine each page is placed on the
+ * node of the thread that computes on it (see RefBlockController).
+ * pageNodes() tells on which nodes the pages of a block are.  Blocks
+ * reused from the block cache keep the pages they had.
+ */
+
+//-----------------------------------------------------------------------------
+// Includes:
+//-----------------------------------------------------------------------------
+
+#include "Pooma/Configuration.h"
+#include <stddef.h>
+#include <vector>
+
+namespace Pooma {
+
+/// The size of a huge page.
+
+enum { hugePageSize = 2 * 1024 * 1024 };
+
+/// The smallest block, in bytes, that goes on huge pages, or 0 if huge
+/// pages are not used.  It is set by Pooma::hugePageThreshold().
+
+extern size_t hugePageThreshold_g;
+
+/// The smallest block, in bytes, that goes in the block cache.
+
+enum { blockCacheMinimum = 64 * 1024 };
+
+/// The most bytes the block cache keeps, or 0 if it is off.  It is set
+/// by Pooma::blockCacheSize(), and is 0 before Pooma::initialize() and
+/// after Pooma::finalize().
+
+extern size_t blockCacheSize_g;
+
+/// Whether large new blocks are initialized by parallel loops.  It is
+/// set by Pooma::firstTouch().
+
+extern bool firstTouch_g;
+
+/// The smallest block, in bytes, that is initialized in parallel.
+
+enum { firstTouchMinimum = 64 * 1024 };
+
+/// Allocate an aligned block of the given number of bytes.  Throws
+/// std::bad_alloc if there is no memory.
+
+void *allocateBlock(size_t bytes);
+
+/// Free a block from allocateBlock().  The size must be the one that
+/// was asked for, or less.
+
+void deallocateBlock(void *p, size_t bytes);
+
+/// Give all the blocks in the block cache back to the system.
+
+void flushBlockCache();
+
+/// Give blocks back to the system, oldest first, until the block cache
+/// holds no more than blockCacheSize_g bytes.
+
+void trimBlockCache();
+
+/// The number of bytes in the block cache.
+
+size_t blockCacheBytes();
+
+/// Find the memory node of each page of the given bytes of memory,
+/// without moving any.  A page that has not been touched yet gets a
+/// negative number.  Returns false if the system cannot tell.
+
+bool pageNodes(const void *p, size_t bytes, std::vector<int> &nodes);
+
+/// Is the pointer aligned like the start of a block?
+
+inline bool isBlockAligned(const void *p)
+{
+  return reinterpret_cast<size_t>(p) % POOMA_BLOCK_ALIGNMENT == 0;
+}
+
+} // namespace Pooma
+
+#endif // POOMA_UTILITIES_BLOCKALLOCATOR_H
@@ -103,6 +103,23 @@ public:
     return double(clock()) / CLOCKS_PER_SEC; // CPU-time
 
 # endif
+#endif
+  }
+
+  //---------------------------------------------------------------------
+  // Return the current value of a monotonic timer [sec], for measuring
+  // short intervals.  It has nanosecond resolution where clock_gettime
+  // provides CLOCK_MONOTONIC, and is never set back.  Otherwise it is
+  // the same as value().
+
+  inline static double monotonic()
+  {
+#if defined(CLOCK_MONOTONIC)
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + 1e-9 * ts.tv_nsec;
+#else
+    return value();
 #endif
   }
 };
@@ -130,6 +130,17 @@ public:
       dynamicID_m(ObserverEvent::nullID())
   { }
 
+  DataBlockController(size_t size, const FirstTouchTag &tag)
+    : Base_t(size,tag), dataObjectPtr_m(new DataObject_t(-1)), owned_m(true),
+      dynamicID_m(ObserverEvent::nullID())
+  { }
+
+  DataBlockController(size_t size, const T & model, const FirstTouchTag &tag)
+    : Base_t(size,model,tag), dataObjectPtr_m(new DataObject_t(-1)),
+      owned_m(true),
+      dynamicID_m(ObserverEvent::nullID())
+  { }
+
   // This one is new as it sets the affinity for the DataObject.
   // It would be nice to do away with the tag here, but
   // this would be ambiguous for DataBlockController<int>.
@@ -154,6 +165,13 @@ public:
       dynamicID_m(ObserverEvent::nullID())
   { }
 
+  DataBlockController(size_t size, int affinity, const WithAffinity &,
+                      const FirstTouchTag &tag)
+    : Base_t(size,tag), dataObjectPtr_m(new DataObject_t(affinity)),
+      owned_m(true),
+      dynamicID_m(ObserverEvent::nullID())
+  { }
+
   // This one takes a specified DataObject. This is for use by clients
   // that need to maintain ownership of the DataObject, like 
   // CompressibleBlockController.
@@ -438,6 +456,17 @@ public:
   DataBlockPtr(size_t size, const NoInitTag &tag)
     : RCBPtr_t(size,tag)
   { }
+
+  // Initialize the elements in parallel chunks, optionally with a
+  // model, so they are placed near the threads that use them.
+
+  DataBlockPtr(size_t size, const FirstTouchTag &tag)
+    : RCBPtr_t(size,tag)
+  { }
+
+  DataBlockPtr(size_t size, const T& model, const FirstTouchTag &tag)
+    : RCBPtr_t(size,model,tag)
+  { }
   
   // A DataBlockPtr can be initialized to a given value.
 
@@ -475,6 +504,11 @@ public:
     : RCBPtr_t(new Controller_t(size,affin,WithAffinity_t(),tag))
   { }
 
+  DataBlockPtr(int size, int affin, const WithAffinity_t&,
+	       const FirstTouchTag &tag)
+    : RCBPtr_t(new Controller_t(size,affin,WithAffinity_t(),tag))
+  { }
+
   // Constructors taking an externally supplied DataObject.
   
   DataBlockPtr(int size, DataObject_t &dobj)
@@ -498,6 +532,15 @@ public:
     if (this->isValid()) this->blockControllerPtr_m->notifyOnConstruct();
   }
 
+  // Move constructor.
+  // The view of the model becomes ours, so the controller is not
+  // notified; the model is left invalid and notifies nothing when it
+  // goes away.
+
+  DataBlockPtr(This_t&& model) noexcept
+    : RCBPtr_t(std::move(model))
+  { }
+
   // Same as above except allow the client to specify the
   // DataObject. 
   
@@ -570,6 +613,19 @@ public:
     return *this;
   }
 
+  // Move assignment operator.
+  // The view of the RHS becomes ours and we remove ours.
+
+  This_t & operator=(This_t && rhs)
+  {
+    if (this != &rhs)
+      {
+	if (this->isValid()) this->blockControllerPtr_m->notifyOnDestruct();
+	RCBPtr_t::operator=(std::move(rhs));
+      }
+    return *this;
+  }
+
   // Same as above, but for opposite polarity
   // of bounds-checking.
 
@@ -0,0 +1,112 @@
+// -*- C++ -*-
+//
+// Copyright (C) 1998, 1999, 2000, 2002  Los Alamos National Laboratory,
+// Copyright (C) 1998, 1999, 2000, 2002  CodeSourcery, LLC
+//
+// This file is part of FreePOOMA.
+//
+// FreePOOMA is free software; you can redistribute it and/or modify it
+// under the terms of the Expat license.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the Expat
+// license for more details.
+//
+// You should have received a copy of the Expat license along with
+// FreePOOMA; see the file LICENSE.
+//
+
+//-----------------------------------------------------------------------------
+// Classes:
+//   MappedFile
+//-----------------------------------------------------------------------------
+
+#ifndef POOMA_UTILITIES_MAPPEDFILE_H
+#define POOMA_UTILITIES_MAPPEDFILE_H
+
+/** @file
+ * @ingroup Utilities
+ * @brief
+ * A file mapped into memory with mmap(MAP_SHARED), used as the storage of
+ * out-of-core engines.
+ *
+ * The pages of the mapping are read in from the file when they are first
+ * touched and may be written back and dropped by the system at any
+ * time, so the file can be much larger than memory.  The kernel is told
+ * the mapping will be read sequentially, so it reads ahead aggressively
+ * and drops pages behind the reader.
+ */
+
+//-----------------------------------------------------------------------------
+// Includes:
+//-----------------------------------------------------------------------------
+
+#include "Utilities/RefCounted.h"
+#include <stddef.h>
+#include <string>
+
+
+/**
+ * A MappedFile maps a file of a given size into memory for reading and
+ * writing.  A named file is created if it does not exist and extended if
+ * it is too small; its contents are kept, and writes go back to it.  A
+ * scratch file is made in Pooma::mappedDirectory() and removed at once,
+ * so it goes away with the mapping.  New parts of either are zero.
+ *
+ * MappedFiles are reference counted, so engines can share one; the file
+ * is unmapped and closed when the last reference goes.  Failure to
+ * create or map the file is reported with PInsist.
+ */
+
+class MappedFile : public RefCounted
+{
+public:
+
+  /// Map a scratch file of the given size.
+
+  explicit MappedFile(size_t bytes);
+
+  /// Map the named file, making it at least the given size.
+
+  MappedFile(const std::string &name, size_t bytes);
+
+  /// Write back and unmap the file.
+
+  ~MappedFile();
+
+  /// The start of the mapping, which is page aligned.
+
+  void *data() const { return data_m; }
+
+  /// The size of the mapping in bytes.
+
+  size_t size() const { return size_m; }
+
+  /// The name of the file, which is empty for scratch files.
+
+  const std::string &name() const { return name_m; }
+
+  /// Write the modified pages back to the file and wait until they are
+  /// written.
+
+  void flush() const;
+
+private:
+
+  /// Size the open file and map it.
+
+  void map();
+
+  // Files are not copied.
+
+  MappedFile(const MappedFile &);
+  MappedFile &operator=(const MappedFile &);
+
+  std::string name_m;
+  int fd_m;
+  void *data_m;
+  size_t size_m;
+};
+
+#endif // POOMA_UTILITIES_MAPPEDFILE_H
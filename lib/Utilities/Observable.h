@@ -192,6 +192,22 @@ public:
       detach(&o);
     }
 
+  // Put another Observer in the place of an attached one.  This is for
+  // observers that are moved: the new one takes over the place of the
+  // old one, which is left detached.
+
+  void replace(Observer<T> *o, Observer<T> *by)
+    {
+      mutex_m.lock();
+      for (int i=0; i < count_m; ++i) {
+	if (observers_m[i] == o) {
+	  observers_m[i] = by;
+	  break;
+	}
+      }
+      mutex_m.unlock();
+    }
+
   // When called, notify calls the notify method in each attached Observer,
   // passing on which observed object this is referring to and what the
   // event code is.
@@ -194,6 +194,117 @@ public:
 
   void blockingExpressions(bool p) { blockingExpressions_m = p; }
 
+  // Return or set whether the inline evaluators should use cache-blocked
+  // (tiled) loops for domains of dimension 3 and higher.
+
+  bool tiledEvaluation() const { return tiledEvaluation_m; }
+
+  void tiledEvaluation(bool p) { tiledEvaluation_m = p; }
+
+  // Return or set the tile extent along one of the two innermost
+  // dimensions.  A value of zero selects an extent based on the cache size.
+
+  int tileExtent(int dim) const
+    {
+      PAssert(dim >= 0 && dim < 2);
+      return tileExtent_m[dim];
+    }
+
+  void tileExtent(int dim, int t)
+    {
+      PAssert(dim >= 0 && dim < 2);
+      PAssert(t >= 0);
+      tileExtent_m[dim] = t;
+    }
+
+  // Return or set whether multi-patch expressions should evaluate their
+  // patches concurrently instead of the loops inside each patch.
+
+  bool parallelPatches() const { return parallelPatches_m; }
+
+  void parallelPatches(bool p) { parallelPatches_m = p; }
+
+  // Return or set whether the intersections of multi-patch expressions
+  // should be cached.
+
+  bool intersectionCache() const { return intersectionCache_m; }
+
+  void intersectionCache(bool p) { intersectionCache_m = p; }
+
+  // Return or set whether multi-patch expressions should compute the
+  // interiors of their patches before filling the guard layers they
+  // read, and the shells around the interiors afterwards.  As with the
+  // patches themselves, the result is undefined if the right hand side
+  // reads the left hand side through guard layers.
+
+  bool overlapGuards() const { return overlapGuards_m; }
+
+  void overlapGuards(bool p) { overlapGuards_m = p; }
+
+  // Return or set whether reductions should combine partial results in an
+  // order that does not depend on the number of threads.
+
+  bool deterministicReductions() const { return deterministicReductions_m; }
+
+  void deterministicReductions(bool p) { deterministicReductions_m = p; }
+
+  // Return or set the amount of work (elements times estimated cost per
+  // element) below which the evaluators do not open an OpenMP parallel
+  // region.  A value of zero measures it when POOMA is initialized.
+
+  long ompThreshold() const { return ompThreshold_m; }
+
+  void ompThreshold(long t)
+    {
+      PAssert(t >= 0);
+      ompThreshold_m = t;
+    }
+
+  // Return or set the name of the file the dataflow trace of the
+  // scheduler is written to.  If this is an empty string, no trace is
+  // recorded.
+
+  const std::string &traceFile() const { return traceFile_m; }
+
+  void traceFile(const std::string &s) { traceFile_m = s; }
+
+  // Return or set the size in bytes from which data blocks are put on
+  // huge pages.  Zero means never.
+
+  long hugePageThreshold() const { return hugePageThreshold_m; }
+
+  void hugePageThreshold(long bytes)
+    {
+      PAssert(bytes >= 0);
+      hugePageThreshold_m = bytes;
+    }
+
+  // Return or set the most bytes of freed data blocks that are kept for
+  // reuse.  Zero turns the block cache off.
+
+  long blockCacheSize() const { return blockCacheSize_m; }
+
+  void blockCacheSize(long bytes)
+    {
+      PAssert(bytes >= 0);
+      blockCacheSize_m = bytes;
+    }
+
+  // Return or set whether the elements of new Bricks are initialized
+  // by the threads that will later compute on them, so their pages are
+  // placed on those threads' memory nodes.
+
+  bool firstTouch() const { return firstTouch_m; }
+
+  void firstTouch(bool p) { firstTouch_m = p; }
+
+  // Return or set the directory scratch files for memory-mapped engines
+  // are made in.  If this is an empty string, $TMPDIR or /tmp is used.
+
+  const std::string &mappedDirectory() const { return mappedDirectory_m; }
+
+  void mappedDirectory(const std::string &s) { mappedDirectory_m = s; }
+
 
   //============================================================
   // Option operations.
@@ -266,6 +377,52 @@ private:
   // Should a block 'n evaluate be done after each expresson?
   
   bool blockingExpressions_m;
+
+  // Should the inline evaluators tile 3D-7D loop nests, and with which
+  // extents along the two innermost dimensions (zero means automatic)?
+
+  bool tiledEvaluation_m;
+  int tileExtent_m[2];
+
+  // Should multi-patch expressions run their patches concurrently?
+
+  bool parallelPatches_m;
+
+  // Should the intersections of multi-patch expressions be cached?
+
+  bool intersectionCache_m;
+
+  // Should the interiors of patches be computed while guards are filled?
+
+  bool overlapGuards_m;
+
+  // Should reductions be reproducible for any number of threads?
+
+  bool deterministicReductions_m;
+
+  // The work below which loops run serially, or zero to measure it.
+
+  long ompThreshold_m;
+
+  // The file for the dataflow trace, or an empty string.
+
+  std::string traceFile_m;
+
+  // The smallest data block that goes on huge pages, or zero.
+
+  long hugePageThreshold_m;
+
+  // The high-water mark of the block cache, or zero.
+
+  long blockCacheSize_m;
+
+  // Should Bricks be initialized in parallel, for NUMA placement?
+
+  bool firstTouch_m;
+
+  // The directory for mapped scratch files, or an empty string.
+
+  std::string mappedDirectory_m;
 };
 
 /// @name Utility functions.
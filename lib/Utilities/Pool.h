@@ -29,6 +29,8 @@
  * out small blocks very quickly.
  *
  * Intended to be used in new and delete operators of small classes.
+ * Each thread allocates from a magazine of its own, so pools can be
+ * shared by the threads of the scheduler.
  */
 
 #ifndef POOMA_UTILITIES_POOL_H
@@ -42,11 +44,25 @@
 // Include Files
 //-----------------------------------------------------------------------------
 
+#include "Threads/PoomaMutex.h"
 #include "Utilities/PAssert.h"
 #include <stddef.h>
 #include <string.h>
 #include <vector>
 
+// Pools are shared by threads when the scheduler runs several, and in
+// OpenMP builds, where the evaluators run loops over patches in parallel.
+
+#if POOMA_THREADS || POOMA_SMARTS_SCHEDULER_WORKSTEALING || defined(_OPENMP)
+#define POOMA_POOL_THREADS 1
+#else
+#define POOMA_POOL_THREADS 0
+#endif
+
+#if POOMA_POOL_THREADS
+#include <pthread.h>
+#endif
+
 
 /**
  * A Pool maintains a set of page-sized chunks of memory, and hands out 
@@ -103,22 +119,29 @@ public:
   // Allocate a block from the pool.
   inline void* alloc()
     {
+      // Threads beyond the last magazine share the depot.
+      int t = threadIndex();
+      if (t >= maxThreads)
+	return lockedAlloc();
+
       // Record an allocation.
-      outstandingAllocs_m += 1;
+      Magazine &m = magazines_m[t];
+      m.outstandingAllocs_m += 1;
 
-      // If the free list is empty, get more memory.
-      if ( head_m==0 )
-	grow();
+      // If the magazine is empty, get a batch from the depot.
+      if ( m.head_m==0 )
+	refill(m);
 
       // Get the first block.  We'll return this.
-      Link *p = head_m;
+      Link *p = m.head_m;
 
       // Make the next one the new head of the list.
       // We can't do head_m = p->next_m since p will soon be treated
       // as something other than a Link.  By doing this assignment
       // with memcpy, we ensure that p->next_m will be read before
       // it is clobbered. 
-      memcpy(&head_m, &p->next_m, sizeof(head_m));
+      memcpy(&m.head_m, &p->next_m, sizeof(m.head_m));
+      m.count_m -= 1;
       
       // Return the requested block.
       return p;
@@ -127,32 +150,82 @@ public:
   // Release a block to the pool.
   inline void free(void *b)
     {
+      int t = threadIndex();
+      if (t >= maxThreads)
+	{
+	  lockedFree(b);
+	  return;
+	}
+
       // Record a free.
-      outstandingAllocs_m -= 1;
+      Magazine &m = magazines_m[t];
+      m.outstandingAllocs_m -= 1;
+
+      // If the magazine is full, hand it back to the depot.
+      if ( m.count_m==magazineSize )
+	drain(m);
 
       // Cast the pointer to the right type.
       Link *p = (Link*)b;
 
       // Make it point to the current head of the free list.
-      p->next_m = head_m;
-
-      // Make the next one the new head of the list.
-      // We can't do head_m = p->next_m since p will soon be treated
-      // as something other than a Link.  By doing this assignment
-      // with memcpy, we ensure that p->next_m will be read before
-      // it is clobbered. 
-      memcpy(&p->next_m, &head_m, sizeof(head_m));
+      p->next_m = m.head_m;
 
       // Make it the head of the free list.
-      head_m = p;
+      m.head_m = p;
+      m.count_m += 1;
     }
 
+  // The number of blocks in the user's hands.  Blocks may be freed by
+  // another thread than the one that allocated them, so this is only
+  // exact when no other thread is using the pool.
+  int outstandingAllocs() const;
+
+  // The number of threads with a magazine of their own.  Other threads
+  // take the lock of the depot for every block.
+  enum { maxThreads = 64 };
+
+  // The number of blocks in a magazine.
+  enum { magazineSize = 32 };
+
+#if POOMA_POOL_THREADS
+  // Called when thread number t exits.  The blocks in its magazines go
+  // back to the depots, and its number can be given to a new thread.
+  static void releaseThread(int t);
+#endif
+
 private:
 
+  // Pools own their chunks and magazines, so they cannot be copied.
+  Pool(const Pool &);
+  Pool &operator=(const Pool &);
+
   // The Pool builds a linked list through each allocated block.
   // The links are of type Link.
   struct Link { Link *next_m; };
 
+  // Each thread keeps the blocks it freed last in a magazine, a
+  // private free list of at most magazineSize blocks, and allocates
+  // from it without locking.  An empty magazine is refilled with a whole
+  // batch from the depot, and a full one is given back to the depot as
+  // a batch, so the lock is taken once per magazineSize blocks.  The
+  // magazines are padded to a cache line so threads do not share lines.
+  struct Magazine
+  {
+    Magazine() : head_m(0), count_m(0), outstandingAllocs_m(0) { }
+
+    // The first block.
+    Link *head_m;
+
+    // The number of blocks in the list.
+    int count_m;
+
+    // The number of blocks this thread allocated minus the number it freed.
+    int outstandingAllocs_m;
+
+    char pad_m[64 - sizeof(Link*) - 2*sizeof(int)];
+  };
+
   // Some enums for calculating sizes of things.
 
   // page: The size of the large chunks to allocate.
@@ -184,13 +257,82 @@ private:
       return s;
     }
 
+  // The magazine of the calling thread.  Threads are numbered in the
+  // order they first use a pool; without threads there is only one.
+#if POOMA_POOL_THREADS
+#if defined(__GNUC__)
+  static inline int threadIndex()
+    {
+      return threadIndex_s > 0 ? threadIndex_s - 1 : newThreadIndex();
+    }
+
+  // 1 + the number of the calling thread, or 0 if it has none yet.
+  static __thread int threadIndex_s;
+#else
+  static inline int threadIndex() { return newThreadIndex(); }
+#endif
+
+  // Look up the number of the calling thread, giving it a number that
+  // is not in use if it has none yet.
+  static int newThreadIndex();
+
+  // Keep track of the pools, so the magazines of a thread that exits
+  // can be given back to them.
+  static void addPool(Pool *pool);
+  static void removePool(Pool *pool);
+#else
+  static inline int threadIndex() { return 0; }
+  static inline void addPool(Pool *) { }
+  static inline void removePool(Pool *) { }
+#endif
+
+  // Fill an empty magazine from the depot.
+  void refill(Magazine &m);
+
+  // Give a full magazine back to the depot.
+  void drain(Magazine &m);
+
+  // Give all the blocks of the magazine of a thread that exits back to
+  // the depot.
+  void release(Magazine &m);
+
+  // Allocate and free through the depot, for threads without a magazine.
+  void *lockedAlloc();
+  void lockedFree(void *b);
+
   // Allocate another chunk and put its blocks in the free list.
   void grow();
 
-  // The first one.
+  // The depot: full magazines given back by the threads, each a list of
+  // magazineSize blocks, and the blocks that are in no magazine yet.
+  std::vector<Link*> full_m;
   Link *head_m;
 
-  // The number of blocks in the user's hands.
+  // Protects the depot and the chunks.  Pooma::Mutex_t is a dummy
+  // unless the scheduler runs threads, so OpenMP builds lock the depot
+  // with a POSIX mutex of their own.
+#if POOMA_POOL_THREADS && !(POOMA_THREADS || POOMA_SMARTS_SCHEDULER_WORKSTEALING)
+  class DepotMutex
+  {
+  public:
+    DepotMutex() { pthread_mutex_init(&mutex_m, 0); }
+    ~DepotMutex() { pthread_mutex_destroy(&mutex_m); }
+    void lock() { pthread_mutex_lock(&mutex_m); }
+    void unlock() { pthread_mutex_unlock(&mutex_m); }
+  private:
+    pthread_mutex_t mutex_m;
+  };
+
+  DepotMutex mutex_m;
+#else
+  Pooma::Mutex_t mutex_m;
+#endif
+
+  // The magazines of the threads.
+  Magazine *magazines_m;
+
+  // The number of blocks in the user's hands from threads without
+  // a magazine.
   int outstandingAllocs_m;
   
   // How big is each block.
@@ -45,6 +45,10 @@
 #include "Utilities/PAssert.h"
 #include "Threads/PoomaMutex.h"
 
+#if POOMA_ATOMIC_REFCOUNTS
+#include <atomic>
+#endif
+
 ///////////////////////////////////////////////////////////////////////////////
 // namespace Pooma {
 
@@ -53,8 +57,19 @@
  * of an object. It encapsulates the count and provides an interface
  * for manipulating and checking the count.
  *
- * When running in a threaded environment, RefCounted protects the
- * reference count with a mutex, so this class is thread safe.
+ * When running in a threaded environment the count is a std::atomic,
+ * so this class is thread safe without locking.  References are added
+ * with relaxed increments, as a new reference is always made from an
+ * existing one, and removed with acquire-release decrements, so the
+ * thread that removes the last reference sees every write the others
+ * made before they let go.  Which counter is used is decided when POOMA
+ * is compiled by POOMA_ATOMIC_REFCOUNTS, which is on for threaded
+ * builds and for builds with OpenMP, whose parallel loops over patches
+ * copy engines on several threads; in serial builds the count is a
+ * plain int.
+ *
+ * The mutex is not used for the count.  It is only locked by clients
+ * that call lock() and unlock() to protect state of their own.
  */
 
 class RefCounted 
@@ -135,7 +150,11 @@ private:
 
   RefCounted & operator=(const RefCounted &); // UNIMPLEMENTED
 
+#if POOMA_ATOMIC_REFCOUNTS
+  std::atomic<int> count_m;
+#else
   int count_m;
+#endif
 
   // Mutex is declared mutable since we must be able to lock and
   // unlock the mutex in accessors that don't change the logical state
@@ -150,50 +169,80 @@ private:
 // Inline functions
 //-----------------------------------------------------------------------------
 
+#if POOMA_ATOMIC_REFCOUNTS
+
 inline bool 
 RefCounted::isShared() const 
 { 
-  mutex_m.lock();
-  bool test = count_m > 1;
-  mutex_m.unlock();
-  return test; 
+  return count_m.load(std::memory_order_acquire) > 1;
 }
 
+inline void 
+RefCounted::addReference()
+{
+  count_m.fetch_add(1, std::memory_order_relaxed);
+}
+
+inline void 
+RefCounted::removeReference()
+{
+  int old = count_m.fetch_sub(1, std::memory_order_acq_rel);
+  PAssert(old > 0);
+  (void)old;
+}
+
+inline bool
+RefCounted::removeRefAndCheckGarbage() 
+{ 
+  int old = count_m.fetch_sub(1, std::memory_order_acq_rel);
+  PAssert(old > 0); 
+  return old == 1;
+}
+
+inline int
+RefCounted::count() const
+{
+  return count_m.load(std::memory_order_acquire);
+}
+
+inline int
+RefCounted::countUnlocked() const
+{
+  return count_m.load(std::memory_order_relaxed);
+}
+
+#else
+
+inline bool 
+RefCounted::isShared() const 
+{ 
+  return count_m > 1;
+}
 
 inline void 
 RefCounted::addReference()
 {
-  mutex_m.lock();
   ++count_m;
-  mutex_m.unlock();
 }
 
 inline void 
 RefCounted::removeReference()
 {
-  mutex_m.lock();
   --count_m;
   PAssert(count_m >= 0);
-  mutex_m.unlock();
 }
 
 inline bool
 RefCounted::removeRefAndCheckGarbage() 
 { 
-  mutex_m.lock();
   PAssert(count_m > 0); 
-  bool test = --count_m == 0;
-  mutex_m.unlock();
-  return test;
+  return --count_m == 0;
 }
 
 inline int
 RefCounted::count() const
 {
-  mutex_m.lock();
-  int count = count_m;
-  mutex_m.unlock();
-  return count;
+  return count_m;
 }
 
 inline int
@@ -202,6 +251,8 @@ RefCounted::countUnlocked() const
   return count_m;
 }
 
+#endif
+
 
 /**
  *  Simple template class encapsulating a single data item and
@@ -24,6 +24,7 @@
 // Classes: 
 //   RefCountedBlockPtr<T,BoundsChecked,Controller>
 //   RefBlockController<T>
+//   FirstTouchTag
 //-----------------------------------------------------------------------------
 
 /** @file
@@ -43,9 +44,12 @@
 //-----------------------------------------------------------------------------
 
 #include <stddef.h>
+#include <string.h>
 #include <new>
 #include <iterator>
+#include <utility>
 
+#include "Utilities/BlockAllocator.h"
 #include "Utilities/ElementProperties.h"
 #include "Utilities/RefCounted.h"
 #include "Utilities/RefCountedPtr.h"
@@ -56,6 +60,28 @@
 ///////////////////////////////////////////////////////////////////////////////
 // namespace Pooma {
 
+/**
+ * FirstTouchTag selects parallel initialization of a new block: the
+ * elements are initialized by an OpenMP loop with a static schedule over
+ * chunks of chunk() elements.  If the chunk is the number of elements
+ * one iteration of the outermost loop of the InlineEvaluator covers,
+ * every page is first touched, and so placed, by the thread that will
+ * evaluate expressions on it.  Blocks smaller than
+ * Pooma::firstTouchMinimum bytes, and any block if the chunk is zero,
+ * are initialized serially as by the other constructors.
+ */
+
+struct FirstTouchTag
+{
+  explicit FirstTouchTag(size_t chunk = 1) : chunk_m(chunk) { }
+
+  size_t chunk() const { return chunk_m; }
+
+private:
+  size_t chunk_m;
+};
+
+
 /**
  * This class manages the actual data allocation, reference
  * counting, and optional bounds checking for the RefCountedBlockPtr
@@ -78,6 +104,9 @@
  *
  * RefBlockController is a model for the Controller concept 
  * used by RefCountedBlockPtr defined below. 
+ *
+ * The blocks it allocates come from Pooma::allocateBlock() and start on
+ * an alignment boundary, which is available as the alignment trait.
  */
 
 template <class T>
@@ -85,6 +114,11 @@ class RefBlockController : public RefCounted
 {
 public: 
 
+  // The alignment, in bytes, of the blocks this class allocates.  Blocks
+  // made from external data need not be aligned.
+
+  enum { alignment = POOMA_BLOCK_ALIGNMENT };
+
   //============================================================
   // NotInitTag struct
   //============================================================
@@ -164,6 +198,37 @@ public:
     // Skip initialization in this case
   }
 
+  // These constructors initialize the elements, by default construction
+  // or as copies of a model, in parallel chunks (see FirstTouchTag).
+  // Elements with a trivial default constructor are set to zero, so
+  // their pages are touched too.
+
+  RefBlockController(size_t size, const FirstTouchTag &tag)
+    : pBegin_m(0), pEnd_m(0), pEndOfStorage_m(0), dealloc_m(false)
+  {
+    reallocateStorage(size, false);
+
+    if (firstTouches(tag))
+      firstTouch(tag.chunk(), 0);
+    else if (!ElementProperties<T>::hasTrivialDefaultConstructor)
+      {
+	for (T * pt = begin(); pt != end(); ++pt)
+	  ElementProperties<T>::construct(pt);
+      }
+  }
+
+  RefBlockController(size_t size, const T & model, const FirstTouchTag &tag)
+    : pBegin_m(0), pEnd_m(0), pEndOfStorage_m(0), dealloc_m(false)
+  {
+    reallocateStorage(size, false);
+
+    if (firstTouches(tag))
+      firstTouch(tag.chunk(), &model);
+    else
+      for (T * pt = begin(); pt != end(); ++pt)
+	ElementProperties<T>::construct(pt, model);
+  }
+
   // This constructor sets up a controller for storage
   // owned by somebody else. We never garbage collect 
   // such storage.
@@ -392,6 +457,39 @@ private:
   // Private utility methods
   //============================================================
 
+  // Is the block big enough to be initialized in parallel?
+
+  bool firstTouches(const FirstTouchTag &tag) const
+  {
+    return tag.chunk() > 0 && size() * sizeof(T) >= Pooma::firstTouchMinimum;
+  }
+
+  // Initialize the elements in chunks of the given size, with the
+  // static schedule of the InlineEvaluator.  If there is no model, the
+  // elements are default constructed.
+
+  void firstTouch(size_t chunk, const T *model)
+  {
+    T *p = begin();
+    size_t n = size();
+    long chunks = static_cast<long>((n + chunk - 1) / chunk);
+
+#pragma omp parallel for schedule(static)
+    for (long c = 0; c < chunks; ++c)
+      {
+	size_t first = c * chunk;
+	size_t last = (first + chunk < n) ? first + chunk : n;
+	if (model != 0)
+	  for (size_t i = first; i < last; ++i)
+	    ElementProperties<T>::construct(p + i, *model);
+	else if (ElementProperties<T>::hasTrivialDefaultConstructor)
+	  memset(static_cast<void *>(p + first), 0, (last - first) * sizeof(T));
+	else
+	  for (size_t i = first; i < last; ++i)
+	    ElementProperties<T>::construct(p + i);
+      }
+  }
+
   // A method to delete the existing storage.
 
   void deleteStorage()
@@ -402,8 +500,8 @@ private:
 	  for (T *pt = begin(); pt != end(); ++pt)
 	    ElementProperties<T>::destruct(pt);
 
-	char *tmp = reinterpret_cast<char *>(pBegin_m);
-	delete [] tmp; 
+	Pooma::deallocateBlock(pBegin_m,
+			       (pEndOfStorage_m - pBegin_m) * sizeof(T));
       }
   }
 
@@ -425,11 +523,11 @@ private:
 
     if (newsize > 0)
       {
-	int nsize = newsize * sizeof(T);
+	size_t nsize = newsize * sizeof(T);
 #ifdef POOMA_MEMORY_PAGE_SIZE
 	nsize = ((nsize/POOMA_MEMORY_PAGE_SIZE)+1)*POOMA_MEMORY_PAGE_SIZE;
 #endif
-	char *tmp = new char[nsize];
+	char *tmp = static_cast<char *>(Pooma::allocateBlock(nsize));
 	pBeginNew        = reinterpret_cast<T *>(tmp);
 	pEndNew          = pBeginNew + newsize;
 	pEndOfStorageNew = pBeginNew + (nsize / sizeof(T));
@@ -593,6 +691,20 @@ public:
 #endif    
   }
 
+  // Initialize a block of a given size in parallel chunks, optionally
+  // with a model (see FirstTouchTag).
+
+  inline RefCountedBlockPtr(size_t size, const FirstTouchTag &tag)
+    : offset_m(0),
+      blockControllerPtr_m(new Controller(size,tag))
+  { }
+
+  inline RefCountedBlockPtr(size_t size, const T & model,
+			    const FirstTouchTag &tag)
+    : offset_m(0),
+      blockControllerPtr_m(new Controller(size,model,tag))
+  { }
+
   // Initialize with a user allocated pointer.
   // This turns off the deallocation and initialization, 
   // but not the bounds checking.
@@ -617,6 +729,16 @@ public:
       blockControllerPtr_m(model.blockControllerPtr_m)
   { }
 
+  // Move constructor: takes the block over from the model, which is
+  // left invalid.
+
+  inline RefCountedBlockPtr(This_t && model) noexcept
+    : offset_m(model.offset_m),
+      blockControllerPtr_m(std::move(model.blockControllerPtr_m))
+  { 
+    model.offset_m = 0;
+  }
+
   // Copy constructor with offset
   // This was added so that BrickView Engines could
   // initialize their RefCountedBlockPtr without using
@@ -650,6 +772,13 @@ public:
     return *this;
   }
 
+  inline This_t & operator=(This_t && rhs) noexcept
+  {
+    blockControllerPtr_m = std::move(rhs.blockControllerPtr_m);
+    offset_m = rhs.offset_m;
+    return *this;
+  }
+
   //============================================================
   // Accessors
   //============================================================
@@ -38,6 +38,8 @@
 #include "Utilities/ElementProperties.h"
 #include "Pooma/Configuration.h"
 
+#include <utility>
+
 
 ///////////////////////////////////////////////////////////////////////////////
 // namespace Pooma {
@@ -84,6 +86,13 @@ public:
     : ptr_m(model.ptr_m)
     { if (isValid()) ptr_m->addReference(); }
 
+  // Move constructors take the reference over from the model, which
+  // is left pointing to nothing, so the count is not touched.
+
+  RefCountedPtr(This_t &&model) noexcept
+    : ptr_m(model.ptr_m)
+    { model.ptr_m = 0; }
+
 
   //============================================================
   // Destructor
@@ -100,6 +109,21 @@ public:
   RefCountedPtr & operator=(const RefCountedPtr &);
   RefCountedPtr & operator=(T *);
 
+  // Move assignment lets go of the current reference and takes the
+  // one of rhs over, leaving rhs pointing to nothing.
+
+  RefCountedPtr & operator=(RefCountedPtr &&rhs) noexcept
+    {
+      if (this != &rhs)
+	{
+	  if ( isValid() && ptr_m->removeRefAndCheckGarbage() )
+	    delete ptr_m;
+	  ptr_m = rhs.ptr_m;
+	  rhs.ptr_m = 0;
+	}
+      return *this;
+    }
+
   //============================================================
   // Accessors and Mutators
   //============================================================
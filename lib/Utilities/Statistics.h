@@ -36,6 +36,7 @@
 #include <string>
 #include <vector>
 #include <utility>
+#include <atomic>
 
 class Inform;
 
@@ -48,22 +49,30 @@ class StatisticsData
   
 public:
 
-  const std::string &description() const { return data_m.first; }
-  long value() const { return data_m.second; }
+  const std::string &description() const { return description_m; }
+  long value() const { return value_m.load(std::memory_order_relaxed); }
   
-  void increment(long val = 1) { data_m.second += val; }
+  // Statistics are also counted inside OpenMP parallel loops, such as
+  // the one over the patches of a ParallelPatchKernel, which the mutex
+  // around this call does not cover, so the addition is atomic.
+
+  void increment(long val = 1)
+  {
+    value_m.fetch_add(val, std::memory_order_relaxed);
+  }
   
 private:
 
   // Make sure riff-raff can't instantiate these puppies.
 
   StatisticsData(const char *description, long initialValue = 0)
-  : data_m(description, initialValue)
+  : description_m(description), value_m(initialValue)
   { }
   
   ~StatisticsData() { }
 
-  std::pair<std::string, long> data_m;
+  std::string description_m;
+  std::atomic<long> value_m;
 };
 
 /**